@@ -0,0 +1,450 @@
+// Copyright (C) 2021 Garth N. Wells
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+// Assembly benchmarks
+// ===================
+//
+// This program times the assembly of matrices, vectors and scalars for
+// Lagrange elements of degree 1-4 on tetrahedral and hexahedral meshes,
+// interior facet (DG) matrix assembly, sparsity pattern construction
+// and PETSc matrix creation. Each operation is run once to warm up and
+// then repeated, with the time of each repetition recorded by a
+// common::Timer. Vector and scalar timings include packing of the form
+// coefficients and constants. The results are written as JSON.
+//
+// The program is controlled by PETSc options:
+//
+//   -bench_n <int>           Cells in each direction for degree 1
+//                            (default 16). Degree p uses n/p cells in
+//                            each direction so that the number of dofs
+//                            is similar across degrees.
+//   -bench_max_degree <int>  Highest degree to run (default 4)
+//   -bench_cell <str>        'tet', 'hex' or 'all' (default 'all')
+//   -bench_repeats <int>     Number of timed repetitions (default 5)
+//   -bench_threads <int>     Threads for matrix and vector assembly
+//                            (default 1)
+//   -bench_json <str>        Output file (default: print to stdout)
+//
+// For each benchmark the JSON output contains the wall time per
+// repetition (the maximum over MPI ranks), the global number of dofs,
+// dofs/s and bytes/dof. Bytes/dof is the size of the data produced or
+// consumed by the operation (matrix or sparsity pattern storage, the
+// vector plus packed coefficients, or the packed coefficients for a
+// scalar) divided by the number of dofs.
+
+#include "bench.h"
+#include <algorithm>
+#include <dolfinx.h>
+#include <dolfinx/common/Timer.h>
+#include <dolfinx/common/defines.h>
+#include <dolfinx/common/timing.h>
+#include <dolfinx/fem/assembler.h>
+#include <dolfinx/fem/petsc.h>
+#include <dolfinx/la/Vector.h>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+
+using namespace dolfinx;
+
+namespace
+{
+// Generated forms for a cell type and degree
+struct Forms
+{
+  ufc_form* a;
+  ufc_form* L;
+  ufc_form* M;
+  ufc_form* a_dg;
+};
+
+// Forms indexed by (cell name, degree)
+const std::map<std::pair<std::string, int>, Forms> forms = {
+    {{"tet", 1},
+     {form_bench_a_tet_P1, form_bench_L_tet_P1, form_bench_M_tet_P1,
+      form_bench_a_dg_tet_P1}},
+    {{"tet", 2},
+     {form_bench_a_tet_P2, form_bench_L_tet_P2, form_bench_M_tet_P2,
+      form_bench_a_dg_tet_P2}},
+    {{"tet", 3},
+     {form_bench_a_tet_P3, form_bench_L_tet_P3, form_bench_M_tet_P3,
+      form_bench_a_dg_tet_P3}},
+    {{"tet", 4},
+     {form_bench_a_tet_P4, form_bench_L_tet_P4, form_bench_M_tet_P4,
+      form_bench_a_dg_tet_P4}},
+    {{"hex", 1},
+     {form_bench_a_hex_P1, form_bench_L_hex_P1, form_bench_M_hex_P1,
+      form_bench_a_dg_hex_P1}},
+    {{"hex", 2},
+     {form_bench_a_hex_P2, form_bench_L_hex_P2, form_bench_M_hex_P2,
+      form_bench_a_dg_hex_P2}},
+    {{"hex", 3},
+     {form_bench_a_hex_P3, form_bench_L_hex_P3, form_bench_M_hex_P3,
+      form_bench_a_dg_hex_P3}},
+    {{"hex", 4},
+     {form_bench_a_hex_P4, form_bench_L_hex_P4, form_bench_M_hex_P4,
+      form_bench_a_dg_hex_P4}}};
+
+// Form coefficients and constants, passed by position since the
+// generated forms share coefficient names
+using Coefficients
+    = std::vector<std::shared_ptr<const fem::Function<PetscScalar>>>;
+using Constants
+    = std::vector<std::shared_ptr<const fem::Constant<PetscScalar>>>;
+
+// Benchmark parameters
+struct Parameters
+{
+  int n = 16;
+  int max_degree = 4;
+  std::string cell = "all";
+  int repeats = 5;
+  int num_threads = 1;
+  std::string json;
+};
+
+// A benchmark result. The timing is retrieved from the timer logger
+// using the task name.
+struct Record
+{
+  std::string name;
+  std::string cell;
+  int degree;
+  std::int64_t num_cells;
+  std::int64_t num_dofs;
+  double bytes;
+  std::string task;
+};
+
+// Get benchmark parameters from the PETSc options database
+Parameters get_parameters()
+{
+  Parameters p;
+  PetscInt value;
+  PetscBool set;
+  PetscOptionsGetInt(nullptr, nullptr, "-bench_n", &value, &set);
+  if (set)
+    p.n = value;
+  PetscOptionsGetInt(nullptr, nullptr, "-bench_max_degree", &value, &set);
+  if (set)
+    p.max_degree = value;
+  PetscOptionsGetInt(nullptr, nullptr, "-bench_repeats", &value, &set);
+  if (set)
+    p.repeats = value;
+  PetscOptionsGetInt(nullptr, nullptr, "-bench_threads", &value, &set);
+  if (set)
+    p.num_threads = value;
+
+  char buffer[PETSC_MAX_PATH_LEN];
+  PetscOptionsGetString(nullptr, nullptr, "-bench_cell", buffer,
+                        sizeof(buffer), &set);
+  if (set)
+    p.cell = buffer;
+  PetscOptionsGetString(nullptr, nullptr, "-bench_json", buffer,
+                        sizeof(buffer), &set);
+  if (set)
+    p.json = buffer;
+
+  if (p.n < 1 or p.max_degree < 1 or p.max_degree > 4 or p.repeats < 1
+      or p.num_threads < 1)
+  {
+    throw std::runtime_error("Invalid benchmark parameters.");
+  }
+  if (p.cell != "tet" and p.cell != "hex" and p.cell != "all")
+    throw std::runtime_error("Unknown cell type '" + p.cell + "'.");
+
+  return p;
+}
+
+// Create the function space for the arguments of a generated form
+std::shared_ptr<fem::FunctionSpace>
+create_space(const ufc_form& form, std::shared_ptr<mesh::Mesh> mesh)
+{
+  auto element
+      = std::make_shared<fem::FiniteElement>(*form.finite_elements[0]);
+  auto dofmap = std::make_shared<fem::DofMap>(
+      fem::create_dofmap(mesh->mpi_comm(), *form.dofmaps[0],
+                         mesh->topology_mutable(), nullptr, element));
+  return std::make_shared<fem::FunctionSpace>(mesh, element, dofmap);
+}
+
+// Run a function once to warm up, and then time repeated calls. Ranks
+// are synchronised before each timed call.
+template <typename Fn>
+void run(MPI_Comm comm, const std::string& task, int repeats, Fn&& f)
+{
+  f();
+  for (int i = 0; i < repeats; ++i)
+  {
+    MPI_Barrier(comm);
+    common::Timer timer(task);
+    f();
+    timer.stop();
+  }
+}
+
+// Sum a local quantity over all ranks
+double sum(MPI_Comm comm, double local)
+{
+  double global = 0;
+  MPI_Allreduce(&local, &global, 1, MPI_DOUBLE, MPI_SUM, comm);
+  return global;
+}
+
+// Run the benchmarks for one cell type and degree
+std::vector<Record> run_benchmarks(MPI_Comm comm, const std::string& cell,
+                                   int degree, const Parameters& p)
+{
+  const Forms& f = forms.at({cell, degree});
+  const std::string label = cell + " P" + std::to_string(degree);
+  const std::size_t n = std::max(1, p.n / degree);
+
+  // Interior facet integrals require ghost cells across shared facets
+  auto mesh = std::make_shared<mesh::Mesh>(generation::BoxMesh::create(
+      comm, {{{0.0, 0.0, 0.0}, {1.0, 1.0, 1.0}}}, {n, n, n},
+      cell == "tet" ? mesh::CellType::tetrahedron : mesh::CellType::hexahedron,
+      mesh::GhostMode::shared_facet));
+  const int tdim = mesh->topology().dim();
+  const std::int64_t num_cells
+      = mesh->topology().index_map(tdim)->size_global();
+
+  std::vector<Record> records;
+
+  // Continuous Lagrange space and forms
+  {
+    auto V = create_space(*f.a, mesh);
+    std::shared_ptr<const common::IndexMap> map = V->dofmap()->index_map;
+    const int bs = V->dofmap()->index_map_bs();
+    const std::int64_t num_dofs = bs * map->size_global();
+
+    auto u = std::make_shared<fem::Function<PetscScalar>>(V);
+    xtl::span<PetscScalar> u_array = u->x()->mutable_array();
+    std::fill(u_array.begin(), u_array.end(), 1.0);
+
+    auto a = std::make_shared<fem::Form<PetscScalar>>(
+        fem::create_form<PetscScalar>(*f.a, {V, V}, Coefficients(),
+                                      Constants(), {}));
+    auto L = std::make_shared<fem::Form<PetscScalar>>(
+        fem::create_form<PetscScalar>(*f.L, {V}, Coefficients{u},
+                                      Constants(), {}));
+    auto M = std::make_shared<fem::Form<PetscScalar>>(
+        fem::create_form<PetscScalar>(*f.M, {}, Coefficients{u}, Constants(),
+                                      {}));
+
+    // Sparsity pattern
+    {
+      std::string task = "Bench: create sparsity pattern " + label;
+      run(comm, task, p.repeats,
+          [&a]()
+          {
+            la::SparsityPattern pattern = fem::create_sparsity_pattern(*a);
+            pattern.assemble();
+          });
+
+      la::SparsityPattern pattern = fem::create_sparsity_pattern(*a);
+      pattern.assemble();
+      const double bytes
+          = sizeof(std::int32_t)
+            * (pattern.num_nonzeros() + 2 * (bs * map->size_local() + 1));
+      records.push_back({"create_sparsity_pattern", cell, degree, num_cells,
+                         num_dofs, sum(comm, bytes), task});
+
+      // PETSc matrix creation from a sparsity pattern
+      task = "Bench: create PETScMatrix " + label;
+      run(comm, task, p.repeats,
+          [comm, &pattern]() { la::PETScMatrix A(comm, pattern); });
+      la::PETScMatrix A(comm, pattern);
+      MatInfo info;
+      MatGetInfo(A.mat(), MAT_GLOBAL_SUM, &info);
+      records.push_back({"create_petsc_matrix", cell, degree, num_cells,
+                         num_dofs,
+                         info.nz_allocated
+                             * (sizeof(PetscScalar) + sizeof(PetscInt)),
+                         task});
+    }
+
+    // Matrix assembly
+    {
+      la::PETScMatrix A(fem::create_matrix(*a), false);
+      const std::string task = "Bench: assemble matrix " + label;
+      run(comm, task, p.repeats,
+          [&A, &a, &p]()
+          {
+            MatZeroEntries(A.mat());
+            fem::assemble_matrix(
+                la::PETScMatrix::set_block_fn(A.mat(), ADD_VALUES), *a, {},
+                p.num_threads);
+            MatAssemblyBegin(A.mat(), MAT_FINAL_ASSEMBLY);
+            MatAssemblyEnd(A.mat(), MAT_FINAL_ASSEMBLY);
+          });
+      MatInfo info;
+      MatGetInfo(A.mat(), MAT_GLOBAL_SUM, &info);
+      records.push_back({"assemble_matrix", cell, degree, num_cells, num_dofs,
+                         info.nz_allocated
+                             * (sizeof(PetscScalar) + sizeof(PetscInt)),
+                         task});
+    }
+
+    // Vector assembly
+    {
+      la::Vector<PetscScalar> b(map, bs);
+      const std::string task = "Bench: assemble vector " + label;
+      run(comm, task, p.repeats,
+          [&b, &L, &p]()
+          {
+            xtl::span<PetscScalar> array = b.mutable_array();
+            std::fill(array.begin(), array.end(), 0.0);
+            const std::vector<PetscScalar> constants
+                = fem::pack_constants(*L);
+            const auto [coeffs, cstride] = fem::pack_coefficients(*L);
+            fem::assemble_vector<PetscScalar>(
+                array, *L, constants, {coeffs, cstride}, p.num_threads);
+            b.scatter_rev(common::IndexMap::Mode::add);
+          });
+      const double bytes
+          = sizeof(PetscScalar)
+            * (b.array().size() + fem::pack_coefficients(*L).first.size());
+      records.push_back({"assemble_vector", cell, degree, num_cells, num_dofs,
+                         sum(comm, bytes), task});
+    }
+
+    // Scalar assembly
+    {
+      const std::string task = "Bench: assemble scalar " + label;
+      run(comm, task, p.repeats,
+          [comm, &M]()
+          {
+            const std::vector<PetscScalar> constants
+                = fem::pack_constants(*M);
+            const auto [coeffs, cstride] = fem::pack_coefficients(*M);
+            const PetscScalar local = fem::assemble_scalar<PetscScalar>(
+                *M, constants, {coeffs, cstride});
+            PetscScalar value = 0;
+            MPI_Allreduce(&local, &value, 1,
+                          dolfinx::MPI::mpi_type<PetscScalar>(), MPI_SUM, comm);
+          });
+      const double bytes
+          = sizeof(PetscScalar) * fem::pack_coefficients(*M).first.size();
+      records.push_back({"assemble_scalar", cell, degree, num_cells, num_dofs,
+                         sum(comm, bytes), task});
+    }
+  }
+
+  // Discontinuous Lagrange space and interior facet matrix assembly
+  {
+    auto V = create_space(*f.a_dg, mesh);
+    const std::int64_t num_dofs = V->dofmap()->index_map_bs()
+                                  * V->dofmap()->index_map->size_global();
+    auto a = std::make_shared<fem::Form<PetscScalar>>(
+        fem::create_form<PetscScalar>(*f.a_dg, {V, V}, Coefficients(),
+                                      Constants(), {}));
+
+    la::PETScMatrix A(fem::create_matrix(*a), false);
+    const std::string task = "Bench: assemble DG matrix " + label;
+    run(comm, task, p.repeats,
+        [&A, &a, &p]()
+        {
+          MatZeroEntries(A.mat());
+          fem::assemble_matrix(
+              la::PETScMatrix::set_block_fn(A.mat(), ADD_VALUES), *a, {},
+              p.num_threads);
+          MatAssemblyBegin(A.mat(), MAT_FINAL_ASSEMBLY);
+          MatAssemblyEnd(A.mat(), MAT_FINAL_ASSEMBLY);
+        });
+    MatInfo info;
+    MatGetInfo(A.mat(), MAT_GLOBAL_SUM, &info);
+    records.push_back({"assemble_matrix_interior_facet", cell, degree,
+                       num_cells, num_dofs,
+                       info.nz_allocated
+                           * (sizeof(PetscScalar) + sizeof(PetscInt)),
+                       task});
+  }
+
+  return records;
+}
+
+// Write the benchmark results as JSON. Times are the maximum over
+// ranks of the mean wall time per repetition.
+void write_json(MPI_Comm comm, const std::vector<Record>& records,
+                const Parameters& p, std::ostream& out)
+{
+  std::vector<double> times;
+  for (const Record& r : records)
+  {
+    auto [count, wall, user, system] = dolfinx::timing(r.task);
+    times.push_back(wall / count);
+  }
+  std::vector<double> max_times(times.size());
+  MPI_Allreduce(times.data(), max_times.data(), times.size(), MPI_DOUBLE,
+                MPI_MAX, comm);
+
+  if (dolfinx::MPI::rank(comm) != 0)
+    return;
+
+  out << std::setprecision(8);
+  out << "{\n";
+  out << "  \"dolfinx_version\": \"" << dolfinx::version() << "\",\n";
+  out << "  \"git_commit\": \"" << dolfinx::git_commit_hash() << "\",\n";
+  out << "  \"scalar_type\": \""
+      << (std::is_same<PetscScalar, double>::value ? "double" : "complex")
+      << "\",\n";
+  out << "  \"num_processes\": " << dolfinx::MPI::size(comm) << ",\n";
+  out << "  \"num_threads\": " << p.num_threads << ",\n";
+  out << "  \"repeats\": " << p.repeats << ",\n";
+  out << "  \"benchmarks\": [";
+  for (std::size_t i = 0; i < records.size(); ++i)
+  {
+    const Record& r = records[i];
+    out << (i == 0 ? "\n" : ",\n");
+    out << "    {\"name\": \"" << r.name << "\", \"cell\": \"" << r.cell
+        << "\", \"degree\": " << r.degree
+        << ", \"num_cells\": " << r.num_cells
+        << ", \"num_dofs\": " << r.num_dofs
+        << ", \"time\": " << max_times[i]
+        << ", \"dofs_per_second\": " << r.num_dofs / max_times[i]
+        << ", \"bytes_per_dof\": " << r.bytes / r.num_dofs << "}";
+  }
+  out << "\n  ]\n}\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  common::subsystem::init_logging(argc, argv);
+  common::subsystem::init_petsc(argc, argv);
+
+  {
+    MPI_Comm comm = MPI_COMM_WORLD;
+    const Parameters p = get_parameters();
+
+    std::vector<Record> records;
+    for (std::string cell : {"tet", "hex"})
+    {
+      if (p.cell != "all" and p.cell != cell)
+        continue;
+      for (int degree = 1; degree <= p.max_degree; ++degree)
+      {
+        std::vector<Record> r = run_benchmarks(comm, cell, degree, p);
+        records.insert(records.end(), r.begin(), r.end());
+      }
+    }
+
+    if (p.json.empty())
+      write_json(comm, records, p, std::cout);
+    else
+    {
+      std::ofstream file;
+      if (dolfinx::MPI::rank(comm) == 0)
+        file.open(p.json);
+      write_json(comm, records, p, file);
+    }
+  }
+
+  common::subsystem::finalize_petsc();
+  return 0;
+}
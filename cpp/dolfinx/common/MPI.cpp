@@ -6,6 +6,9 @@
 
 #include "MPI.h"
 #include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
 
 //-----------------------------------------------------------------------------
 dolfinx::MPI::Comm::Comm(MPI_Comm comm, bool duplicate)
@@ -123,3 +126,76 @@ std::array<std::vector<int>, 2> dolfinx::MPI::neighbors(MPI_Comm comm)
   return {std::move(sources), std::move(destinations)};
 }
 //-----------------------------------------------------------------------------
+double dolfinx::MPI::reproducible_sum(MPI_Comm comm,
+                                      const xtl::span<const double>& values)
+{
+  // Get the global number of values and largest magnitude
+  const std::int64_t n_local = values.size();
+  std::int64_t n = 0;
+  MPI_Allreduce(&n_local, &n, 1, MPI_INT64_T, MPI_SUM, comm);
+  double max_local = 0.0;
+  for (double v : values)
+    max_local = std::max(max_local, std::abs(v));
+  double max = 0.0;
+  MPI_Allreduce(&max_local, &max, 1, MPI_DOUBLE, MPI_MAX, comm);
+
+  if (n == 0 or max == 0.0)
+    return 0.0;
+  else if (!std::isfinite(max))
+  {
+    // Result is inf or nan independent of the summation order
+    double sum_local = std::accumulate(values.begin(), values.end(), 0.0);
+    double sum = 0.0;
+    MPI_Allreduce(&sum_local, &sum, 1, MPI_DOUBLE, MPI_SUM, comm);
+    return sum;
+  }
+
+  // Number of bits, k, such that n <= 2^k
+  int k = 0;
+  while ((std::int64_t(1) << k) < n)
+    ++k;
+
+  // Bound on the magnitude of the values, |x| < 2^e
+  int e = 0;
+  std::frexp(max, &e);
+
+  // Fold the values into num_bins bins. In each bin, values are
+  // rounded to a multiple of ulp(sigma) by computing (sigma + x) -
+  // sigma, with sigma = 1.5 * 2^(e + k + 1). The rounded values and all
+  // partial sums of them are exactly representable, so their sum is
+  // independent of order. The remainders |x - q| <= ulp(sigma) / 2 are
+  // folded into the next bin.
+  constexpr int num_bins = 3;
+  std::array<double, num_bins> sums_local = {0.0, 0.0, 0.0};
+  std::vector<double> r(values.begin(), values.end());
+  for (int b = 0; b < num_bins; ++b)
+  {
+    const int E = e + k + 1;
+    const double sigma = std::ldexp(1.5, E);
+    if (!std::isfinite(sigma))
+      throw std::runtime_error("Values are too large for reproducible sum.");
+    if (E - 52 < std::numeric_limits<double>::min_exponent)
+      break;
+
+    double s = 0.0;
+    for (double& x : r)
+    {
+      const double q = (sigma + x) - sigma;
+      s += q;
+      x -= q;
+    }
+    sums_local[b] = s;
+    e = E - 52;
+  }
+
+  std::array<double, num_bins> sums;
+  MPI_Allreduce(sums_local.data(), sums.data(), num_bins, MPI_DOUBLE,
+                MPI_SUM, comm);
+
+  // Add bins in a fixed order, smallest first
+  double sum = 0.0;
+  for (int b = num_bins - 1; b >= 0; --b)
+    sum += sums[b];
+  return sum;
+}
+//-----------------------------------------------------------------------------
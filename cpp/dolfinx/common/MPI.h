@@ -18,6 +18,7 @@
 #include <type_traits>
 #include <utility>
 #include <vector>
+#include <xtl/xspan.hpp>
 
 #define MPICH_IGNORE_CXX_SEEK 1
 #include <mpi.h>
@@ -98,6 +99,24 @@ neighbor_all_to_all(MPI_Comm neighbor_comm,
 /// @return source ranks, destination ranks
 std::array<std::vector<int>, 2> neighbors(MPI_Comm comm);
 
+/// Compute the sum of values that are distributed across processes,
+/// with a result that is bitwise independent of the number of
+/// processes, the distribution of the values and the order of the
+/// values.
+///
+/// The values are pre-rounded to a common binning that is computed from
+/// the global number of values and the global largest magnitude, such
+/// that the sum of the rounded values is exact. The rounding remainders
+/// are summed in the same way in two further bins, which gives an error
+/// that is much smaller than that of recursive summation. This costs
+/// three passes over the values and three small reductions.
+///
+/// @note This function involves global communication
+/// @param[in] comm The MPI communicator
+/// @param[in] values The values on this process
+/// @return The sum of the values on all processes
+double reproducible_sum(MPI_Comm comm, const xtl::span<const double>& values);
+
 /// Return local range for given process, splitting [0, N - 1] into
 /// size() portions of almost equal size
 /// @param[in] rank MPI rank of the caller
@@ -156,6 +175,8 @@ constexpr MPI_Datatype mpi_type()
     return MPI_FLOAT;
   else if constexpr (std::is_same<T, double>::value)
     return MPI_DOUBLE;
+  else if constexpr (std::is_same<T, std::complex<float>>::value)
+    return MPI_C_FLOAT_COMPLEX;
   else if constexpr (std::is_same<T, std::complex<double>>::value)
     return MPI_DOUBLE_COMPLEX;
   else if constexpr (std::is_same<T, short int>::value)
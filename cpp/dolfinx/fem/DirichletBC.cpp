@@ -5,12 +5,14 @@
 // SPDX-License-Identifier:    LGPL-3.0-or-later
 
 #include "DirichletBC.h"
+#include "CoordinateElement.h"
 #include "DofMap.h"
 #include "FiniteElement.h"
 #include <algorithm>
 #include <array>
 #include <dolfinx/common/IndexMap.h>
 #include <dolfinx/graph/AdjacencyList.h>
+#include <dolfinx/mesh/Geometry.h>
 #include <dolfinx/mesh/Mesh.h>
 #include <dolfinx/mesh/Topology.h>
 #include <dolfinx/mesh/cell_types.h>
@@ -18,6 +20,7 @@
 #include <numeric>
 #include <utility>
 #include <xtensor/xtensor.hpp>
+#include <xtensor/xview.hpp>
 
 using namespace dolfinx;
 using namespace dolfinx::fem;
@@ -600,3 +603,160 @@ std::vector<std::int32_t> fem::locate_dofs_geometrical(
   return dofs;
 }
 //-----------------------------------------------------------------------------
+std::vector<std::int32_t> fem::locate_dofs_geometrical(
+    const fem::FunctionSpace& V, const int dim,
+    const xtl::span<const std::int32_t>& entities,
+    const std::function<xt::xtensor<bool, 1>(const xt::xtensor<double, 2>&)>&
+        marker_fn,
+    bool remote)
+{
+  if (!V.component().empty())
+  {
+    throw std::runtime_error(
+        "Cannot tabulate coordinates for a FunctionSpace that is a subspace.");
+  }
+
+  std::shared_ptr<const fem::DofMap> dofmap = V.dofmap();
+  assert(dofmap);
+  std::shared_ptr<const fem::FiniteElement> element = V.element();
+  assert(element);
+  std::shared_ptr<const mesh::Mesh> mesh = V.mesh();
+  assert(mesh);
+  if (!element->interpolation_ident())
+  {
+    throw std::runtime_error("Cannot evaluate dof coordinates - this element "
+                             "does not have pointwise evaluation.");
+  }
+
+  const int tdim = mesh->topology().dim();
+  const std::size_t gdim = mesh->geometry().dim();
+
+  // Initialise entity-cell connectivity
+  mesh->topology_mutable().create_entities(tdim);
+  mesh->topology_mutable().create_connectivity(dim, tdim);
+
+  // Prepare an element - local dof layout for dofs on entities of the
+  // entity_dim
+  const int num_cell_entities
+      = mesh::cell_num_entities(mesh->topology().cell_type(), dim);
+  std::vector<std::vector<int>> entity_dofs;
+  for (int i = 0; i < num_cell_entities; ++i)
+  {
+    entity_dofs.push_back(
+        dofmap->element_dof_layout->entity_closure_dofs(dim, i));
+  }
+
+  auto e_to_c = mesh->topology().connectivity(dim, tdim);
+  assert(e_to_c);
+  auto c_to_e = mesh->topology().connectivity(tdim, dim);
+  assert(c_to_e);
+
+  // Build list of (cell, local dof index) for the closure dofs of the
+  // entities, sorted by cell
+  std::vector<std::array<std::int32_t, 2>> cell_dofs_local;
+  for (std::int32_t e : entities)
+  {
+    // Get first attached cell
+    assert(e_to_c->num_links(e) > 0);
+    const int cell = e_to_c->links(e)[0];
+
+    // Get local index of entity with respect to the cell
+    auto entities_d = c_to_e->links(cell);
+    auto it = std::find(entities_d.begin(), entities_d.end(), e);
+    assert(it != entities_d.end());
+    const int entity_local_index = std::distance(entities_d.begin(), it);
+    for (int index : entity_dofs[entity_local_index])
+      cell_dofs_local.push_back({cell, index});
+  }
+  std::sort(cell_dofs_local.begin(), cell_dofs_local.end());
+  cell_dofs_local.erase(
+      std::unique(cell_dofs_local.begin(), cell_dofs_local.end()),
+      cell_dofs_local.end());
+
+  // Prepare reference dof coordinates and cell geometry
+  const xt::xtensor<double, 2>& X = element->interpolation_points();
+  const fem::CoordinateElement& cmap = mesh->geometry().cmap();
+  const graph::AdjacencyList<std::int32_t>& x_dofmap
+      = mesh->geometry().dofmap();
+  const xt::xtensor<double, 2>& x_g = mesh->geometry().x();
+  const std::size_t num_dofs_g = x_dofmap.num_links(0);
+  const xt::xtensor<double, 2> phi
+      = xt::view(cmap.tabulate(0, X), 0, xt::all(), xt::all(), 0);
+
+  xtl::span<const std::uint32_t> cell_info;
+  if (element->needs_dof_transformations())
+  {
+    mesh->topology_mutable().create_entity_permutations();
+    cell_info = xtl::span(mesh->topology().get_cell_permutation_info());
+  }
+  const std::function<void(const xtl::span<double>&,
+                           const xtl::span<const std::uint32_t>&, std::int32_t,
+                           int)>
+      apply_dof_transformation
+      = element->get_dof_transformation_function<double>();
+
+  // Compute the coordinates of the entity dofs only, tabulating the dof
+  // coordinates of each cell once
+  const std::size_t num_points = cell_dofs_local.size();
+  xt::xtensor<double, 2> coords
+      = xt::zeros<double>({std::size_t(3), num_points});
+  std::vector<std::int32_t> point_dofs(num_points);
+  xt::xtensor<double, 2> x = xt::zeros<double>({X.shape(0), gdim});
+  xt::xtensor<double, 2> coordinate_dofs({num_dofs_g, gdim});
+  for (std::size_t p = 0; p < num_points;)
+  {
+    const std::int32_t c = cell_dofs_local[p][0];
+
+    // Extract cell geometry
+    auto x_dofs = x_dofmap.links(c);
+    for (std::size_t i = 0; i < x_dofs.size(); ++i)
+    {
+      std::copy_n(xt::row(x_g, x_dofs[i]).begin(), gdim,
+                  std::next(coordinate_dofs.begin(), i * gdim));
+    }
+
+    // Tabulate dof coordinates on cell
+    cmap.push_forward(x, coordinate_dofs, phi);
+    apply_dof_transformation(xtl::span(x.data(), x.size()), cell_info, c,
+                             x.shape(1));
+
+    // Copy coordinates of the entity dofs of this cell
+    auto dofs = dofmap->cell_dofs(c);
+    for (; p < num_points and cell_dofs_local[p][0] == c; ++p)
+    {
+      const int i = cell_dofs_local[p][1];
+      point_dofs[p] = dofs[i];
+      for (std::size_t j = 0; j < gdim; ++j)
+        coords(j, p) = x(i, j);
+    }
+  }
+
+  // Evaluate marker for each dof coordinate
+  const xt::xtensor<bool, 1> marked_dofs = marker_fn(coords);
+  assert(marked_dofs.size() == num_points);
+  std::vector<std::int32_t> dofs;
+  for (std::size_t p = 0; p < num_points; ++p)
+  {
+    if (marked_dofs[p])
+      dofs.push_back(point_dofs[p]);
+  }
+
+  // Remove duplicates
+  std::sort(dofs.begin(), dofs.end());
+  dofs.erase(std::unique(dofs.begin(), dofs.end()), dofs.end());
+
+  if (remote)
+  {
+    const std::vector dofs_remote = get_remote_bcs1(*dofmap->index_map, dofs);
+
+    // Add received bc indices to dofs_local
+    dofs.insert(dofs.end(), dofs_remote.begin(), dofs_remote.end());
+
+    // Remove duplicates
+    std::sort(dofs.begin(), dofs.end());
+    dofs.erase(std::unique(dofs.begin(), dofs.end()), dofs.end());
+  }
+
+  return dofs;
+}
+//-----------------------------------------------------------------------------
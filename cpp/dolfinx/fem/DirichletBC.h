@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <dolfinx/fem/Function.h>
 #include <dolfinx/fem/FunctionSpace.h>
@@ -112,6 +113,31 @@ std::vector<std::int32_t> locate_dofs_geometrical(
     const std::function<xt::xtensor<bool, 1>(const xt::xtensor<double, 2>&)>&
         marker_fn);
 
+/// Finds degrees of freedom in the closure of the provided mesh
+/// entities whose geometric coordinate is true for the provided marking
+/// function. Only the coordinates of the degrees of freedom on the
+/// entities are computed, which is much cheaper than
+/// fem::locate_dofs_geometrical(const fem::FunctionSpace&, ...) when
+/// the entities are, e.g., the exterior facets of the mesh.
+///
+/// @param[in] V The function space on which degrees of freedom will be
+/// located. It must not be a subspace.
+/// @param[in] dim Topological dimension of the mesh entities
+/// @param[in] entities Indices of mesh entities. Only DOFs associated
+/// with the closure of these entities are tested with @p marker_fn.
+/// @param[in] marker_fn Function marking tabulated degrees of freedom
+/// @param[in] remote True to return also "remotely located"
+/// degree-of-freedom indices (see fem::locate_dofs_topological)
+/// @return Array of DOF index blocks (local to the MPI rank) in the
+/// space V. The array uses the block size of the dofmap associated
+/// with V.
+std::vector<std::int32_t> locate_dofs_geometrical(
+    const fem::FunctionSpace& V, const int dim,
+    const xtl::span<const std::int32_t>& entities,
+    const std::function<xt::xtensor<bool, 1>(const xt::xtensor<double, 2>&)>&
+        marker_fn,
+    bool remote = true);
+
 /// Interface for setting (strong) Dirichlet boundary conditions
 ///
 ///     \f$u = g \ \text{on} \ G\f$,
@@ -167,6 +193,7 @@ public:
 
     // TODO: allows single dofs array (let one point to the other)
     _dofs1_g = _dofs0;
+    compute_runs();
   }
 
   /// Create a representation of a Dirichlet boundary condition where
@@ -200,6 +227,7 @@ public:
     const int owned_size0 = map0_bs * map0_size;
     auto it0 = std::lower_bound(_dofs0.begin(), _dofs0.end(), owned_size0);
     _owned_indices0 = std::distance(_dofs0.begin(), it0);
+    compute_runs();
   }
 
   /// Copy constructor
@@ -257,13 +285,17 @@ public:
   {
     assert(_g);
     xtl::span<const T> g = _g->x()->array();
-    for (std::size_t i = 0; i < _dofs0.size(); ++i)
+    const std::int32_t size = x.size();
+    for (auto [d0, d1, n] : _runs)
     {
-      if (_dofs0[i] < (std::int32_t)x.size())
-      {
-        assert(_dofs1_g[i] < (std::int32_t)g.size());
-        x[_dofs0[i]] = scale * g[_dofs1_g[i]];
-      }
+      if (d0 >= size)
+        continue;
+      n = std::min(n, size - d0);
+      assert(d1 + n <= (std::int32_t)g.size());
+      const T* g_ptr = g.data() + d1;
+      T* x_ptr = x.data() + d0;
+      for (std::int32_t j = 0; j < n; ++j)
+        x_ptr[j] = scale * g_ptr[j];
     }
   }
 
@@ -277,13 +309,18 @@ public:
     assert(_g);
     xtl::span<const T> g = _g->x()->array();
     assert(x.size() <= x0.size());
-    for (std::size_t i = 0; i < _dofs0.size(); ++i)
+    const std::int32_t size = x.size();
+    for (auto [d0, d1, n] : _runs)
     {
-      if (_dofs0[i] < (std::int32_t)x.size())
-      {
-        assert(_dofs1_g[i] < (std::int32_t)g.size());
-        x[_dofs0[i]] = scale * (g[_dofs1_g[i]] - x0[_dofs0[i]]);
-      }
+      if (d0 >= size)
+        continue;
+      n = std::min(n, size - d0);
+      assert(d1 + n <= (std::int32_t)g.size());
+      const T* g_ptr = g.data() + d1;
+      const T* x0_ptr = x0.data() + d0;
+      T* x_ptr = x.data() + d0;
+      for (std::int32_t j = 0; j < n; ++j)
+        x_ptr[j] = scale * (g_ptr[j] - x0_ptr[j]);
     }
   }
 
@@ -299,8 +336,8 @@ public:
   {
     assert(_g);
     xtl::span<const T> g = _g->x()->array();
-    for (std::size_t i = 0; i < _dofs1_g.size(); ++i)
-      values[_dofs0[i]] = g[_dofs1_g[i]];
+    for (auto [d0, d1, n] : _runs)
+      std::copy_n(std::next(g.begin(), d1), n, std::next(values.begin(), d0));
   }
 
   /// Set markers[i] = true if dof i has a boundary condition applied.
@@ -311,14 +348,33 @@ public:
   /// unchanged.
   void mark_dofs(std::vector<bool>& markers) const
   {
-    for (std::size_t i = 0; i < _dofs0.size(); ++i)
+    for (auto [d0, d1, n] : _runs)
     {
-      assert(_dofs0[i] < (std::int32_t)markers.size());
-      markers[_dofs0[i]] = true;
+      assert(d0 + n <= (std::int32_t)markers.size());
+      std::fill_n(std::next(markers.begin(), d0), n, true);
     }
   }
 
 private:
+  // Split the dofs into runs of consecutive entries that are contiguous
+  // in both _dofs0 and _dofs1_g, so that boundary values can be
+  // applied by contiguous (vectorisable) loops
+  void compute_runs()
+  {
+    _runs.clear();
+    for (std::size_t i = 0; i < _dofs0.size();)
+    {
+      std::size_t j = i + 1;
+      while (j < _dofs0.size() and _dofs0[j] == _dofs0[j - 1] + 1
+             and _dofs1_g[j] == _dofs1_g[j - 1] + 1)
+      {
+        ++j;
+      }
+      _runs.push_back({_dofs0[i], _dofs1_g[i], std::int32_t(j - i)});
+      i = j;
+    }
+  }
+
   // The function space (possibly a sub function space)
   std::shared_ptr<const fem::FunctionSpace> _function_space;
 
@@ -329,6 +385,10 @@ private:
   // space of _g
   std::vector<std::int32_t> _dofs0, _dofs1_g;
 
+  // Runs of contiguous dofs, (first dof in _dofs0, first dof in
+  // _dofs1_g, number of dofs)
+  std::vector<std::array<std::int32_t, 3>> _runs;
+
   // The first _owned_indices in _dofs are owned by this process
   int _owned_indices0 = -1;
   int _owned_indices1 = -1;
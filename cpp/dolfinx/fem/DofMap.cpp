@@ -149,9 +149,12 @@ fem::transpose_dofmap(const graph::AdjacencyList<std::int32_t>& dofmap,
                       std::int32_t num_cells)
 {
   // Count number of cell contributions to each global index
-  const std::int32_t max_index = *std::max_element(
-      dofmap.array().begin(),
-      std::next(dofmap.array().begin(), dofmap.offsets()[num_cells]));
+  const std::int32_t num_cell_dofs
+      = dofmap.degree() > 0 ? num_cells * dofmap.degree()
+                            : dofmap.offsets()[num_cells];
+  const std::int32_t max_index
+      = *std::max_element(dofmap.array().begin(),
+                          std::next(dofmap.array().begin(), num_cell_dofs));
 
   std::vector<int> num_local_contributions(max_index + 1, 0);
   for (int c = 0; c < num_cells; ++c)
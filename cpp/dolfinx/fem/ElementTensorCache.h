@@ -0,0 +1,52 @@
+// Copyright (C) 2021 Garth N. Wells
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace dolfinx::fem
+{
+
+/// Storage for the element tensors of cell integrals computed in a
+/// previous assembly. Used in incremental re-assembly to remove the
+/// previous contribution of a cell before the new contribution is
+/// added. Tensors are stored per cell integral (by integral id) and
+/// cell, and only for cells that have been assembled.
+template <typename T>
+class ElementTensorCache
+{
+public:
+  /// Create an empty cache
+  ElementTensorCache() = default;
+
+  /// Get the stored element tensor for a cell. An empty array is
+  /// inserted if no tensor is stored for the cell.
+  /// @param[in] i The cell integral id
+  /// @param[in] c The cell index (local to process)
+  /// @return The element tensor
+  std::vector<T>& operator()(int i, std::int32_t c) { return _tensors[i][c]; }
+
+  /// Remove all stored tensors
+  void clear() { _tensors.clear(); }
+
+  /// Number of stored element tensors
+  std::size_t size() const
+  {
+    std::size_t n = 0;
+    for (auto& [i, tensors] : _tensors)
+      n += tensors.size();
+    return n;
+  }
+
+private:
+  // Map from cell integral id to (cell, element tensor) map
+  std::map<int, std::unordered_map<std::int32_t, std::vector<T>>> _tensors;
+};
+} // namespace dolfinx::fem
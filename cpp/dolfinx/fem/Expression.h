@@ -6,11 +6,17 @@
 
 #pragma once
 
+#include <algorithm>
+#include <dolfinx/fem/Function.h>
+#include <dolfinx/fem/QuadratureData.h>
+#include <dolfinx/fem/utils.h>
 #include <dolfinx/mesh/Mesh.h>
 #include <functional>
+#include <thread>
 #include <utility>
 #include <vector>
 #include <xtensor/xarray.hpp>
+#include <xtensor/xmath.hpp>
 #include <xtensor/xtensor.hpp>
 #include <xtl/xspan.hpp>
 
@@ -93,48 +99,137 @@ public:
     static_assert(std::is_same<T, typename U::value_type>::value,
                   "Expression and array types must be the same");
 
-    // Extract data from Expression
-    assert(_mesh);
-
-    // Prepare coefficients and constants
-    const auto [coeffs, cstride] = pack_coefficients(*this);
-    const std::vector<T> constant_data = pack_constants(*this);
-
-    const auto& fn = this->get_tabulate_expression();
-
-    // Prepare cell geometry
-    const graph::AdjacencyList<std::int32_t>& x_dofmap
-        = _mesh->geometry().dofmap();
-    const fem::CoordinateElement& cmap = _mesh->geometry().cmap();
+    const std::size_t size = this->num_points() * this->value_size();
+    this->eval_cells(
+        active_cells, 1, [](std::size_t) -> T* { return nullptr; },
+        [&values, size](std::size_t c, const T* values_c)
+        {
+          for (std::size_t j = 0; j < size; ++j)
+            values(c, j) = values_c[j];
+        });
+  }
 
-    // FIXME: Add proper interface for num coordinate dofs
-    const std::size_t num_dofs_g = x_dofmap.num_links(0);
-    const xt::xtensor<double, 2>& x_g = _mesh->geometry().x();
+  /// Evaluate the expression on cells, writing the result directly
+  /// into a strided buffer
+  /// @param[in] active_cells Cells on which to evaluate the Expression
+  /// @param[out] values The buffer to store the result in. The values
+  /// for `active_cells[c]` are written to `values[c * stride + j]`, `j
+  /// < num_points * value_size`, with `j = p * value_size + k` for
+  /// point `p` and component `k`. Entries between the values of
+  /// consecutive cells are not modified.
+  /// @param[in] stride The distance in @p values between the first
+  /// entries of consecutive cells. It must be at least `num_points *
+  /// value_size`.
+  /// @param[in] num_threads The number of threads to use. The cells
+  /// are divided into contiguous blocks that are evaluated
+  /// concurrently.
+  void eval(const xtl::span<const std::int32_t>& active_cells,
+            const xtl::span<T>& values, std::size_t stride,
+            int num_threads = 1) const
+  {
+    const std::size_t size = this->num_points() * this->value_size();
+    if (stride < size)
+      throw std::runtime_error("Stride is smaller than the number of values "
+                               "per cell.");
+    if (!active_cells.empty()
+        and values.size() < (active_cells.size() - 1) * stride + size)
+    {
+      throw std::runtime_error("Buffer for Expression values is too small.");
+    }
+    if (num_threads < 1)
+      throw std::runtime_error("Number of threads must be positive.");
 
-    // Create data structures used in evaluation
-    std::vector<double> coordinate_dofs(3 * num_dofs_g);
+    this->eval_cells(
+        active_cells, num_threads, [&values, stride](std::size_t c)
+        { return values.data() + c * stride; },
+        [](std::size_t, const T*) {});
+  }
 
-    // Iterate over cells and 'assemble' into values
-    std::vector<T> values_e(this->num_points() * this->value_size(), 0);
-    for (std::size_t c = 0; c < active_cells.size(); ++c)
+  /// Evaluate the expression on cells and insert the values directly
+  /// into the degree-of-freedom array of a Function. The element of
+  /// @p u must be a point-evaluation (e.g. discontinuous Lagrange)
+  /// element whose interpolation points are the points of the
+  /// Expression and whose block size is the Expression value size.
+  /// @param[in] active_cells Cells on which to evaluate the Expression
+  /// @param[in,out] u The Function to interpolate into. Only the
+  /// degrees-of-freedom of @p active_cells are modified, and ghost
+  /// values are not updated.
+  /// @param[in] num_threads The number of threads to use
+  void eval(const xtl::span<const std::int32_t>& active_cells, Function<T>& u,
+            int num_threads = 1) const
+  {
+    if (num_threads < 1)
+      throw std::runtime_error("Number of threads must be positive.");
+
+    std::shared_ptr<const fem::FunctionSpace> V = u.function_space();
+    assert(V);
+    std::shared_ptr<const fem::FiniteElement> element = V->element();
+    assert(element);
+    std::shared_ptr<const fem::DofMap> dofmap = V->dofmap();
+    assert(dofmap);
+    const int bs = dofmap->bs();
+    if (!element->interpolation_ident())
     {
-      const std::int32_t cell = active_cells[c];
-
-      auto x_dofs = x_dofmap.links(cell);
-      for (std::size_t i = 0; i < x_dofs.size(); ++i)
-      {
-        std::copy_n(xt::row(x_g, x_dofs[i]).cbegin(), 3,
-                    std::next(coordinate_dofs.begin(), 3 * i));
-      }
+      throw std::runtime_error("Expression can only be evaluated into a "
+                               "Function with a point-evaluation element.");
+    }
+    if ((std::size_t)bs != this->value_size()
+        or (std::size_t)dofmap->element_dof_layout->num_dofs()
+               != this->num_points())
+    {
+      throw std::runtime_error(
+          "Function space is not compatible with the Expression.");
+    }
+    const xt::xtensor<double, 2>& X = element->interpolation_points();
+    if (X.shape() != _x.shape() or !xt::allclose(X, _x))
+    {
+      throw std::runtime_error("Function space interpolation points differ "
+                               "from the Expression points.");
+    }
 
-      const T* coeff_cell = coeffs.data() + cell * cstride;
-      std::fill(values_e.begin(), values_e.end(), 0.0);
-      fn(values_e.data(), coeff_cell, constant_data.data(),
-         coordinate_dofs.data());
+    // Evaluate each cell into a per-thread work array and scatter into
+    // the dof array of u. Dofs of a point-evaluation element are
+    // ordered by point, matching the Expression layout.
+    xtl::span<T> u_array = u.x()->mutable_array();
+    const graph::AdjacencyList<std::int32_t>& dofs = dofmap->list();
+    this->eval_cells(
+        active_cells, num_threads, [](std::size_t) -> T* { return nullptr; },
+        [&active_cells, &dofs, &u_array, bs](std::size_t c, const T* values)
+        {
+          auto cell_dofs = dofs.links(active_cells[c]);
+          for (std::size_t i = 0; i < cell_dofs.size(); ++i)
+            for (int k = 0; k < bs; ++k)
+              u_array[bs * cell_dofs[i] + k] = values[bs * i + k];
+        });
+  }
 
-      for (std::size_t j = 0; j < values_e.size(); ++j)
-        values(c, j) = values_e[j];
+  /// Evaluate the expression on cells and write the values in place
+  /// into quadrature point data. The points of the Expression are taken
+  /// to be the quadrature points of @p data.
+  /// @param[in] active_cells Cells on which to evaluate the Expression
+  /// @param[in,out] data The quadrature point data. Only the values of
+  /// @p active_cells are modified, and ghost values are not updated.
+  /// @param[in] num_threads The number of threads to use
+  void eval(const xtl::span<const std::int32_t>& active_cells,
+            QuadratureData<T>& data, int num_threads = 1) const
+  {
+    if (num_threads < 1)
+      throw std::runtime_error("Number of threads must be positive.");
+    if (data.mesh() != _mesh)
+      throw std::runtime_error("Incompatible mesh");
+    if ((std::size_t)data.num_points() != this->num_points()
+        or (std::size_t)data.value_size() != this->value_size())
+    {
+      throw std::runtime_error(
+          "Quadrature data is not compatible with the Expression.");
     }
+
+    const std::size_t size = this->num_points() * this->value_size();
+    xtl::span<T> x = data.x()->mutable_array();
+    this->eval_cells(
+        active_cells, num_threads, [&x, &active_cells, size](std::size_t c)
+        { return x.data() + size * active_cells[c]; },
+        [](std::size_t, const T*) {});
   }
 
   /// Get function for tabulate_expression.
@@ -174,6 +269,69 @@ public:
   using scalar_type = T;
 
 private:
+  // Evaluate the expression on active_cells, with the cells divided
+  // into contiguous blocks that are evaluated concurrently. The values
+  // for active_cells[c] are written to target(c), or to a per-thread
+  // work array if target(c) returns nullptr, after which insert(c,
+  // values) is called.
+  template <typename Target, typename Insert>
+  void eval_cells(const xtl::span<const std::int32_t>& active_cells,
+                  int num_threads, Target&& target, Insert&& insert) const
+  {
+    assert(_mesh);
+
+    // Prepare coefficients and constants
+    const auto [coeffs, cstride] = pack_coefficients(*this);
+    const std::vector<T> constant_data = pack_constants(*this);
+
+    const auto& fn = this->get_tabulate_expression();
+
+    // Prepare cell geometry. The geometry cache is built before any
+    // threads are launched.
+    const graph::AdjacencyList<std::int32_t>& x_dofmap
+        = _mesh->geometry().dofmap();
+
+    // FIXME: Add proper interface for num coordinate dofs
+    const std::size_t num_dofs_g = x_dofmap.num_links(0);
+    const xt::xtensor<double, 2>& x_g = _mesh->geometry().x();
+    const xtl::span<const double> x_cache
+        = _mesh->geometry().cell_coordinates();
+
+    const std::size_t size = this->num_points() * this->value_size();
+    auto eval_block = [&](std::size_t c0, std::size_t c1)
+    {
+      std::vector<double> coordinate_dofs(3 * num_dofs_g);
+      std::vector<T> values_e(size);
+      for (std::size_t c = c0; c < c1; ++c)
+      {
+        const std::int32_t cell = active_cells[c];
+        const double* coordinate_dofs_c = impl::get_cell_coordinates(
+            x_cache, x_dofmap, x_g, cell, xtl::span<double>(coordinate_dofs));
+
+        T* values_c = target(c);
+        if (!values_c)
+          values_c = values_e.data();
+        const T* coeff_cell = coeffs.data() + cell * cstride;
+        std::fill_n(values_c, size, 0.0);
+        fn(values_c, coeff_cell, constant_data.data(), coordinate_dofs_c);
+        insert(c, values_c);
+      }
+    };
+
+    const std::size_t num_cells = active_cells.size();
+    const std::size_t num_blocks
+        = std::min<std::size_t>(num_threads, num_cells);
+    std::vector<std::thread> threads;
+    for (std::size_t t = 1; t < num_blocks; ++t)
+    {
+      threads.emplace_back(eval_block, t * num_cells / num_blocks,
+                           (t + 1) * num_cells / num_blocks);
+    }
+    eval_block(0, num_blocks > 0 ? num_cells / num_blocks : 0);
+    for (auto& t : threads)
+      t.join();
+  }
+
   // Coefficients associated with the Expression
   std::vector<std::shared_ptr<const fem::Function<T>>> _coefficients;
 
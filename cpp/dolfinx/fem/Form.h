@@ -8,13 +8,18 @@
 
 #include <algorithm>
 #include <array>
+#include <dolfinx/fem/DofMap.h>
 #include <dolfinx/fem/FunctionSpace.h>
+#include <dolfinx/fem/QuadratureData.h>
+#include <dolfinx/graph/AdjacencyList.h>
+#include <dolfinx/graph/colouring.h>
 #include <dolfinx/mesh/Mesh.h>
 #include <dolfinx/mesh/MeshTags.h>
 #include <functional>
 #include <memory>
 #include <string>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 namespace dolfinx::fem
@@ -34,6 +39,31 @@ enum class IntegralType : std::int8_t
   vertex = 3
 };
 
+/// Precomputed data for the facets of an interior facet integral. For
+/// each facet, the data for the two attached cells is stored
+/// contiguously so that it does not need to be looked up and
+/// concatenated during assembly.
+struct InteriorFacetTable
+{
+  /// The two cells attached to each facet
+  std::vector<std::array<std::int32_t, 2>> cells;
+
+  /// The local index of the facet in each of the two cells
+  std::vector<std::array<int, 2>> local_facets;
+
+  /// The facet permutation relative to each of the two cells (zero if
+  /// the form does not need facet permutations)
+  std::vector<std::array<std::uint8_t, 2>> perms;
+
+  /// For each argument of the form, the dofs of the first cell followed
+  /// by the dofs of the second cell for each facet
+  std::vector<graph::AdjacencyList<std::int32_t>> dofs;
+
+  /// For each argument of the form, the number of dofs of the first
+  /// cell, i.e. the position of the dofs of the second cell in `dofs`
+  std::vector<int> num_cell_dofs;
+};
+
 /// Class for variational forms
 ///
 /// A note on the order of trial and test spaces: FEniCS numbers
@@ -57,6 +87,12 @@ enum class IntegralType : std::int8_t
 /// (the variable `function_spaces` in the constructors below), the list
 /// of spaces should start with space number 0 (the test space) and then
 /// space number 1 (the trial space).
+///
+/// The scalar type `T` is the type of the element tensors, coefficients
+/// and constants. The cell geometry passed to the kernels is always
+/// double precision, so a form with `T = float` evaluates the geometry
+/// in double precision and computes and accumulates the tensors in
+/// single precision.
 
 template <typename T>
 class Form
@@ -192,6 +228,62 @@ public:
     }
   }
 
+  /// Set a batched kernel for integral i of given type. A batched
+  /// kernel computes the element tensors for `batch_size` cells in one
+  /// call. The coordinate dofs, coefficients and element tensors of the
+  /// cells in a batch are interleaved, i.e. entry j for cell k of the
+  /// batch is at position j * batch_size + k. If set, the batched
+  /// kernel is used in place of Form::kernel by the assemblers.
+  /// Currently only supported for cell integrals.
+  /// @param[in] type Integral type
+  /// @param[in] i Domain index
+  /// @param[in] batch_size Number of cells computed per kernel call
+  /// @param[in] kernel The batched kernel
+  void set_batch_kernel(
+      IntegralType type, int i, int batch_size,
+      const std::function<void(T*, const T*, const T*, const double*,
+                               const int*, const std::uint8_t*)>& kernel)
+  {
+    if (type != IntegralType::cell)
+    {
+      throw std::runtime_error(
+          "Batched kernels are only supported for cell integrals.");
+    }
+    if (_cell_integrals.find(i) == _cell_integrals.end())
+      throw std::runtime_error("No integral for requested domain index.");
+    if (batch_size < 1)
+      throw std::runtime_error("Batch size must be positive.");
+    _cell_batch_kernels[i] = {batch_size, kernel};
+  }
+
+  /// Get the batch size of the batched kernel for integral i of given
+  /// type
+  /// @param[in] type Integral type
+  /// @param[in] i Domain index
+  /// @return Number of cells computed per batched kernel call. Zero if
+  /// no batched kernel has been set.
+  int batch_size(IntegralType type, int i) const
+  {
+    if (type != IntegralType::cell)
+      return 0;
+    auto it = _cell_batch_kernels.find(i);
+    return it == _cell_batch_kernels.end() ? 0 : it->second.first;
+  }
+
+  /// Get the batched kernel for integral i of given type
+  /// @param[in] type Integral type
+  /// @param[in] i Domain index
+  /// @return Batched function to call for tabulate_tensor
+  const std::function<void(T*, const T*, const T*, const double*, const int*,
+                           const std::uint8_t*)>&
+  batch_kernel(IntegralType type, int i) const
+  {
+    auto it = _cell_batch_kernels.find(i);
+    if (type != IntegralType::cell or it == _cell_batch_kernels.end())
+      throw std::runtime_error("No batched kernel for requested integral.");
+    return it->second.second;
+  }
+
   /// Get types of integrals in the form
   /// @return Integrals types
   std::set<IntegralType> integral_types() const
@@ -299,6 +391,141 @@ public:
     return it->second.second;
   }
 
+  /// Get a colouring of the entities for the ith integral (kernel) of
+  /// given type. Entities with the same colour do not share
+  /// degrees-of-freedom of the test space (function space 0), and can
+  /// therefore be assembled concurrently. The colouring is computed on
+  /// the first call and cached.
+  /// @param[in] type Integral type
+  /// @param[in] i Integral ID, i.e. (sub)domain index
+  /// @return The positions in the list of entities for the integral,
+  /// e.g. Form::cell_domains, for each colour
+  const graph::AdjacencyList<std::int32_t>& colouring(IntegralType type,
+                                                     int i) const
+  {
+    if (_function_spaces.empty())
+    {
+      throw std::runtime_error(
+          "Cannot colour entities of a Form without arguments.");
+    }
+
+    if (auto it = _colourings.find({type, i}); it != _colourings.end())
+      return it->second;
+
+    // Build list of test space dofs for each entity
+    assert(_function_spaces[0]->dofmap());
+    const fem::DofMap& dofmap = *_function_spaces[0]->dofmap();
+    std::vector<std::int32_t> dofs, offsets(1, 0);
+    switch (type)
+    {
+    case IntegralType::cell:
+      for (std::int32_t c : cell_domains(i))
+      {
+        auto cell_dofs = dofmap.cell_dofs(c);
+        dofs.insert(dofs.end(), cell_dofs.begin(), cell_dofs.end());
+        offsets.push_back(dofs.size());
+      }
+      break;
+    case IntegralType::exterior_facet:
+      for (auto& facet : exterior_facet_domains(i))
+      {
+        auto cell_dofs = dofmap.cell_dofs(facet.first);
+        dofs.insert(dofs.end(), cell_dofs.begin(), cell_dofs.end());
+        offsets.push_back(dofs.size());
+      }
+      break;
+    case IntegralType::interior_facet:
+      for (auto& facet : interior_facet_domains(i))
+      {
+        auto cell_dofs0 = dofmap.cell_dofs(std::get<0>(facet));
+        auto cell_dofs1 = dofmap.cell_dofs(std::get<2>(facet));
+        dofs.insert(dofs.end(), cell_dofs0.begin(), cell_dofs0.end());
+        dofs.insert(dofs.end(), cell_dofs1.begin(), cell_dofs1.end());
+        offsets.push_back(dofs.size());
+      }
+      break;
+    default:
+      throw std::runtime_error(
+          "Cannot colour entities. Integral type not supported.");
+    }
+
+    auto it = _colourings.emplace_hint(
+        _colourings.end(), std::pair(type, i),
+        graph::compute_colouring(graph::AdjacencyList<std::int32_t>(
+            std::move(dofs), std::move(offsets))));
+    return it->second;
+  }
+
+  /// Get precomputed data for the facets of the ith interior facet
+  /// integral, i.e. the cell pairs, local facet indices, facet
+  /// permutations and the concatenated dofs of the two cells for each
+  /// argument. The data is computed on the first call and cached.
+  /// @param[in] i Integral ID, i.e. (sub)domain index
+  /// @return The interior facet data. Entry `j` corresponds to entry
+  /// `j` of Form::interior_facet_domains.
+  const InteriorFacetTable& interior_facet_table(int i) const
+  {
+    if (auto it = _interior_facet_tables.find(i);
+        it != _interior_facet_tables.end())
+    {
+      return it->second;
+    }
+
+    assert(_mesh);
+    const std::vector<std::uint8_t>* perms = nullptr;
+    if (_needs_facet_permutations)
+    {
+      _mesh->topology_mutable().create_entity_permutations();
+      perms = &_mesh->topology().get_facet_permutations();
+    }
+    const int tdim = _mesh->topology().dim();
+    const int num_cell_facets
+        = mesh::cell_num_entities(_mesh->topology().cell_type(), tdim - 1);
+
+    const std::vector<std::tuple<std::int32_t, int, std::int32_t, int>>&
+        facets
+        = interior_facet_domains(i);
+    InteriorFacetTable table;
+    table.cells.reserve(facets.size());
+    table.local_facets.reserve(facets.size());
+    table.perms.reserve(facets.size());
+    for (auto& [c0, f0, c1, f1] : facets)
+    {
+      table.cells.push_back({c0, c1});
+      table.local_facets.push_back({f0, f1});
+      if (perms)
+      {
+        table.perms.push_back({(*perms)[c0 * num_cell_facets + f0],
+                               (*perms)[c1 * num_cell_facets + f1]});
+      }
+      else
+        table.perms.push_back({0, 0});
+    }
+
+    // Concatenate the dofs of the two cells for each argument
+    for (auto& V : _function_spaces)
+    {
+      assert(V->dofmap());
+      const fem::DofMap& dofmap = *V->dofmap();
+      table.num_cell_dofs.push_back(
+          table.cells.empty()
+              ? 0
+              : dofmap.cell_dofs(table.cells.front()[0]).size());
+      std::vector<std::int32_t> dofs, offsets(1, 0);
+      for (auto& cells : table.cells)
+      {
+        auto dofs0 = dofmap.cell_dofs(cells[0]);
+        auto dofs1 = dofmap.cell_dofs(cells[1]);
+        dofs.insert(dofs.end(), dofs0.begin(), dofs0.end());
+        dofs.insert(dofs.end(), dofs1.begin(), dofs1.end());
+        offsets.push_back(dofs.size());
+      }
+      table.dofs.emplace_back(std::move(dofs), std::move(offsets));
+    }
+
+    return _interior_facet_tables.emplace(i, std::move(table)).first->second;
+  }
+
   /// Access coefficients
   const std::vector<std::shared_ptr<const fem::Function<T>>>
   coefficients() const
@@ -317,21 +544,85 @@ public:
   std::vector<int> coefficient_offsets() const
   {
     std::vector<int> n = {0};
-    for (const auto& c : _coefficients)
+    for (std::size_t i = 0; i < _coefficients.size(); ++i)
     {
-      if (!c)
+      if (auto it = _quadrature_data.find(i); it != _quadrature_data.end())
+      {
+        const QuadratureData<T>& data = *it->second;
+        n.push_back(n.back() + data.num_points() * data.value_size());
+      }
+      else if (const auto& c = _coefficients[i]; c)
+      {
+        n.push_back(n.back()
+                    + c->function_space()->element()->space_dimension());
+      }
+      else
         throw std::runtime_error("Not all form coefficients have been set.");
-      n.push_back(n.back() + c->function_space()->element()->space_dimension());
     }
     return n;
   }
 
+  /// Use quadrature point data for a coefficient. The values of @p
+  /// data are packed as the cell expansion of coefficient @p i, in
+  /// place of the Function (if any) that was given for it. The number
+  /// of values per cell must match the space dimension of the element
+  /// that the form was compiled with for the coefficient, e.g. a
+  /// quadrature element.
+  /// @param[in] i The coefficient index
+  /// @param[in] data The quadrature data. Must be on the mesh of the
+  /// form, and `num_points * value_size` must be equal to the space
+  /// dimension of the element of the Function given for the
+  /// coefficient.
+  void set_quadrature_data(int i,
+                           std::shared_ptr<const QuadratureData<T>> data)
+  {
+    if (i < 0 or i >= (int)_coefficients.size())
+      throw std::runtime_error("Invalid coefficient index.");
+    assert(data);
+    if (data->mesh() != _mesh)
+      throw std::runtime_error("Incompatible mesh");
+    if (const auto& c = _coefficients[i];
+        c
+        and data->num_points() * data->value_size()
+                != c->function_space()->element()->space_dimension())
+    {
+      throw std::runtime_error(
+          "Quadrature data size does not match the coefficient element.");
+    }
+    _quadrature_data[i] = data;
+  }
+
+  /// Quadrature point data used for coefficients
+  /// @return Map from coefficient index to the quadrature data
+  const std::map<int, std::shared_ptr<const QuadratureData<T>>>&
+  quadrature_data() const
+  {
+    return _quadrature_data;
+  }
+
   /// Access constants
   const std::vector<std::shared_ptr<const fem::Constant<T>>>& constants() const
   {
     return _constants;
   }
 
+  /// Packed coefficient data that is retained by the form between
+  /// assembly calls, together with the versions of the coefficients
+  /// that it was packed from
+  struct PackedData
+  {
+    /// Packed coefficients, (cell, coefficient dofs) row-major
+    std::vector<T> coefficients;
+
+    /// (id, version) of each coefficient when it was last packed
+    std::vector<std::pair<std::size_t, std::size_t>> coefficient_versions;
+  };
+
+  /// Packed data retained between assembly calls. See
+  /// fem::pack_coefficients_cached.
+  /// @return The packed data
+  PackedData& packed_data() { return _packed_data; }
+
   /// Scalar type (T)
   using scalar_type = T;
 
@@ -643,6 +934,10 @@ private:
   // Form coefficients
   std::vector<std::shared_ptr<const fem::Function<T>>> _coefficients;
 
+  // Quadrature point data used for coefficients, coefficient index ->
+  // data
+  std::map<int, std::shared_ptr<const QuadratureData<T>>> _quadrature_data;
+
   // Constants associated with the Form
   std::vector<std::shared_ptr<const fem::Constant<T>>> _constants;
 
@@ -652,6 +947,9 @@ private:
   // Cell integrals
   std::map<int, std::pair<kern, std::vector<std::int32_t>>> _cell_integrals;
 
+  // Batched cell kernels, id -> (batch size, kernel)
+  std::map<int, std::pair<int, kern>> _cell_batch_kernels;
+
   // Exterior facet integrals
   std::map<int, std::pair<kern, std::vector<std::pair<std::int32_t, int>>>>
       _exterior_facet_integrals;
@@ -663,5 +961,16 @@ private:
 
   // True if permutation data needs to be passed into these integrals
   bool _needs_facet_permutations;
+
+  // Cached colourings of the integral entities, (type, id) -> colours
+  mutable std::map<std::pair<IntegralType, int>,
+                   graph::AdjacencyList<std::int32_t>>
+      _colourings;
+
+  // Cached interior facet data, integral id -> data
+  mutable std::map<int, InteriorFacetTable> _interior_facet_tables;
+
+  // Packed coefficients retained between assembly calls
+  PackedData _packed_data;
 };
 } // namespace dolfinx::fem
@@ -17,7 +17,9 @@
 #include <dolfinx/mesh/Geometry.h>
 #include <dolfinx/mesh/Mesh.h>
 #include <dolfinx/mesh/Topology.h>
+#include <algorithm>
 #include <functional>
+#include <future>
 #include <memory>
 #include <numeric>
 #include <petscvec.h>
@@ -199,6 +201,27 @@ public:
   /// Underlying vector
   std::shared_ptr<la::Vector<T>> x() { return _x; }
 
+  /// Modification counter for the degree-of-freedom values. It changes
+  /// whenever the underlying vector may have been modified (see
+  /// la::Vector::version) or the PETSc vector wrapper returned by
+  /// vector() has been modified. It is used to avoid re-packing
+  /// unchanged coefficients.
+  /// @note Changes made through a previously obtained view of the
+  /// values are not detected. Call la::Vector::increment_version on x()
+  /// after such changes.
+  /// @return The version
+  std::size_t version() const
+  {
+    std::size_t v = _x->version();
+    if (_petsc_vector)
+    {
+      PetscObjectState state;
+      PetscObjectStateGet((PetscObject)_petsc_vector, &state);
+      v += state;
+    }
+    return v;
+  }
+
   /// Interpolate a Function (on possibly non-matching meshes)
   /// @param[in] v The function to be interpolated.
   void interpolate(const Function<T>& v) { fem::interpolate(*this, v); }
@@ -226,6 +249,12 @@ public:
 
   /// Evaluate the Function at points
   ///
+  /// The points are grouped by the cell that contains them, and the
+  /// cell geometry, the pull-back (a single Jacobian per cell for
+  /// affine maps), the basis functions and the expansion coefficients
+  /// are computed once for all points in a cell. The points do not
+  /// need to be ordered by cell.
+  ///
   /// @param[in] x The coordinates of the points. It has shape
   /// (num_points, 3).
   /// @param[in] cells An array of cell indices. cells[i] is the index
@@ -234,13 +263,13 @@ public:
   /// @param[in,out] u The values at the points. Values are not computed
   /// for points with a negative cell index. This argument must be
   /// passed with the correct size.
+  /// @param[in] num_threads The number of threads to use. The cells
+  /// are divided into contiguous blocks that are evaluated
+  /// concurrently.
   void eval(const xt::xtensor<double, 2>& x,
-            const xtl::span<const std::int32_t>& cells,
-            xt::xtensor<T, 2>& u) const
+            const xtl::span<const std::int32_t>& cells, xt::xtensor<T, 2>& u,
+            int num_threads = 1) const
   {
-    // TODO: This could be easily made more efficient by exploiting points
-    // being ordered by the cell to which they belong.
-
     if (x.shape(0) != cells.size())
     {
       throw std::runtime_error(
@@ -252,6 +281,30 @@ public:
           "Length of array for Function values must be the "
           "same as the number of points.");
     }
+    if (num_threads < 1)
+      throw std::runtime_error("Number of threads must be positive.");
+
+    // Group the points by cell. Points in group g are
+    // points[group_offsets[g]:group_offsets[g + 1]].
+    std::vector<std::int32_t> points;
+    points.reserve(cells.size());
+    for (std::size_t p = 0; p < cells.size(); ++p)
+    {
+      if (cells[p] >= 0)
+        points.push_back(p);
+    }
+    std::stable_sort(points.begin(), points.end(),
+                     [&cells](std::int32_t p0, std::int32_t p1)
+                     { return cells[p0] < cells[p1]; });
+    std::vector<std::size_t> group_offsets(1, 0);
+    for (std::size_t i = 1; i < points.size(); ++i)
+    {
+      if (cells[points[i]] != cells[points[i - 1]])
+        group_offsets.push_back(i);
+    }
+    if (!points.empty())
+      group_offsets.push_back(points.size());
+    const std::size_t num_groups = group_offsets.size() - 1;
 
     // Get mesh
     assert(_function_space);
@@ -259,7 +312,6 @@ public:
     assert(mesh);
     const std::size_t gdim = mesh->geometry().dim();
     const std::size_t tdim = mesh->topology().dim();
-    auto map = mesh->topology().index_map(tdim);
 
     // Get geometry data
     const graph::AdjacencyList<std::int32_t>& x_dofmap
@@ -291,17 +343,6 @@ public:
                                "elements. Extract subspaces.");
     }
 
-    // Prepare basis function data structures
-    xt::xtensor<double, 4> basis_derivatives_reference_values(
-        {1, 1, space_dimension, reference_value_size});
-    auto basis_reference_values = xt::view(basis_derivatives_reference_values,
-                                           0, xt::all(), xt::all(), xt::all());
-    xt::xtensor<double, 3> basis_values(
-        {static_cast<std::size_t>(1), space_dimension, value_size});
-
-    // Create work vector for expansion coefficients
-    std::vector<T> coefficients(space_dimension * bs_element);
-
     // Get dofmap
     std::shared_ptr<const fem::DofMap> dofmap = _function_space->dofmap();
     assert(dofmap);
@@ -314,11 +355,6 @@ public:
       cell_info = xtl::span(mesh->topology().get_cell_permutation_info());
     }
 
-    xt::xtensor<double, 2> coordinate_dofs
-        = xt::zeros<double>({num_dofs_g, gdim});
-    xt::xtensor<double, 2> xp = xt::zeros<double>({std::size_t(1), gdim});
-
-    // Loop over points
     std::fill(u.data(), u.data() + u.size(), 0.0);
     const xtl::span<const T>& _v = _x->array();
 
@@ -328,99 +364,149 @@ public:
         apply_dof_transformation
         = element->get_dof_transformation_function<double>();
 
-    // -- Lambda function for affine pull-backs
-    auto pull_back_affine =
-        [&cmap, tdim,
-         X0 = xt::xtensor<double, 2>(xt::zeros<double>({std::size_t(1), tdim})),
-         data = xt::xtensor<double, 4>(cmap.tabulate_shape(1, 1)),
-         dphi = xt::xtensor<double, 2>({tdim, cmap.tabulate_shape(1, 1)[2]})](
-            auto&& X, const auto& cell_geometry, auto&& J, auto&& K,
-            const auto& x) mutable
+    // The derivatives of the coordinate element basis are constant for
+    // affine maps, so tabulate them once
+    xt::xtensor<double, 2> dphi0;
+    if (cmap.is_affine())
     {
+      xt::xtensor<double, 2> X0 = xt::zeros<double>({std::size_t(1), tdim});
+      xt::xtensor<double, 4> data(cmap.tabulate_shape(1, 1));
       cmap.tabulate(1, X0, data);
-      dphi = xt::view(data, xt::range(1, tdim + 1), 0, xt::all(), 0);
-      cmap.compute_jacobian(dphi, cell_geometry, J);
-      cmap.compute_jacobian_inverse(J, K);
-      cmap.pull_back_affine(X, K, cmap.x0(cell_geometry), x);
-    };
+      dphi0 = xt::view(data, xt::range(1, tdim + 1), 0, xt::all(), 0);
+    }
 
-    xt::xtensor<double, 2> dphi;
-    xt::xtensor<double, 2> X({1, tdim});
-    xt::xtensor<double, 3> J = xt::zeros<double>({std::size_t(1), gdim, tdim});
-    xt::xtensor<double, 3> K = xt::zeros<double>({std::size_t(1), tdim, gdim});
-    xt::xtensor<double, 1> detJ = xt::zeros<double>({1});
-    xt::xtensor<double, 4> phi(cmap.tabulate_shape(1, 1));
-    for (std::size_t p = 0; p < cells.size(); ++p)
+    // Evaluate at the points in groups [g0, g1)
+    auto eval_groups = [&](std::size_t g0, std::size_t g1)
     {
-      const int cell_index = cells[p];
-
-      // Skip negative cell indices
-      if (cell_index < 0)
-        continue;
-
-      // Get cell geometry (coordinate dofs)
-      auto x_dofs = x_dofmap.links(cell_index);
-      for (std::size_t i = 0; i < num_dofs_g; ++i)
-        for (std::size_t j = 0; j < gdim; ++j)
-          coordinate_dofs(i, j) = x_g(x_dofs[i], j);
-
-      for (std::size_t j = 0; j < gdim; ++j)
-        xp(0, j) = x(p, j);
-
-      // Compute reference coordinates X, and J, detJ and K
-      if (cmap.is_affine())
+      xt::xtensor<double, 2> coordinate_dofs
+          = xt::zeros<double>({num_dofs_g, gdim});
+      std::vector<T> coefficients(space_dimension * bs_element);
+      xt::xtensor<double, 2> J0({gdim, tdim}), K0({tdim, gdim});
+      xt::xtensor<double, 2> xp, X, dphi;
+      xt::xtensor<double, 3> J, K, basis_values;
+      xt::xtensor<double, 1> detJ;
+      xt::xtensor<double, 4> phi, basis_derivatives_reference_values;
+      for (std::size_t g = g0; g < g1; ++g)
       {
-        J.fill(0);
-        pull_back_affine(X, coordinate_dofs,
-                         xt::view(J, 0, xt::all(), xt::all()),
-                         xt::view(K, 0, xt::all(), xt::all()), xp);
-        detJ[0] = cmap.compute_jacobian_determinant(
-            xt::view(J, 0, xt::all(), xt::all()));
-      }
-      else
-      {
-        cmap.pull_back_nonaffine(X, xp, coordinate_dofs);
-        cmap.tabulate(1, X, phi);
-        dphi = xt::view(phi, xt::range(1, tdim + 1), 0, xt::all(), 0);
-        J.fill(0);
-        auto _J = xt::view(J, 0, xt::all(), xt::all());
-        cmap.compute_jacobian(dphi, coordinate_dofs, _J);
-        cmap.compute_jacobian_inverse(_J, xt::view(K, 0, xt::all(), xt::all()));
-        detJ[0] = cmap.compute_jacobian_determinant(_J);
-      }
-
-      // Compute basis on reference element
-      element->tabulate(basis_derivatives_reference_values, X, 0);
+        const std::int32_t* group_points = points.data() + group_offsets[g];
+        const std::size_t num_points = group_offsets[g + 1] - group_offsets[g];
+        const std::int32_t cell_index = cells[group_points[0]];
+
+        // Get cell geometry (coordinate dofs)
+        auto x_dofs = x_dofmap.links(cell_index);
+        for (std::size_t i = 0; i < num_dofs_g; ++i)
+          for (std::size_t j = 0; j < gdim; ++j)
+            coordinate_dofs(i, j) = x_g(x_dofs[i], j);
+
+        xp.resize({num_points, gdim});
+        for (std::size_t i = 0; i < num_points; ++i)
+          for (std::size_t j = 0; j < gdim; ++j)
+            xp(i, j) = x(group_points[i], j);
+
+        // Compute reference coordinates X, and J, detJ and K
+        X.resize({num_points, tdim});
+        J.resize({num_points, gdim, tdim});
+        K.resize({num_points, tdim, gdim});
+        detJ.resize({num_points});
+        if (cmap.is_affine())
+        {
+          // A single Jacobian for all points in the cell
+          J0.fill(0);
+          cmap.compute_jacobian(dphi0, coordinate_dofs, J0);
+          cmap.compute_jacobian_inverse(J0, K0);
+          cmap.pull_back_affine(X, K0, cmap.x0(coordinate_dofs), xp);
+          const double detJ0 = cmap.compute_jacobian_determinant(J0);
+          for (std::size_t i = 0; i < num_points; ++i)
+          {
+            xt::view(J, i, xt::all(), xt::all()) = J0;
+            xt::view(K, i, xt::all(), xt::all()) = K0;
+            detJ[i] = detJ0;
+          }
+        }
+        else
+        {
+          cmap.pull_back_nonaffine(X, xp, coordinate_dofs);
+          phi.resize(cmap.tabulate_shape(1, num_points));
+          cmap.tabulate(1, X, phi);
+          J.fill(0);
+          for (std::size_t i = 0; i < num_points; ++i)
+          {
+            dphi = xt::view(phi, xt::range(1, tdim + 1), i, xt::all(), 0);
+            auto _J = xt::view(J, i, xt::all(), xt::all());
+            cmap.compute_jacobian(dphi, coordinate_dofs, _J);
+            cmap.compute_jacobian_inverse(_J,
+                                          xt::view(K, i, xt::all(), xt::all()));
+            detJ[i] = cmap.compute_jacobian_determinant(_J);
+          }
+        }
 
-      // Permute the reference values to account for the cell's orientation
-      apply_dof_transformation(xtl::span(basis_reference_values.data(),
-                                         basis_reference_values.size()),
-                               cell_info, cell_index, reference_value_size);
+        // Compute basis on reference element at all points in the cell
+        basis_derivatives_reference_values.resize(
+            {1, num_points, space_dimension, reference_value_size});
+        element->tabulate(basis_derivatives_reference_values, X, 0);
+        auto basis_reference_values
+            = xt::view(basis_derivatives_reference_values, 0, xt::all(),
+                       xt::all(), xt::all());
+
+        // Permute the reference values to account for the cell's
+        // orientation
+        const std::size_t num_basis_values
+            = space_dimension * reference_value_size;
+        for (std::size_t i = 0; i < num_points; ++i)
+        {
+          apply_dof_transformation(
+              xtl::span(basis_derivatives_reference_values.data()
+                            + i * num_basis_values,
+                        num_basis_values),
+              cell_info, cell_index, reference_value_size);
+        }
 
-      // Push basis forward to physical element
-      element->transform_reference_basis(basis_values, basis_reference_values,
-                                         J, detJ, K);
+        // Push basis forward to physical element
+        basis_values.resize({num_points, space_dimension, value_size});
+        element->transform_reference_basis(
+            basis_values, basis_reference_values, J, detJ, K);
 
-      // Get degrees of freedom for current cell
-      xtl::span<const std::int32_t> dofs = dofmap->cell_dofs(cell_index);
-      for (std::size_t i = 0; i < dofs.size(); ++i)
-        for (int k = 0; k < bs_dof; ++k)
-          coefficients[bs_dof * i + k] = _v[bs_dof * dofs[i] + k];
+        // Get degrees of freedom for current cell
+        xtl::span<const std::int32_t> dofs = dofmap->cell_dofs(cell_index);
+        for (std::size_t i = 0; i < dofs.size(); ++i)
+          for (int k = 0; k < bs_dof; ++k)
+            coefficients[bs_dof * i + k] = _v[bs_dof * dofs[i] + k];
 
-      // Compute expansion
-      auto u_row = xt::row(u, p);
-      for (int k = 0; k < bs_element; ++k)
-      {
-        for (std::size_t i = 0; i < space_dimension; ++i)
+        // Compute expansion
+        for (std::size_t p = 0; p < num_points; ++p)
         {
-          for (std::size_t j = 0; j < value_size; ++j)
+          auto u_row = xt::row(u, group_points[p]);
+          for (int k = 0; k < bs_element; ++k)
           {
-            u_row[j * bs_element + k]
-                += coefficients[bs_element * i + k] * basis_values(0, i, j);
+            for (std::size_t i = 0; i < space_dimension; ++i)
+            {
+              for (std::size_t j = 0; j < value_size; ++j)
+              {
+                u_row[j * bs_element + k]
+                    += coefficients[bs_element * i + k]
+                       * basis_values(p, i, j);
+              }
+            }
           }
         }
       }
+    };
+
+    // Evaluate contiguous blocks of cells concurrently. An exception
+    // thrown on any thread is rethrown by future::get, and the
+    // destructors of the remaining futures wait for their threads.
+    const std::size_t num_blocks
+        = std::min<std::size_t>(num_threads, num_groups);
+    std::vector<std::future<void>> futures;
+    for (std::size_t t = 1; t < num_blocks; ++t)
+    {
+      futures.push_back(std::async(std::launch::async, eval_groups,
+                                   t * num_groups / num_blocks,
+                                   (t + 1) * num_groups / num_blocks));
     }
+    eval_groups(0, num_blocks > 0 ? num_groups / num_blocks : 0);
+    for (auto& f : futures)
+      f.get();
   }
 
   /// Compute values at all mesh 'nodes'
@@ -0,0 +1,123 @@
+// Copyright (C) 2021 Garth N. Wells
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/UniqueIdGenerator.h>
+#include <dolfinx/la/Vector.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/Topology.h>
+#include <memory>
+#include <stdexcept>
+#include <xtl/xspan.hpp>
+
+namespace dolfinx::fem
+{
+
+/// Storage for values at the quadrature points of all cells of a mesh,
+/// e.g. history variables in a constitutive model.
+///
+/// The values of a cell are stored contiguously, ordered by point and
+/// then by component. The storage is a la::Vector with the cell
+/// IndexMap of the mesh, so ghost cell values are updated with
+/// QuadratureData::scatter_fwd. QuadratureData can be attached to a
+/// Form coefficient (see Form::set_quadrature_data), in which case the
+/// values are packed for assembly without interpolation, and it can
+/// be written to in place by Expression::eval.
+template <typename T>
+class QuadratureData
+{
+public:
+  /// Create quadrature point data on a mesh. The values are
+  /// initialised to zero.
+  /// @param[in] mesh The mesh
+  /// @param[in] num_points The number of quadrature points per cell
+  /// @param[in] value_size The number of values at each quadrature
+  /// point
+  QuadratureData(const std::shared_ptr<const mesh::Mesh>& mesh,
+                 int num_points, int value_size)
+      : _id(common::UniqueIdGenerator::id()), _mesh(mesh),
+        _num_points(num_points), _value_size(value_size)
+  {
+    assert(mesh);
+    if (num_points < 1 or value_size < 1)
+    {
+      throw std::runtime_error("Number of quadrature points and value size "
+                               "must be positive.");
+    }
+
+    const int tdim = mesh->topology().dim();
+    std::shared_ptr<const common::IndexMap> map
+        = mesh->topology().index_map(tdim);
+    if (!map)
+      throw std::runtime_error("Mesh cell IndexMap does not exist.");
+    _x = std::make_shared<la::Vector<T>>(map, num_points * value_size);
+  }
+
+  /// Move constructor
+  QuadratureData(QuadratureData&& data) = default;
+
+  /// Destructor
+  ~QuadratureData() = default;
+
+  /// Move assignment
+  QuadratureData& operator=(QuadratureData&& data) = default;
+
+  /// The mesh
+  std::shared_ptr<const mesh::Mesh> mesh() const { return _mesh; }
+
+  /// Number of quadrature points per cell
+  int num_points() const { return _num_points; }
+
+  /// Number of values at each quadrature point
+  int value_size() const { return _value_size; }
+
+  /// The cell IndexMap of the mesh, which the storage is distributed by
+  std::shared_ptr<const common::IndexMap> index_map() const
+  {
+    return _x->map();
+  }
+
+  /// Underlying vector. The block size is `num_points * value_size`.
+  std::shared_ptr<const la::Vector<T>> x() const { return _x; }
+
+  /// Underlying vector. The block size is `num_points * value_size`.
+  std::shared_ptr<la::Vector<T>> x() { return _x; }
+
+  /// Values at the quadrature points of a cell
+  /// @param[in] cell The cell (local index)
+  /// @return The values, with shape (num_points, value_size) row-major
+  xtl::span<const T> values(std::int32_t cell) const
+  {
+    const int bs = _num_points * _value_size;
+    return _x->array().subspan(bs * cell, bs);
+  }
+
+  /// Update the ghost cell values from the owning processes
+  void scatter_fwd() { _x->scatter_fwd(); }
+
+  /// Unique ID
+  std::size_t id() const { return _id; }
+
+  /// Version of the values, which changes when the values are modified
+  /// through the underlying vector (see la::Vector::version)
+  std::size_t version() const { return _x->version(); }
+
+private:
+  // ID
+  std::size_t _id;
+
+  // The mesh
+  std::shared_ptr<const mesh::Mesh> _mesh;
+
+  // Number of quadrature points per cell and values per point
+  int _num_points, _value_size;
+
+  // Values, blocked by cell
+  std::shared_ptr<la::Vector<T>> _x;
+};
+} // namespace dolfinx::fem
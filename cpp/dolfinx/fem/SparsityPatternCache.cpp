@@ -0,0 +1,159 @@
+// Copyright (C) 2021 Garth N. Wells
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#include "SparsityPatternCache.h"
+#include "DofMap.h"
+#include "utils.h"
+#include <dolfinx/common/Timer.h>
+#include <dolfinx/la/PETScMatrix.h>
+#include <dolfinx/la/PETScVector.h>
+#include <dolfinx/la/SparsityPattern.h>
+
+using namespace dolfinx;
+using namespace dolfinx::fem;
+
+namespace
+{
+/// Insert zeros into all entries of a sparsity pattern and finalise
+/// the matrix. Only assembled matrices can be duplicated with
+/// MAT_SHARE_NONZERO_PATTERN.
+void insert_zeros(Mat A, const la::SparsityPattern& pattern)
+{
+  const std::array bs = {pattern.block_size(0), pattern.block_size(1)};
+  const std::int64_t offset0 = pattern.index_map(0)->local_range()[0];
+  const std::vector<std::int64_t> global1 = pattern.column_indices();
+  const graph::AdjacencyList<std::int32_t>& diag = pattern.diagonal_pattern();
+  const graph::AdjacencyList<std::int32_t>& off_diag
+      = pattern.off_diagonal_pattern();
+
+  std::vector<PetscInt> rows(bs[0]), cols;
+  std::vector<PetscScalar> zeros;
+  for (std::int32_t i = 0; i < diag.num_nodes(); ++i)
+  {
+    for (int k = 0; k < bs[0]; ++k)
+      rows[k] = bs[0] * (offset0 + i) + k;
+
+    cols.clear();
+    for (const graph::AdjacencyList<std::int32_t>* p : {&diag, &off_diag})
+    {
+      for (std::int32_t j : p->links(i))
+        for (int k = 0; k < bs[1]; ++k)
+          cols.push_back(bs[1] * global1[j] + k);
+    }
+
+    zeros.assign(rows.size() * cols.size(), 0);
+    PetscErrorCode ierr
+        = MatSetValues(A, rows.size(), rows.data(), cols.size(), cols.data(),
+                       zeros.data(), INSERT_VALUES);
+    if (ierr != 0)
+      la::petsc_error(ierr, __FILE__, "MatSetValues");
+  }
+
+  MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY);
+  MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY);
+}
+} // namespace
+
+//-----------------------------------------------------------------------------
+SparsityPatternCache::SparsityPatternCache(SparsityPatternCache&& cache)
+    : _entries(std::move(cache._entries))
+{
+  cache._entries.clear();
+}
+//-----------------------------------------------------------------------------
+SparsityPatternCache::~SparsityPatternCache() { clear(); }
+//-----------------------------------------------------------------------------
+SparsityPatternCache&
+SparsityPatternCache::operator=(SparsityPatternCache&& cache)
+{
+  if (this != &cache)
+  {
+    clear();
+    _entries = std::move(cache._entries);
+    cache._entries.clear();
+  }
+  return *this;
+}
+//-----------------------------------------------------------------------------
+std::shared_ptr<const la::SparsityPattern> SparsityPatternCache::pattern(
+    const mesh::Topology& topology,
+    const std::array<std::shared_ptr<const DofMap>, 2>& dofmaps,
+    const std::set<IntegralType>& types)
+{
+  assert(dofmaps[0]);
+  assert(dofmaps[1]);
+  prune();
+
+  const key_t key = {dofmaps[0].get(), dofmaps[1].get(), types};
+  if (auto it = _entries.find(key); it != _entries.end())
+    return it->second.pattern;
+
+  common::Timer t0("Build sparsity (cached)");
+  la::SparsityPattern pattern
+      = fem::create_sparsity_pattern(topology, {*dofmaps[0], *dofmaps[1]},
+                                     types);
+  pattern.assemble();
+
+  Entry entry{{dofmaps[0], dofmaps[1]},
+              std::make_shared<const la::SparsityPattern>(std::move(pattern)),
+              {}};
+  auto it = _entries.emplace(key, std::move(entry)).first;
+  return it->second.pattern;
+}
+//-----------------------------------------------------------------------------
+Mat SparsityPatternCache::create_matrix(const Form<PetscScalar>& a,
+                                        const std::string& type)
+{
+  std::shared_ptr<const la::SparsityPattern> p = this->pattern(a);
+  const key_t key = {a.function_spaces()[0]->dofmap().get(),
+                     a.function_spaces()[1]->dofmap().get(),
+                     a.integral_types()};
+  Entry& entry = _entries.at(key);
+
+  // Create template matrix from the pattern on first request for this
+  // type
+  auto it = entry.matrices.find(type);
+  if (it == entry.matrices.end())
+  {
+    Mat A = la::create_petsc_matrix(a.mesh()->mpi_comm(), *p, type);
+    insert_zeros(A, *p);
+    it = entry.matrices.insert({type, A}).first;
+  }
+
+  // Duplicate, sharing the nonzero structure
+  Mat B;
+  PetscErrorCode ierr = MatDuplicate(it->second, MAT_SHARE_NONZERO_PATTERN, &B);
+  if (ierr != 0)
+    la::petsc_error(ierr, __FILE__, "MatDuplicate");
+  return B;
+}
+//-----------------------------------------------------------------------------
+void SparsityPatternCache::clear()
+{
+  for (auto& [key, entry] : _entries)
+    for (auto& [type, A] : entry.matrices)
+      MatDestroy(&A);
+  _entries.clear();
+}
+//-----------------------------------------------------------------------------
+std::size_t SparsityPatternCache::size() const { return _entries.size(); }
+//-----------------------------------------------------------------------------
+void SparsityPatternCache::prune()
+{
+  for (auto it = _entries.begin(); it != _entries.end();)
+  {
+    Entry& entry = it->second;
+    if (entry.dofmaps[0].expired() or entry.dofmaps[1].expired())
+    {
+      for (auto& [type, A] : entry.matrices)
+        MatDestroy(&A);
+      it = _entries.erase(it);
+    }
+    else
+      ++it;
+  }
+}
+//-----------------------------------------------------------------------------
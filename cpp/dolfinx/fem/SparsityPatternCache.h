@@ -0,0 +1,147 @@
+// Copyright (C) 2021 Garth N. Wells
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <dolfinx/fem/Form.h>
+#include <map>
+#include <memory>
+#include <petscmat.h>
+#include <set>
+#include <string>
+#include <tuple>
+
+namespace dolfinx::la
+{
+class SparsityPattern;
+}
+
+namespace dolfinx::mesh
+{
+class Topology;
+}
+
+namespace dolfinx::fem
+{
+class DofMap;
+
+/// Cache of finalised sparsity patterns for bilinear forms
+///
+/// The sparsity pattern of a bilinear form depends only on the test
+/// and trial dofmaps and on the types of integrals in the form, since a
+/// pattern is built over all entities of each integral type. Patterns
+/// are cached using the identity of the dofmaps and the set of integral
+/// types as the key, so forms that share function spaces and integral
+/// types share a pattern. PETSc matrices created by the cache share
+/// their nonzero (CSR) structure.
+///
+/// Entries for dofmaps that have been destroyed are removed on the
+/// next lookup.
+
+class SparsityPatternCache
+{
+public:
+  /// Create an empty cache
+  SparsityPatternCache() = default;
+
+  /// Copy constructor (deleted)
+  SparsityPatternCache(const SparsityPatternCache& cache) = delete;
+
+  /// Move constructor
+  SparsityPatternCache(SparsityPatternCache&& cache);
+
+  /// Destructor
+  ~SparsityPatternCache();
+
+  /// Copy assignment (deleted)
+  SparsityPatternCache& operator=(const SparsityPatternCache& cache) = delete;
+
+  /// Move assignment. The matrices cached by this object are
+  /// destroyed.
+  SparsityPatternCache& operator=(SparsityPatternCache&& cache);
+
+  /// Get a finalised sparsity pattern for a bilinear form. The pattern
+  /// is built and finalised on first request.
+  /// @note Collective if the pattern is not in the cache
+  /// @param[in] a A bilinear form
+  /// @return The finalised sparsity pattern
+  template <typename T>
+  std::shared_ptr<const la::SparsityPattern> pattern(const Form<T>& a)
+  {
+    if (a.rank() != 2)
+    {
+      throw std::runtime_error(
+          "Cannot create sparsity pattern. Form is not a bilinear form");
+    }
+
+    std::shared_ptr mesh = a.mesh();
+    assert(mesh);
+    const std::set<IntegralType> types = a.integral_types();
+    if (types.find(IntegralType::interior_facet) != types.end()
+        or types.find(IntegralType::exterior_facet) != types.end())
+    {
+      const int tdim = mesh->topology().dim();
+      mesh->topology_mutable().create_entities(tdim - 1);
+      mesh->topology_mutable().create_connectivity(tdim - 1, tdim);
+    }
+
+    return pattern(mesh->topology(),
+                   {a.function_spaces().at(0)->dofmap(),
+                    a.function_spaces().at(1)->dofmap()},
+                   types);
+  }
+
+  /// Get a finalised sparsity pattern for a pair of dofmaps and a set
+  /// of integral types. The pattern is built and finalised on first
+  /// request.
+  /// @note Collective if the pattern is not in the cache
+  /// @param[in] topology The mesh topology
+  /// @param[in] dofmaps The test (0) and trial (1) dofmaps
+  /// @param[in] types The integral types
+  /// @return The finalised sparsity pattern
+  std::shared_ptr<const la::SparsityPattern>
+  pattern(const mesh::Topology& topology,
+          const std::array<std::shared_ptr<const DofMap>, 2>& dofmaps,
+          const std::set<IntegralType>& types);
+
+  /// Create a PETSc matrix for a bilinear form using a cached
+  /// sparsity pattern. On first request for a pattern and matrix type,
+  /// a template matrix is created and zeros are inserted over the
+  /// pattern. Matrices are duplicated from the template (via
+  /// MatDuplicate with MAT_SHARE_NONZERO_PATTERN) and share its nonzero
+  /// structure, which avoids preallocation costs for repeat creations.
+  /// @param[in] a A bilinear form
+  /// @param[in] type The PETSc matrix type to create
+  /// @return A sparse matrix with zero entries. The caller is
+  /// responsible for destroying the Mat object.
+  Mat create_matrix(const Form<PetscScalar>& a,
+                    const std::string& type = std::string());
+
+  /// Remove all cached patterns and matrices
+  void clear();
+
+  /// Number of cached sparsity patterns
+  std::size_t size() const;
+
+private:
+  // Remove entries with dofmaps that no longer exist
+  void prune();
+
+  using key_t = std::tuple<const DofMap*, const DofMap*, std::set<IntegralType>>;
+  struct Entry
+  {
+    std::array<std::weak_ptr<const DofMap>, 2> dofmaps;
+    std::shared_ptr<const la::SparsityPattern> pattern;
+
+    // Matrices (one per PETSc matrix type) from which new matrices are
+    // duplicated
+    std::map<std::string, Mat> matrices;
+  };
+
+  std::map<key_t, Entry> _entries;
+};
+} // namespace dolfinx::fem
@@ -7,16 +7,23 @@
 #pragma once
 
 #include "DofMap.h"
+#include "ElementTensorCache.h"
 #include "Form.h"
 #include "utils.h"
 #include <dolfinx/fem/FunctionSpace.h>
 #include <dolfinx/graph/AdjacencyList.h>
+#include <dolfinx/la/Vector.h>
 #include <dolfinx/la/utils.h>
 #include <dolfinx/mesh/Geometry.h>
 #include <dolfinx/mesh/Mesh.h>
 #include <dolfinx/mesh/Topology.h>
+#include <algorithm>
 #include <functional>
 #include <iterator>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <type_traits>
 #include <vector>
 
 namespace dolfinx::fem::impl
@@ -26,22 +33,140 @@ namespace dolfinx::fem::impl
 /// i.e. a view into a larger matrix, and assembly is performed using
 /// local indices. Rows (bc0) and columns (bc1) with Dirichlet
 /// conditions are zeroed. Markers (bc0 and bc1) can be empty if not bcs
-/// are applied. Matrix is not finalised.
+/// are applied. Matrix is not finalised. If num_threads > 1, entities
+/// are coloured such that entities of the same colour do not share
+/// rows, and entities of the same colour are assembled concurrently.
+/// Calls to mat_set_values are serialised.
 
-template <typename T>
+template <typename T, typename U>
 void assemble_matrix(
-    const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
-                            const std::int32_t*, const T*)>& mat_set_values,
-    const Form<T>& a, const xtl::span<const T>& constants,
-    const xtl::span<const T>& coeffs, int cstride, const std::vector<bool>& bc0,
-    const std::vector<bool>& bc1);
+    const U& mat_set_values, const Form<T>& a,
+    const xtl::span<const T>& constants, const xtl::span<const T>& coeffs,
+    int cstride, const std::vector<bool>& bc0, const std::vector<bool>& bc1,
+    int num_threads = 1);
+
+/// Zero the rows and columns of an element matrix for dofs that have
+/// a Dirichlet boundary condition applied
+/// @tparam T The scalar type
+/// @tparam _bs0 The block size of the row dofmap. If positive, the
+/// block size is used as a compile-time constant, which has performance
+/// benefits.
+/// @tparam _bs1 The block size of the column dofmap. If positive, the
+/// block size is used as a compile-time constant.
+/// @param[in,out] Ae The element matrix (row-major)
+/// @param[in] dofs0 The row dofs (blocked)
+/// @param[in] bs0 The row block size
+/// @param[in] dofs1 The column dofs (blocked)
+/// @param[in] bs1 The column block size
+/// @param[in] bc0 Boundary condition markers for the rows. May be empty.
+/// @param[in] bc1 Boundary condition markers for the columns. May be
+/// empty.
+template <typename T, int _bs0 = -1, int _bs1 = -1>
+void zero_bc_rows_cols(const xtl::span<T>& Ae,
+                       const xtl::span<const std::int32_t>& dofs0, int bs0,
+                       const xtl::span<const std::int32_t>& dofs1, int bs1,
+                       const std::vector<bool>& bc0,
+                       const std::vector<bool>& bc1)
+{
+  assert(_bs0 < 0 or _bs0 == bs0);
+  assert(_bs1 < 0 or _bs1 == bs1);
+
+  // Block sizes, as compile-time constants if known
+  const int rbs = _bs0 > 0 ? _bs0 : bs0;
+  const int cbs = _bs1 > 0 ? _bs1 : bs1;
+
+  const int ndim0 = rbs * dofs0.size();
+  const int ndim1 = cbs * dofs1.size();
+  if (!bc0.empty())
+  {
+    for (std::size_t i = 0; i < dofs0.size(); ++i)
+    {
+      for (int k = 0; k < rbs; ++k)
+      {
+        if (bc0[rbs * dofs0[i] + k])
+        {
+          // Zero row rbs * i + k
+          const int row = rbs * i + k;
+          std::fill_n(std::next(Ae.begin(), ndim1 * row), ndim1, 0.0);
+        }
+      }
+    }
+  }
+
+  if (!bc1.empty())
+  {
+    for (std::size_t j = 0; j < dofs1.size(); ++j)
+    {
+      for (int k = 0; k < cbs; ++k)
+      {
+        if (bc1[cbs * dofs1[j] + k])
+        {
+          // Zero column cbs * j + k
+          const int col = cbs * j + k;
+          for (int row = 0; row < ndim0; ++row)
+            Ae[row * ndim1 + col] = 0.0;
+        }
+      }
+    }
+  }
+}
+
+/// Call a function with the row and column block sizes as
+/// std::integral_constant arguments. Block sizes 1, 2 and 3 are passed
+/// as their values, other block sizes are passed as -1 (runtime block
+/// size). Used to select specialised assembly kernels.
+/// @param[in] bs0 The row block size
+/// @param[in] bs1 The column block size
+/// @param[in] fn The function to call, with signature fn(_bs0, _bs1)
+template <typename F>
+void dispatch_block_sizes(int bs0, int bs1, F&& fn)
+{
+  auto dispatch1 = [bs1, &fn](auto _bs0)
+  {
+    switch (bs1)
+    {
+    case 1:
+      fn(_bs0, std::integral_constant<int, 1>());
+      break;
+    case 2:
+      fn(_bs0, std::integral_constant<int, 2>());
+      break;
+    case 3:
+      fn(_bs0, std::integral_constant<int, 3>());
+      break;
+    default:
+      fn(_bs0, std::integral_constant<int, -1>());
+    }
+  };
+
+  switch (bs0)
+  {
+  case 1:
+    dispatch1(std::integral_constant<int, 1>());
+    break;
+  case 2:
+    dispatch1(std::integral_constant<int, 2>());
+    break;
+  case 3:
+    dispatch1(std::integral_constant<int, 3>());
+    break;
+  default:
+    dispatch1(std::integral_constant<int, -1>());
+  }
+}
 
 /// Execute kernel over cells and accumulate result in matrix
-template <typename T>
+/// @tparam _bs0 The block size of the row dofmap. If positive, the
+/// block size is used as a compile-time constant.
+/// @tparam _bs1 The block size of the column dofmap. If positive, the
+/// block size is used as a compile-time constant.
+/// @tparam U The insertion function type. It is called as
+/// `mat_set(num_rows, rows, num_cols, cols, Ae)`.
+/// @tparam K The kernel type
+template <typename T, int _bs0 = -1, int _bs1 = -1, typename U, typename K>
 void assemble_cells(
-    const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
-                            const std::int32_t*, const T*)>& mat_set,
-    const mesh::Geometry& geometry, const xtl::span<const std::int32_t>& cells,
+    const U& mat_set, const mesh::Geometry& geometry,
+    const xtl::span<const std::int32_t>& cells,
     const std::function<void(const xtl::span<T>&,
                              const xtl::span<const std::uint32_t>&,
                              std::int32_t, int)>& dof_transform,
@@ -50,9 +175,7 @@ void assemble_cells(
                              const xtl::span<const std::uint32_t>&,
                              std::int32_t, int)>& dof_transform_to_transpose,
     const graph::AdjacencyList<std::int32_t>& dofmap1, const int bs1,
-    const std::vector<bool>& bc0, const std::vector<bool>& bc1,
-    const std::function<void(T*, const T*, const T*, const double*, const int*,
-                             const std::uint8_t*)>& kernel,
+    const std::vector<bool>& bc0, const std::vector<bool>& bc1, const K& kernel,
     const xtl::span<const T>& coeffs, int cstride,
     const xtl::span<const T>& constants,
     const xtl::span<const std::uint32_t>& cell_info)
@@ -63,6 +186,7 @@ void assemble_cells(
   // FIXME: Add proper interface for num coordinate dofs
   const std::size_t num_dofs_g = x_dofmap.num_links(0);
   const xt::xtensor<double, 2>& x_g = geometry.x();
+  const xtl::span<const double> x_cache = geometry.cell_coordinates();
 
   // Iterate over active cells
   const int num_dofs0 = dofmap0.links(0).size();
@@ -75,17 +199,13 @@ void assemble_cells(
   for (std::int32_t c : cells)
   {
     // Get cell coordinates/geometry
-    auto x_dofs = x_dofmap.links(c);
-    for (std::size_t i = 0; i < x_dofs.size(); ++i)
-    {
-      std::copy_n(xt::row(x_g, x_dofs[i]).begin(), 3,
-                  std::next(coordinate_dofs.begin(), 3 * i));
-    }
+    const double* coordinate_dofs_c = get_cell_coordinates(
+        x_cache, x_dofmap, x_g, c, xtl::span<double>(coordinate_dofs));
 
     // Tabulate tensor
     std::fill(Ae.begin(), Ae.end(), 0);
     kernel(Ae.data(), coeffs.data() + c * cstride, constants.data(),
-           coordinate_dofs.data(), nullptr, nullptr);
+           coordinate_dofs_c, nullptr, nullptr);
 
     dof_transform(_Ae, cell_info, c, ndim1);
     dof_transform_to_transpose(_Ae, cell_info, c, ndim0);
@@ -93,49 +213,102 @@ void assemble_cells(
     // Zero rows/columns for essential bcs
     auto dofs0 = dofmap0.links(c);
     auto dofs1 = dofmap1.links(c);
-    if (!bc0.empty())
-    {
-      for (int i = 0; i < num_dofs0; ++i)
-      {
-        for (int k = 0; k < bs0; ++k)
-        {
-          if (bc0[bs0 * dofs0[i] + k])
-          {
-            // Zero row bs0 * i + k
-            const int row = bs0 * i + k;
-            std::fill_n(std::next(Ae.begin(), ndim1 * row), ndim1, 0.0);
-          }
-        }
-      }
-    }
+    zero_bc_rows_cols<T, _bs0, _bs1>(_Ae, dofs0, bs0, dofs1, bs1, bc0, bc1);
+
+    mat_set(dofs0.size(), dofs0.data(), dofs1.size(), dofs1.data(), Ae.data());
+  }
+}
+
+/// Execute a batched kernel over cells and accumulate result in matrix.
+/// The kernel computes the element tensors for `batch_size` cells per
+/// call, with the geometry, coefficients and element tensors of the
+/// cells in a batch interleaved (see impl::gather_cell_batch).
+/// @tparam _bs0 The block size of the row dofmap. If positive, the
+/// block size is used as a compile-time constant.
+/// @tparam _bs1 The block size of the column dofmap. If positive, the
+/// block size is used as a compile-time constant.
+/// @tparam U The insertion function type. It is called as
+/// `mat_set(num_rows, rows, num_cols, cols, Ae)`.
+/// @tparam K The kernel type
+template <typename T, int _bs0 = -1, int _bs1 = -1, typename U, typename K>
+void assemble_cells_batched(
+    const U& mat_set, const mesh::Geometry& geometry,
+    const xtl::span<const std::int32_t>& cells,
+    const std::function<void(const xtl::span<T>&,
+                             const xtl::span<const std::uint32_t>&,
+                             std::int32_t, int)>& dof_transform,
+    const graph::AdjacencyList<std::int32_t>& dofmap0, const int bs0,
+    const std::function<void(const xtl::span<T>&,
+                             const xtl::span<const std::uint32_t>&,
+                             std::int32_t, int)>& dof_transform_to_transpose,
+    const graph::AdjacencyList<std::int32_t>& dofmap1, const int bs1,
+    const std::vector<bool>& bc0, const std::vector<bool>& bc1, const K& kernel,
+    int batch_size, const xtl::span<const T>& coeffs, int cstride,
+    const xtl::span<const T>& constants,
+    const xtl::span<const std::uint32_t>& cell_info)
+{
+  if (cells.empty())
+    return;
+
+  // FIXME: Add proper interface for num coordinate dofs
+  const std::size_t num_dofs_g = geometry.dofmap().num_links(0);
+
+  // Create interleaved data structures for a batch of cells
+  const int num_dofs0 = dofmap0.links(0).size();
+  const int num_dofs1 = dofmap1.links(0).size();
+  const int ndim0 = bs0 * num_dofs0;
+  const int ndim1 = bs1 * num_dofs1;
+  std::vector<T> Ae_batch(batch_size * ndim0 * ndim1);
+  std::vector<double> coordinate_dofs(batch_size * 3 * num_dofs_g);
+  std::vector<T> coeffs_batch(batch_size * cstride);
+
+  std::vector<T> Ae(ndim0 * ndim1);
+  const xtl::span<T> _Ae(Ae);
+  for (std::size_t c0 = 0; c0 < cells.size(); c0 += batch_size)
+  {
+    auto batch = cells.subspan(
+        c0, std::min<std::size_t>(batch_size, cells.size() - c0));
+    impl::gather_cell_batch<T>(batch, geometry, coeffs, cstride, batch_size,
+                               xtl::span(coordinate_dofs),
+                               xtl::span(coeffs_batch));
 
-    if (!bc1.empty())
+    // Tabulate tensors for the batch
+    std::fill(Ae_batch.begin(), Ae_batch.end(), 0);
+    kernel(Ae_batch.data(), coeffs_batch.data(), constants.data(),
+           coordinate_dofs.data(), nullptr, nullptr);
+
+    for (std::size_t n = 0; n < batch.size(); ++n)
     {
-      for (int j = 0; j < num_dofs1; ++j)
-      {
-        for (int k = 0; k < bs1; ++k)
-        {
-          if (bc1[bs1 * dofs1[j] + k])
-          {
-            // Zero column bs1 * j + k
-            const int col = bs1 * j + k;
-            for (int row = 0; row < ndim0; ++row)
-              Ae[row * ndim1 + col] = 0.0;
-          }
-        }
-      }
-    }
+      // Extract element tensor for cell n of the batch
+      const std::int32_t c = batch[n];
+      for (std::size_t i = 0; i < Ae.size(); ++i)
+        Ae[i] = Ae_batch[i * batch_size + n];
 
-    mat_set(dofs0.size(), dofs0.data(), dofs1.size(), dofs1.data(), Ae.data());
+      dof_transform(_Ae, cell_info, c, ndim1);
+      dof_transform_to_transpose(_Ae, cell_info, c, ndim0);
+
+      // Zero rows/columns for essential bcs
+      auto dofs0 = dofmap0.links(c);
+      auto dofs1 = dofmap1.links(c);
+      zero_bc_rows_cols<T, _bs0, _bs1>(_Ae, dofs0, bs0, dofs1, bs1, bc0, bc1);
+
+      mat_set(dofs0.size(), dofs0.data(), dofs1.size(), dofs1.data(),
+              Ae.data());
+    }
   }
 }
 
 /// Execute kernel over exterior facets and  accumulate result in Mat
-template <typename T>
+/// @tparam _bs0 The block size of the row dofmap. If positive, the
+/// block size is used as a compile-time constant.
+/// @tparam _bs1 The block size of the column dofmap. If positive, the
+/// block size is used as a compile-time constant.
+/// @tparam U The insertion function type. It is called as
+/// `mat_set(num_rows, rows, num_cols, cols, Ae)`.
+/// @tparam K The kernel type
+template <typename T, int _bs0 = -1, int _bs1 = -1, typename U, typename K>
 void assemble_exterior_facets(
-    const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
-                            const std::int32_t*, const T*)>& mat_set,
-    const mesh::Mesh& mesh,
+    const U& mat_set, const mesh::Mesh& mesh,
     const xtl::span<const std::pair<std::int32_t, int>>& facets,
     const std::function<void(const xtl::span<T>&,
                              const xtl::span<const std::uint32_t>&,
@@ -145,9 +318,7 @@ void assemble_exterior_facets(
                              const xtl::span<const std::uint32_t>&,
                              std::int32_t, int)>& dof_transform_to_transpose,
     const graph::AdjacencyList<std::int32_t>& dofmap1, int bs1,
-    const std::vector<bool>& bc0, const std::vector<bool>& bc1,
-    const std::function<void(T*, const T*, const T*, const double*, const int*,
-                             const std::uint8_t*)>& kernel,
+    const std::vector<bool>& bc0, const std::vector<bool>& bc1, const K& kernel,
     const xtl::span<const T>& coeffs, int cstride,
     const xtl::span<const T>& constants,
     const xtl::span<const std::uint32_t>& cell_info,
@@ -161,6 +332,7 @@ void assemble_exterior_facets(
   // FIXME: Add proper interface for num coordinate dofs
   const std::size_t num_dofs_g = x_dofmap.num_links(0);
   const xt::xtensor<double, 2>& x_g = mesh.geometry().x();
+  const xtl::span<const double> x_cache = mesh.geometry().cell_coordinates();
 
   const int num_cell_facets
       = mesh::cell_num_entities(mesh.topology().cell_type(), tdim - 1);
@@ -180,18 +352,14 @@ void assemble_exterior_facets(
     int local_facet = facet.second;
 
     // Get cell coordinates/geometry
-    auto x_dofs = x_dofmap.links(cell);
-    for (std::size_t i = 0; i < x_dofs.size(); ++i)
-    {
-      std::copy_n(xt::row(x_g, x_dofs[i]).begin(), 3,
-                  std::next(coordinate_dofs.begin(), 3 * i));
-    }
+    const double* coordinate_dofs_c = get_cell_coordinates(
+        x_cache, x_dofmap, x_g, cell, xtl::span<double>(coordinate_dofs));
 
     // Tabulate tensor
     std::uint8_t perm = get_perm(cell * num_cell_facets + local_facet);
     std::fill(Ae.begin(), Ae.end(), 0);
     kernel(Ae.data(), coeffs.data() + cell * cstride, constants.data(),
-           coordinate_dofs.data(), &local_facet, &perm);
+           coordinate_dofs_c, &local_facet, &perm);
 
     dof_transform(_Ae, cell_info, cell, ndim1);
     dof_transform_to_transpose(_Ae, cell_info, cell, ndim0);
@@ -199,48 +367,23 @@ void assemble_exterior_facets(
     // Zero rows/columns for essential bcs
     auto dofs0 = dofmap0.links(cell);
     auto dofs1 = dofmap1.links(cell);
-    if (!bc0.empty())
-    {
-      for (int i = 0; i < num_dofs0; ++i)
-      {
-        for (int k = 0; k < bs0; ++k)
-        {
-          if (bc0[bs0 * dofs0[i] + k])
-          {
-            // Zero row bs0 * i + k
-            const int row = bs0 * i + k;
-            std::fill_n(std::next(Ae.begin(), ndim1 * row), ndim1, 0.0);
-          }
-        }
-      }
-    }
-    if (!bc1.empty())
-    {
-      for (int j = 0; j < num_dofs1; ++j)
-      {
-        for (int k = 0; k < bs1; ++k)
-        {
-          if (bc1[bs1 * dofs1[j] + k])
-          {
-            // Zero column bs1 * j + k
-            const int col = bs1 * j + k;
-            for (int row = 0; row < ndim0; ++row)
-              Ae[row * ndim1 + col] = 0.0;
-          }
-        }
-      }
-    }
+    zero_bc_rows_cols<T, _bs0, _bs1>(_Ae, dofs0, bs0, dofs1, bs1, bc0, bc1);
 
     mat_set(dofs0.size(), dofs0.data(), dofs1.size(), dofs1.data(), Ae.data());
   }
 }
 
 /// Execute kernel over interior facets and  accumulate result in Mat
-template <typename T>
+/// @tparam _bs0 The block size of the row dofmap. If positive, the
+/// block size is used as a compile-time constant.
+/// @tparam _bs1 The block size of the column dofmap. If positive, the
+/// block size is used as a compile-time constant.
+/// @tparam U The insertion function type. It is called as
+/// `mat_set(num_rows, rows, num_cols, cols, Ae)`.
+/// @tparam K The kernel type
+template <typename T, int _bs0 = -1, int _bs1 = -1, typename U, typename K>
 void assemble_interior_facets(
-    const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
-                            const std::int32_t*, const T*)>& mat_set,
-    const mesh::Mesh& mesh,
+    const U& mat_set, const mesh::Mesh& mesh,
     const xtl::span<const std::tuple<std::int32_t, int, std::int32_t, int>>&
         facets,
     const std::function<void(const xtl::span<T>&,
@@ -251,9 +394,7 @@ void assemble_interior_facets(
                              const xtl::span<const std::uint32_t>&,
                              std::int32_t, int)>& dof_transform_to_transpose,
     const DofMap& dofmap1, int bs1, const std::vector<bool>& bc0,
-    const std::vector<bool>& bc1,
-    const std::function<void(T*, const T*, const T*, const double*, const int*,
-                             const std::uint8_t*)>& kernel,
+    const std::vector<bool>& bc1, const K& kernel,
     const xtl::span<const T>& coeffs, int cstride,
     const xtl::span<const int>& offsets, const xtl::span<const T>& constants,
     const xtl::span<const std::uint32_t>& cell_info,
@@ -267,9 +408,10 @@ void assemble_interior_facets(
   // FIXME: Add proper interface for num coordinate dofs
   const std::size_t num_dofs_g = x_dofmap.num_links(0);
   const xt::xtensor<double, 2>& x_g = mesh.geometry().x();
+  const xtl::span<const double> x_cache = mesh.geometry().cell_coordinates();
 
   // Data structures used in assembly
-  xt::xtensor<double, 3> coordinate_dofs({2, num_dofs_g, 3});
+  std::vector<double> coordinate_dofs(2 * 3 * num_dofs_g);
   std::vector<T> Ae, be;
   std::vector<T> coeff_array(2 * offsets.back());
   assert(offsets.back() == cstride);
@@ -288,18 +430,8 @@ void assemble_interior_facets(
         = {std::get<1>(facet), std::get<3>(facet)};
 
     // Get cell geometry
-    auto x_dofs0 = x_dofmap.links(cells[0]);
-    for (std::size_t i = 0; i < x_dofs0.size(); ++i)
-    {
-      std::copy_n(xt::view(x_g, x_dofs0[i]).begin(), 3,
-                  xt::view(coordinate_dofs, 0, i, xt::all()).begin());
-    }
-    auto x_dofs1 = x_dofmap.links(cells[1]);
-    for (std::size_t i = 0; i < x_dofs1.size(); ++i)
-    {
-      std::copy_n(xt::view(x_g, x_dofs1[i]).begin(), 3,
-                  xt::view(coordinate_dofs, 1, i, xt::all()).begin());
-    }
+    get_cell_pair_coordinates(x_cache, x_dofmap, x_g, cells,
+                              xtl::span<double>(coordinate_dofs));
 
     // Get dof maps for cells and pack
     xtl::span<const std::int32_t> dmap0_cell0 = dofmap0.cell_dofs(cells[0]);
@@ -365,53 +497,111 @@ void assemble_interior_facets(
     dof_transform_to_transpose(sub_Ae1, cell_info, cells[1], num_rows);
 
     // Zero rows/columns for essential bcs
-    if (!bc0.empty())
-    {
-      for (std::size_t i = 0; i < dmapjoint0.size(); ++i)
-      {
-        for (int k = 0; k < bs0; ++k)
-        {
-          if (bc0[bs0 * dmapjoint0[i] + k])
-          {
-            // Zero row bs0 * i + k
-            std::fill_n(std::next(Ae.begin(), num_cols * (bs0 * i + k)),
-                        num_cols, 0.0);
-          }
-        }
-      }
-    }
-    if (!bc1.empty())
-    {
-      for (std::size_t j = 0; j < dmapjoint1.size(); ++j)
-      {
-        for (int k = 0; k < bs1; ++k)
-        {
-          if (bc1[bs1 * dmapjoint1[j] + k])
-          {
-            // Zero column bs1 * j + k
-            for (int m = 0; m < num_rows; ++m)
-              Ae[m * num_cols + bs1 * j + k] = 0.0;
-          }
-        }
-      }
-    }
+    zero_bc_rows_cols<T, _bs0, _bs1>(_Ae, dmapjoint0, bs0, dmapjoint1, bs1,
+                                     bc0, bc1);
 
     mat_set(dmapjoint0.size(), dmapjoint0.data(), dmapjoint1.size(),
             dmapjoint1.data(), Ae.data());
   }
 }
 
-template <typename T>
+/// Execute kernel over interior facets using precomputed facet data
+/// and accumulate result in Mat
+/// @tparam _bs0 The block size of the row dofmap. If positive, the
+/// block size is used as a compile-time constant.
+/// @tparam _bs1 The block size of the column dofmap. If positive, the
+/// block size is used as a compile-time constant.
+/// @tparam U The insertion function type. It is called as
+/// `mat_set(num_rows, rows, num_cols, cols, Ae)`.
+/// @tparam K The kernel type
+/// @param[in] facets Positions of the facets to assemble in `table`
+template <typename T, int _bs0 = -1, int _bs1 = -1, typename U, typename K>
+void assemble_interior_facets(
+    const U& mat_set, const mesh::Geometry& geometry,
+    const InteriorFacetTable& table,
+    const xtl::span<const std::int32_t>& facets,
+    const std::function<void(const xtl::span<T>&,
+                             const xtl::span<const std::uint32_t>&,
+                             std::int32_t, int)>& dof_transform,
+    int bs0,
+    const std::function<void(const xtl::span<T>&,
+                             const xtl::span<const std::uint32_t>&,
+                             std::int32_t, int)>& dof_transform_to_transpose,
+    int bs1, const std::vector<bool>& bc0, const std::vector<bool>& bc1,
+    const K& kernel, const xtl::span<const T>& coeffs, int cstride,
+    const xtl::span<const int>& offsets, const xtl::span<const T>& constants,
+    const xtl::span<const std::uint32_t>& cell_info)
+{
+  // Prepare cell geometry
+  const graph::AdjacencyList<std::int32_t>& x_dofmap = geometry.dofmap();
+  const std::size_t num_dofs_g = x_dofmap.num_links(0);
+  const xt::xtensor<double, 2>& x_g = geometry.x();
+  const xtl::span<const double> x_cache = geometry.cell_coordinates();
+
+  // Data structures used in assembly
+  std::vector<double> coordinate_dofs(2 * 3 * num_dofs_g);
+  std::vector<T> Ae;
+  std::vector<T> coeff_array(2 * offsets.back());
+  assert(offsets.back() == cstride);
+
+  const graph::AdjacencyList<std::int32_t>& dofs0 = table.dofs.at(0);
+  const graph::AdjacencyList<std::int32_t>& dofs1 = table.dofs.at(1);
+  for (std::int32_t f : facets)
+  {
+    const std::array<std::int32_t, 2>& cells = table.cells[f];
+    get_cell_pair_coordinates(x_cache, x_dofmap, x_g, cells,
+                              xtl::span<double>(coordinate_dofs));
+    get_cell_pair_coefficients(coeffs, cstride, offsets, cells,
+                               xtl::span<T>(coeff_array));
+
+    // Joint dofs of the two cells
+    xtl::span<const std::int32_t> dmapjoint0 = dofs0.links(f);
+    xtl::span<const std::int32_t> dmapjoint1 = dofs1.links(f);
+    const int num_rows = bs0 * dmapjoint0.size();
+    const int num_cols = bs1 * dmapjoint1.size();
+
+    // Tabulate tensor
+    Ae.resize(num_rows * num_cols);
+    std::fill(Ae.begin(), Ae.end(), 0);
+    kernel(Ae.data(), coeff_array.data(), constants.data(),
+           coordinate_dofs.data(), table.local_facets[f].data(),
+           table.perms[f].data());
+
+    // Apply dof transformations to the blocks of cell 0 and cell 1
+    const xtl::span<T> _Ae(Ae);
+    const xtl::span<T> sub_Ae0
+        = _Ae.subspan(bs0 * table.num_cell_dofs[0] * num_cols);
+    const xtl::span<T> sub_Ae1 = _Ae.subspan(bs1 * table.num_cell_dofs[1]);
+    dof_transform(_Ae, cell_info, cells[0], num_cols);
+    dof_transform(sub_Ae0, cell_info, cells[1], num_cols);
+    dof_transform_to_transpose(_Ae, cell_info, cells[0], num_rows);
+    dof_transform_to_transpose(sub_Ae1, cell_info, cells[1], num_rows);
+
+    // Zero rows/columns for essential bcs
+    zero_bc_rows_cols<T, _bs0, _bs1>(_Ae, dmapjoint0, bs0, dmapjoint1, bs1,
+                                     bc0, bc1);
+
+    mat_set(dmapjoint0.size(), dmapjoint0.data(), dmapjoint1.size(),
+            dmapjoint1.data(), Ae.data());
+  }
+}
+
+template <typename T, typename U>
 void assemble_matrix(
-    const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
-                            const std::int32_t*, const T*)>& mat_set,
-    const Form<T>& a, const xtl::span<const T>& constants,
+    const U& mat_set, const Form<T>& a, const xtl::span<const T>& constants,
     const xtl::span<const T>& coeffs, int cstride, const std::vector<bool>& bc0,
-    const std::vector<bool>& bc1)
+    const std::vector<bool>& bc1, int num_threads)
 {
+  if (num_threads < 1)
+    throw std::runtime_error("Number of threads must be positive.");
+
   std::shared_ptr<const mesh::Mesh> mesh = a.mesh();
   assert(mesh);
 
+  // Build the cell geometry cache (if enabled) before any threads are
+  // launched
+  mesh->geometry().cell_coordinates();
+
   // Get dofmap data
   std::shared_ptr<const fem::DofMap> dofmap0
       = a.function_spaces().at(0)->dofmap();
@@ -448,14 +638,60 @@ void assemble_matrix(
     cell_info = xtl::span(mesh->topology().get_cell_permutation_info());
   }
 
+  // When assembling with more than one thread, entities of the same
+  // colour write to disjoint rows. Insertion into the matrix is
+  // serialised since matrix backends are generally not thread-safe.
+  std::mutex mat_set_mutex;
+  auto mat_set_sync
+      = [&mat_set, &mat_set_mutex](std::int32_t m, const std::int32_t* rows,
+                                   std::int32_t n, const std::int32_t* cols,
+                                   const T* vals)
+  {
+    std::lock_guard<std::mutex> lock(mat_set_mutex);
+    return mat_set(m, rows, n, cols, vals);
+  };
+
   for (int i : a.integral_ids(IntegralType::cell))
   {
-    const auto& fn = a.kernel(IntegralType::cell, i);
+    const int batch_size = a.batch_size(IntegralType::cell, i);
+    auto assemble
+        = [&](const auto& mat_set, const xtl::span<const std::int32_t>& cells)
+    {
+      impl::dispatch_block_sizes(
+          bs0, bs1,
+          [&](auto _bs0, auto _bs1)
+          {
+            constexpr int bs0_c = decltype(_bs0)::value;
+            constexpr int bs1_c = decltype(_bs1)::value;
+            if (batch_size > 0)
+            {
+              const auto& fn = a.batch_kernel(IntegralType::cell, i);
+              impl::assemble_cells_batched<T, bs0_c, bs1_c>(
+                  mat_set, mesh->geometry(), cells, dof_transform, dofs0, bs0,
+                  dof_transform_to_transpose, dofs1, bs1, bc0, bc1, fn,
+                  batch_size, coeffs, cstride, constants, cell_info);
+            }
+            else
+            {
+              const auto& fn = a.kernel(IntegralType::cell, i);
+              impl::assemble_cells<T, bs0_c, bs1_c>(
+                  mat_set, mesh->geometry(), cells, dof_transform, dofs0, bs0,
+                  dof_transform_to_transpose, dofs1, bs1, bc0, bc1, fn, coeffs,
+                  cstride, constants, cell_info);
+            }
+          });
+    };
+
     const std::vector<std::int32_t>& cells = a.cell_domains(i);
-    impl::assemble_cells<T>(mat_set, mesh->geometry(), cells, dof_transform,
-                            dofs0, bs0, dof_transform_to_transpose, dofs1, bs1,
-                            bc0, bc1, fn, coeffs, cstride, constants,
-                            cell_info);
+    if (num_threads > 1)
+    {
+      impl::for_each_colour<std::int32_t>(
+          cells, a.colouring(IntegralType::cell, i), num_threads,
+          [&](const xtl::span<const std::int32_t>& cells)
+          { assemble(mat_set_sync, cells); });
+    }
+    else
+      assemble(mat_set, cells);
   }
 
   if (a.num_integrals(IntegralType::exterior_facet) > 0
@@ -475,25 +711,371 @@ void assemble_matrix(
     for (int i : a.integral_ids(IntegralType::exterior_facet))
     {
       const auto& fn = a.kernel(IntegralType::exterior_facet, i);
+      auto assemble
+          = [&](const auto& mat_set,
+                const xtl::span<const std::pair<std::int32_t, int>>& facets)
+      {
+        impl::dispatch_block_sizes(
+            bs0, bs1,
+            [&](auto _bs0, auto _bs1)
+            {
+              impl::assemble_exterior_facets<T, decltype(_bs0)::value,
+                                             decltype(_bs1)::value>(
+                  mat_set, *mesh, facets, dof_transform, dofs0, bs0,
+                  dof_transform_to_transpose, dofs1, bs1, bc0, bc1, fn, coeffs,
+                  cstride, constants, cell_info, get_perm);
+            });
+      };
+
       const std::vector<std::pair<std::int32_t, int>>& facets
           = a.exterior_facet_domains(i);
-      impl::assemble_exterior_facets<T>(
-          mat_set, *mesh, facets, dof_transform, dofs0, bs0,
-          dof_transform_to_transpose, dofs1, bs1, bc0, bc1, fn, coeffs, cstride,
-          constants, cell_info, get_perm);
+      if (num_threads > 1)
+      {
+        impl::for_each_colour<std::pair<std::int32_t, int>>(
+            facets, a.colouring(IntegralType::exterior_facet, i), num_threads,
+            [&](const xtl::span<const std::pair<std::int32_t, int>>& facets)
+            { assemble(mat_set_sync, facets); });
+      }
+      else
+        assemble(mat_set, facets);
     }
 
     const std::vector<int> c_offsets = a.coefficient_offsets();
     for (int i : a.integral_ids(IntegralType::interior_facet))
     {
       const auto& fn = a.kernel(IntegralType::interior_facet, i);
-      const std::vector<std::tuple<std::int32_t, int, std::int32_t, int>>&
-          facets
-          = a.interior_facet_domains(i);
+      const InteriorFacetTable& table = a.interior_facet_table(i);
+      auto assemble = [&](const auto& mat_set,
+                          const xtl::span<const std::int32_t>& facets)
+      {
+        impl::dispatch_block_sizes(
+            bs0, bs1,
+            [&](auto _bs0, auto _bs1)
+            {
+              impl::assemble_interior_facets<T, decltype(_bs0)::value,
+                                             decltype(_bs1)::value>(
+                  mat_set, mesh->geometry(), table, facets, dof_transform,
+                  bs0, dof_transform_to_transpose, bs1, bc0, bc1, fn, coeffs,
+                  cstride, c_offsets, constants, cell_info);
+            });
+      };
+
+      std::vector<std::int32_t> facets(table.cells.size());
+      std::iota(facets.begin(), facets.end(), 0);
+      if (num_threads > 1)
+      {
+        impl::for_each_colour<std::int32_t>(
+            facets, a.colouring(IntegralType::interior_facet, i), num_threads,
+            [&](const xtl::span<const std::int32_t>& facets)
+            { assemble(mat_set_sync, facets); });
+      }
+      else
+        assemble(mat_set, facets);
+    }
+  }
+}
+
+/// Compute the action y = A u of a bilinear form, with the element
+/// matrices computed on-the-fly and not stored. Rows (bc0) and columns
+/// (bc1) with Dirichlet conditions are zeroed. The ghost update of u
+/// is overlapped with the computation on entities that depend only on
+/// owned entries of u. Contributions to ghost entries of y are sent
+/// to the owner.
+/// @param[out] y The result vector (test space layout). It is zeroed
+/// before the action is computed.
+/// @param[in] a The bilinear form
+/// @param[in,out] u The vector to compute the action on (trial space
+/// layout). Its ghost entries are updated.
+/// @param[in] constants Packed constants that appear in `a`
+/// @param[in] coeffs Packed coefficients that appear in `a`
+/// @param[in] cstride Number of coefficient entries per cell
+/// @param[in] bc0 Boundary condition markers for the rows
+/// @param[in] bc1 Boundary condition markers for the columns
+template <typename T>
+void assemble_action(la::Vector<T>& y, const Form<T>& a, la::Vector<T>& u,
+                     const xtl::span<const T>& constants,
+                     const xtl::span<const T>& coeffs, int cstride,
+                     const std::vector<bool>& bc0,
+                     const std::vector<bool>& bc1)
+{
+  std::shared_ptr<const mesh::Mesh> mesh = a.mesh();
+  assert(mesh);
+
+  // Get dofmap data
+  std::shared_ptr<const fem::DofMap> dofmap0
+      = a.function_spaces().at(0)->dofmap();
+  std::shared_ptr<const fem::DofMap> dofmap1
+      = a.function_spaces().at(1)->dofmap();
+  assert(dofmap0);
+  assert(dofmap1);
+  const graph::AdjacencyList<std::int32_t>& dofs0 = dofmap0->list();
+  const int bs0 = dofmap0->bs();
+  const graph::AdjacencyList<std::int32_t>& dofs1 = dofmap1->list();
+  const int bs1 = dofmap1->bs();
+
+  std::shared_ptr<const fem::FiniteElement> element0
+      = a.function_spaces().at(0)->element();
+  std::shared_ptr<const fem::FiniteElement> element1
+      = a.function_spaces().at(1)->element();
+  const std::function<void(const xtl::span<T>&,
+                           const xtl::span<const std::uint32_t>&, std::int32_t,
+                           int)>& dof_transform
+      = element0->get_dof_transformation_function<T>();
+  const std::function<void(const xtl::span<T>&,
+                           const xtl::span<const std::uint32_t>&, std::int32_t,
+                           int)>& dof_transform_to_transpose
+      = element1->get_dof_transformation_to_transpose_function<T>();
+
+  const bool needs_transformation_data
+      = element0->needs_dof_transformations()
+        or element1->needs_dof_transformations()
+        or a.needs_facet_permutations();
+  xtl::span<const std::uint32_t> cell_info;
+  if (needs_transformation_data)
+  {
+    mesh->topology_mutable().create_entity_permutations();
+    cell_info = xtl::span(mesh->topology().get_cell_permutation_info());
+  }
+
+  std::function<std::uint8_t(std::size_t)> get_perm;
+  if (a.needs_facet_permutations())
+  {
+    mesh->topology_mutable().create_entity_permutations();
+    const std::vector<std::uint8_t>& perms
+        = mesh->topology().get_facet_permutations();
+    get_perm = [&perms](std::size_t i) { return perms[i]; };
+  }
+  else
+    get_perm = [](std::size_t) { return 0; };
+
+  // Compute y_e += A_e u_e in place of inserting A_e into a matrix
+  std::fill(y.mutable_array().begin(), y.mutable_array().end(), 0);
+  xtl::span<T> _y = y.mutable_array();
+  xtl::span<const T> _u = u.array();
+  auto mat_action = [&_y, &_u, bs0, bs1](std::int32_t m,
+                                         const std::int32_t* rows,
+                                         std::int32_t n,
+                                         const std::int32_t* cols,
+                                         const T* Ae) -> int
+  {
+    const int ncols = bs1 * n;
+    for (int i = 0; i < m; ++i)
+    {
+      for (int k0 = 0; k0 < bs0; ++k0)
+      {
+        const T* Ae_row = Ae + (bs0 * i + k0) * ncols;
+        T sum = 0;
+        for (int j = 0; j < n; ++j)
+          for (int k1 = 0; k1 < bs1; ++k1)
+            sum += Ae_row[bs1 * j + k1] * _u[bs1 * cols[j] + k1];
+        _y[bs0 * rows[i] + k0] += sum;
+      }
+    }
+    return 0;
+  };
+
+  // Returns true if the cell depends only on owned entries of u
+  const std::int32_t num_owned1
+      = dofmap1->index_map_bs() * dofmap1->index_map->size_local();
+  auto owned = [&dofs1, bs1, num_owned1](std::int32_t c)
+  {
+    auto dofs = dofs1.links(c);
+    return std::all_of(dofs.begin(), dofs.end(),
+                       [bs1, num_owned1](std::int32_t dof)
+                       { return bs1 * dof < num_owned1; });
+  };
+
+  // Split entities of each integral into entities that depend only on
+  // owned entries of u, and entities that depend on ghost entries
+  std::map<int, std::array<std::vector<std::int32_t>, 2>> cells;
+  for (int i : a.integral_ids(IntegralType::cell))
+  {
+    for (std::int32_t c : a.cell_domains(i))
+      cells[i][owned(c) ? 0 : 1].push_back(c);
+  }
+
+  std::map<int, std::array<std::vector<std::pair<std::int32_t, int>>, 2>>
+      exterior_facets;
+  for (int i : a.integral_ids(IntegralType::exterior_facet))
+  {
+    for (auto& facet : a.exterior_facet_domains(i))
+      exterior_facets[i][owned(facet.first) ? 0 : 1].push_back(facet);
+  }
+
+  std::map<int, std::array<std::vector<std::tuple<std::int32_t, int,
+                                                  std::int32_t, int>>,
+                           2>>
+      interior_facets;
+  for (int i : a.integral_ids(IntegralType::interior_facet))
+  {
+    for (auto& facet : a.interior_facet_domains(i))
+    {
+      const bool is_owned
+          = owned(std::get<0>(facet)) and owned(std::get<2>(facet));
+      interior_facets[i][is_owned ? 0 : 1].push_back(facet);
+    }
+  }
+
+  const std::vector<int> c_offsets = a.coefficient_offsets();
+  auto assemble = [&](int pass)
+  {
+    for (auto& [i, entities] : cells)
+    {
+      impl::assemble_cells<T>(
+          mat_action, mesh->geometry(), entities[pass], dof_transform, dofs0,
+          bs0, dof_transform_to_transpose, dofs1, bs1, bc0, bc1,
+          a.kernel(IntegralType::cell, i), coeffs, cstride, constants,
+          cell_info);
+    }
+
+    for (auto& [i, entities] : exterior_facets)
+    {
+      impl::assemble_exterior_facets<T>(
+          mat_action, *mesh, entities[pass], dof_transform, dofs0, bs0,
+          dof_transform_to_transpose, dofs1, bs1, bc0, bc1,
+          a.kernel(IntegralType::exterior_facet, i), coeffs, cstride,
+          constants, cell_info, get_perm);
+    }
+
+    for (auto& [i, entities] : interior_facets)
+    {
       impl::assemble_interior_facets<T>(
-          mat_set, *mesh, facets, dof_transform, *dofmap0, bs0,
-          dof_transform_to_transpose, *dofmap1, bs1, bc0, bc1, fn, coeffs,
-          cstride, c_offsets, constants, cell_info, get_perm);
+          mat_action, *mesh, entities[pass], dof_transform, *dofmap0, bs0,
+          dof_transform_to_transpose, *dofmap1, bs1, bc0, bc1,
+          a.kernel(IntegralType::interior_facet, i), coeffs, cstride,
+          c_offsets, constants, cell_info, get_perm);
+    }
+  };
+
+  // Overlap ghost update of u with computation on entities that depend
+  // only on owned entries of u
+  u.scatter_fwd_begin();
+  assemble(0);
+  u.scatter_fwd_end();
+  assemble(1);
+
+  // Send ghost contributions to owner
+  y.scatter_rev(common::IndexMap::Mode::add);
+}
+
+/// Re-assemble the cell integrals of a bilinear form on a subset of
+/// cells. For each cell, the element matrix stored in `cache` is
+/// subtracted and the newly computed element matrix is added, and the
+/// cache is updated. Cells with no stored element matrix are treated as
+/// having a zero previous contribution, so passing all cells with an
+/// empty cache performs a full assembly and populates the cache.
+/// @param[in] mat_set The function for adding values into the matrix
+/// @param[in] a The bilinear form. It must contain cell integrals only.
+/// @param[in] cells The cells to re-assemble (local to process)
+/// @param[in] constants Packed constants that appear in `a`
+/// @param[in] coeffs Packed coefficients that appear in `a`
+/// @param[in] cstride Number of coefficient entries per cell
+/// @param[in] bc0 Boundary condition markers for the rows
+/// @param[in] bc1 Boundary condition markers for the columns
+/// @param[in,out] cache The element matrices from the previous
+/// assembly
+template <typename T, typename U>
+void reassemble_matrix(
+    const U& mat_set, const Form<T>& a,
+    const xtl::span<const std::int32_t>& cells,
+    const xtl::span<const T>& constants, const xtl::span<const T>& coeffs,
+    int cstride, const std::vector<bool>& bc0, const std::vector<bool>& bc1,
+    ElementTensorCache<T>& cache)
+{
+  if (a.num_integrals(IntegralType::exterior_facet) > 0
+      or a.num_integrals(IntegralType::interior_facet) > 0)
+  {
+    throw std::runtime_error(
+        "Incremental re-assembly supports cell integrals only.");
+  }
+
+  std::shared_ptr<const mesh::Mesh> mesh = a.mesh();
+  assert(mesh);
+
+  // Get dofmap data
+  std::shared_ptr<const fem::DofMap> dofmap0
+      = a.function_spaces().at(0)->dofmap();
+  std::shared_ptr<const fem::DofMap> dofmap1
+      = a.function_spaces().at(1)->dofmap();
+  assert(dofmap0);
+  assert(dofmap1);
+  const graph::AdjacencyList<std::int32_t>& dofs0 = dofmap0->list();
+  const int bs0 = dofmap0->bs();
+  const graph::AdjacencyList<std::int32_t>& dofs1 = dofmap1->list();
+  const int bs1 = dofmap1->bs();
+
+  std::shared_ptr<const fem::FiniteElement> element0
+      = a.function_spaces().at(0)->element();
+  std::shared_ptr<const fem::FiniteElement> element1
+      = a.function_spaces().at(1)->element();
+  const std::function<void(const xtl::span<T>&,
+                           const xtl::span<const std::uint32_t>&, std::int32_t,
+                           int)>& dof_transform
+      = element0->get_dof_transformation_function<T>();
+  const std::function<void(const xtl::span<T>&,
+                           const xtl::span<const std::uint32_t>&, std::int32_t,
+                           int)>& dof_transform_to_transpose
+      = element1->get_dof_transformation_to_transpose_function<T>();
+
+  xtl::span<const std::uint32_t> cell_info;
+  if (element0->needs_dof_transformations()
+      or element1->needs_dof_transformations())
+  {
+    mesh->topology_mutable().create_entity_permutations();
+    cell_info = xtl::span(mesh->topology().get_cell_permutation_info());
+  }
+
+  // Prepare cell geometry
+  const mesh::Geometry& geometry = mesh->geometry();
+  const graph::AdjacencyList<std::int32_t>& x_dofmap = geometry.dofmap();
+  const std::size_t num_dofs_g = x_dofmap.num_links(0);
+  const xt::xtensor<double, 2>& x_g = geometry.x();
+  const xtl::span<const double> x_cache = geometry.cell_coordinates();
+
+  // Sort the modified cells so that they can be intersected with the
+  // (sorted) integration domains
+  std::vector<std::int32_t> modified(cells.begin(), cells.end());
+  std::sort(modified.begin(), modified.end());
+  modified.erase(std::unique(modified.begin(), modified.end()),
+                 modified.end());
+
+  const int ndim0 = bs0 * dofs0.links(0).size();
+  const int ndim1 = bs1 * dofs1.links(0).size();
+  std::vector<T> Ae(ndim0 * ndim1);
+  const xtl::span<T> _Ae(Ae);
+  std::vector<double> coordinate_dofs(3 * num_dofs_g);
+  std::vector<std::int32_t> active_cells;
+  for (int i : a.integral_ids(IntegralType::cell))
+  {
+    const std::vector<std::int32_t>& domain = a.cell_domains(i);
+    active_cells.clear();
+    std::set_intersection(domain.begin(), domain.end(), modified.begin(),
+                          modified.end(), std::back_inserter(active_cells));
+
+    const auto& kernel = a.kernel(IntegralType::cell, i);
+    for (std::int32_t c : active_cells)
+    {
+      // Compute the new element matrix
+      const double* coordinate_dofs_c = get_cell_coordinates(
+          x_cache, x_dofmap, x_g, c, xtl::span<double>(coordinate_dofs));
+      std::fill(Ae.begin(), Ae.end(), 0);
+      kernel(Ae.data(), coeffs.data() + c * cstride, constants.data(),
+             coordinate_dofs_c, nullptr, nullptr);
+      dof_transform(_Ae, cell_info, c, ndim1);
+      dof_transform_to_transpose(_Ae, cell_info, c, ndim0);
+      auto dofs0_c = dofs0.links(c);
+      auto dofs1_c = dofs1.links(c);
+      zero_bc_rows_cols<T>(_Ae, dofs0_c, bs0, dofs1_c, bs1, bc0, bc1);
+
+      // Replace the stored element matrix for cell c by the new one
+      // and add the difference to the matrix
+      std::vector<T>& Ae0 = cache(i, c);
+      Ae0.resize(Ae.size(), 0);
+      std::swap_ranges(Ae.begin(), Ae.end(), Ae0.begin());
+      std::transform(Ae0.begin(), Ae0.end(), Ae.begin(), Ae.begin(),
+                     std::minus<T>());
+      mat_set(dofs0_c.size(), dofs0_c.data(), dofs1_c.size(), dofs1_c.data(),
+              Ae.data());
     }
   }
 }
@@ -14,6 +14,7 @@
 #include <dolfinx/mesh/Geometry.h>
 #include <dolfinx/mesh/Mesh.h>
 #include <dolfinx/mesh/Topology.h>
+#include <algorithm>
 #include <memory>
 #include <vector>
 
@@ -21,13 +22,16 @@ namespace dolfinx::fem::impl
 {
 
 /// Assemble functional over cells
+/// If contributions is not null, the contribution of each entity is
+/// appended to it and the returned value is zero.
 template <typename T>
 T assemble_cells(const mesh::Geometry& geometry,
                  const xtl::span<const std::int32_t>& cells,
                  const std::function<void(T*, const T*, const T*, const double*,
                                           const int*, const std::uint8_t*)>& fn,
                  const xtl::span<const T>& constants,
-                 const xtl::span<const T>& coeffs, int cstride)
+                 const xtl::span<const T>& coeffs, int cstride,
+                 std::vector<T>* contributions = nullptr)
 {
   // Prepare cell geometry
   const graph::AdjacencyList<std::int32_t>& x_dofmap = geometry.dofmap();
@@ -35,6 +39,7 @@ T assemble_cells(const mesh::Geometry& geometry,
   // FIXME: Add proper interface for num coordinate dofs
   const std::size_t num_dofs_g = x_dofmap.num_links(0);
   const xt::xtensor<double, 2>& x_g = geometry.x();
+  const xtl::span<const double> x_cache = geometry.cell_coordinates();
 
   // Create data structures used in assembly
   std::vector<double> coordinate_dofs(3 * num_dofs_g);
@@ -44,22 +49,20 @@ T assemble_cells(const mesh::Geometry& geometry,
   for (std::int32_t c : cells)
   {
     // Get cell coordinates/geometry
-    auto x_dofs = x_dofmap.links(c);
-    for (std::size_t i = 0; i < x_dofs.size(); ++i)
-    {
-      std::copy_n(xt::row(x_g, x_dofs[i]).begin(), 3,
-                  std::next(coordinate_dofs.begin(), 3 * i));
-    }
+    const double* coordinate_dofs_c = get_cell_coordinates(
+        x_cache, x_dofmap, x_g, c, xtl::span<double>(coordinate_dofs));
 
     const T* coeff_cell = coeffs.data() + c * cstride;
-    fn(&value, coeff_cell, constants.data(), coordinate_dofs.data(), nullptr,
-       nullptr);
+    T* v = contributions ? &contributions->emplace_back(0) : &value;
+    fn(v, coeff_cell, constants.data(), coordinate_dofs_c, nullptr, nullptr);
   }
 
   return value;
 }
 
 /// Execute kernel over exterior facets and accumulate result
+/// If contributions is not null, the contribution of each entity is
+/// appended to it and the returned value is zero.
 template <typename T>
 T assemble_exterior_facets(
     const mesh::Mesh& mesh,
@@ -67,7 +70,8 @@ T assemble_exterior_facets(
     const std::function<void(T*, const T*, const T*, const double*, const int*,
                              const std::uint8_t*)>& fn,
     const xtl::span<const T>& constants, const xtl::span<const T>& coeffs,
-    int cstride, const xtl::span<const std::uint8_t>& perms)
+    int cstride, const xtl::span<const std::uint8_t>& perms,
+    std::vector<T>* contributions = nullptr)
 {
   const int tdim = mesh.topology().dim();
 
@@ -77,6 +81,7 @@ T assemble_exterior_facets(
   // FIXME: Add proper interface for num coordinate dofs
   const std::size_t num_dofs_g = x_dofmap.num_links(0);
   const xt::xtensor<double, 2>& x_g = mesh.geometry().x();
+  const xtl::span<const double> x_cache = mesh.geometry().cell_coordinates();
 
   const int num_cell_facets
       = mesh::cell_num_entities(mesh.topology().cell_type(), tdim - 1);
@@ -92,22 +97,24 @@ T assemble_exterior_facets(
     int local_facet = facet.second;
 
     // Get cell coordinates/geometry
-    auto x_dofs = x_dofmap.links(cell);
-    for (std::size_t i = 0; i < x_dofs.size(); ++i)
-    {
-      std::copy_n(xt::row(x_g, x_dofs[i]).begin(), 3,
-                  std::next(coordinate_dofs.begin(), 3 * i));
-    }
+    const double* coordinate_dofs_c = get_cell_coordinates(
+        x_cache, x_dofmap, x_g, cell, xtl::span<double>(coordinate_dofs));
 
     const T* coeff_cell = coeffs.data() + cell * cstride;
-    fn(&value, coeff_cell, constants.data(), coordinate_dofs.data(),
-       &local_facet, &perms[cell * num_cell_facets + local_facet]);
+    T* v = contributions ? &contributions->emplace_back(0) : &value;
+    fn(v, coeff_cell, constants.data(), coordinate_dofs_c, &local_facet,
+       &perms[cell * num_cell_facets + local_facet]);
   }
 
   return value;
 }
 
 /// Assemble functional over interior facets
+/// If contributions is not null, the contribution of each entity is
+/// appended to it and the returned value is zero. The two cells of
+/// each facet are then ordered by the input global indices of their
+/// geometry nodes, so the restrictions do not depend on the mesh
+/// partitioning.
 template <typename T>
 T assemble_interior_facets(
     const mesh::Mesh& mesh,
@@ -117,7 +124,8 @@ T assemble_interior_facets(
                              const std::uint8_t*)>& fn,
     const xtl::span<const T>& constants, const xtl::span<const T>& coeffs,
     int cstride, const xtl::span<const int>& offsets,
-    const xtl::span<const std::uint8_t>& perms)
+    const xtl::span<const std::uint8_t>& perms,
+    std::vector<T>* contributions = nullptr)
 {
   const int tdim = mesh.topology().dim();
 
@@ -127,38 +135,53 @@ T assemble_interior_facets(
   // FIXME: Add proper interface for num coordinate dofs
   const std::size_t num_dofs_g = x_dofmap.num_links(0);
   const xt::xtensor<double, 2>& x_g = mesh.geometry().x();
+  const xtl::span<const double> x_cache = mesh.geometry().cell_coordinates();
 
   // Create data structures used in assembly
-  xt::xtensor<double, 3> coordinate_dofs({2, num_dofs_g, 3});
+  std::vector<double> coordinate_dofs(2 * 3 * num_dofs_g);
   std::vector<T> coeff_array(2 * offsets.back());
   assert(offsets.back() == cstride);
 
   const int num_cell_facets
       = mesh::cell_num_entities(mesh.topology().cell_type(), tdim - 1);
 
+  // Input global indices of the geometry nodes, used to order the two
+  // cells of a facet independently of the mesh partitioning when the
+  // contributions are collected
+  const std::vector<std::int64_t>& input_indices
+      = mesh.geometry().input_global_indices();
+  std::array<std::vector<std::int64_t>, 2> cell_keys;
+
   // Iterate over all facets
   T value = 0;
   for (auto& facet : facets)
   {
-    const std::array<std::int32_t, 2> cells
+    std::array<std::int32_t, 2> cells
         = {std::get<0>(facet), std::get<2>(facet)};
-    const std::array<int, 2> local_facet
-        = {std::get<1>(facet), std::get<3>(facet)};
-
-    // Get cell geometry
-    auto x_dofs0 = x_dofmap.links(cells[0]);
-    for (std::size_t i = 0; i < x_dofs0.size(); ++i)
-    {
-      std::copy_n(xt::view(x_g, x_dofs0[i]).begin(), 3,
-                  xt::view(coordinate_dofs, 0, i, xt::all()).begin());
-    }
-    auto x_dofs1 = x_dofmap.links(cells[1]);
-    for (std::size_t i = 0; i < x_dofs1.size(); ++i)
+    std::array<int, 2> local_facet = {std::get<1>(facet), std::get<3>(facet)};
+    if (contributions)
     {
-      std::copy_n(xt::view(x_g, x_dofs1[i]).begin(), 3,
-                  xt::view(coordinate_dofs, 1, i, xt::all()).begin());
+      // Make the cell with the (lexicographically) smallest sorted
+      // input node indices the first ('+') cell
+      for (int k = 0; k < 2; ++k)
+      {
+        auto x_dofs = x_dofmap.links(cells[k]);
+        cell_keys[k].resize(x_dofs.size());
+        std::transform(x_dofs.begin(), x_dofs.end(), cell_keys[k].begin(),
+                       [&input_indices](auto d) { return input_indices[d]; });
+        std::sort(cell_keys[k].begin(), cell_keys[k].end());
+      }
+      if (cell_keys[1] < cell_keys[0])
+      {
+        std::swap(cells[0], cells[1]);
+        std::swap(local_facet[0], local_facet[1]);
+      }
     }
 
+    // Get cell geometry
+    get_cell_pair_coordinates(x_cache, x_dofmap, x_g, cells,
+                              xtl::span<double>(coordinate_dofs));
+
     // Layout for the restricted coefficients is flattened
     // w[coefficient][restriction][dof]
     const T* coeff_cell0 = coeffs.data() + cells[0] * cstride;
@@ -177,17 +200,21 @@ T assemble_interior_facets(
 
     const std::array perm{perms[cells[0] * num_cell_facets + local_facet[0]],
                           perms[cells[1] * num_cell_facets + local_facet[1]]};
-    fn(&value, coeff_array.data(), constants.data(), coordinate_dofs.data(),
+    T* v = contributions ? &contributions->emplace_back(0) : &value;
+    fn(v, coeff_array.data(), constants.data(), coordinate_dofs.data(),
        local_facet.data(), perm.data());
   }
 
   return value;
 }
 
-/// Assemble functional into an scalar
+/// Assemble functional into an scalar. If @p contributions is not
+/// null, the contribution of each entity is appended to it instead of
+/// being summed, and the returned value is zero.
 template <typename T>
 T assemble_scalar(const fem::Form<T>& M, const xtl::span<const T>& constants,
-                  const xtl::span<const T>& coeffs, int cstride)
+                  const xtl::span<const T>& coeffs, int cstride,
+                  std::vector<T>* contributions = nullptr)
 {
   std::shared_ptr<const mesh::Mesh> mesh = M.mesh();
   assert(mesh);
@@ -198,7 +225,7 @@ T assemble_scalar(const fem::Form<T>& M, const xtl::span<const T>& constants,
     const auto& fn = M.kernel(IntegralType::cell, i);
     const std::vector<std::int32_t>& cells = M.cell_domains(i);
     value += impl::assemble_cells(mesh->geometry(), cells, fn, constants,
-                                  coeffs, cstride);
+                                  coeffs, cstride, contributions);
   }
 
   if (M.num_integrals(IntegralType::exterior_facet) > 0
@@ -214,8 +241,8 @@ T assemble_scalar(const fem::Form<T>& M, const xtl::span<const T>& constants,
       const auto& fn = M.kernel(IntegralType::exterior_facet, i);
       const std::vector<std::pair<std::int32_t, int>>& facets
           = M.exterior_facet_domains(i);
-      value += impl::assemble_exterior_facets(*mesh, facets, fn, constants,
-                                              coeffs, cstride, perms);
+      value += impl::assemble_exterior_facets(
+          *mesh, facets, fn, constants, coeffs, cstride, perms, contributions);
     }
 
     const std::vector<int> c_offsets = M.coefficient_offsets();
@@ -225,8 +252,9 @@ T assemble_scalar(const fem::Form<T>& M, const xtl::span<const T>& constants,
       const std::vector<std::tuple<std::int32_t, int, std::int32_t, int>>&
           facets
           = M.interior_facet_domains(i);
-      value += impl::assemble_interior_facets(
-          *mesh, facets, fn, constants, coeffs, cstride, c_offsets, perms);
+      value += impl::assemble_interior_facets(*mesh, facets, fn, constants,
+                                              coeffs, cstride, c_offsets,
+                                              perms, contributions);
     }
   }
 
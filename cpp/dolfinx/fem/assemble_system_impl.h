@@ -0,0 +1,344 @@
+// Copyright (C) 2021 Garth N. Wells
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "DofMap.h"
+#include "Form.h"
+#include "assemble_matrix_impl.h"
+#include "assemble_vector_impl.h"
+#include "utils.h"
+#include <dolfinx/fem/FunctionSpace.h>
+#include <dolfinx/graph/AdjacencyList.h>
+#include <dolfinx/mesh/Geometry.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/Topology.h>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+namespace dolfinx::fem::impl
+{
+
+/// Execute the bilinear and linear form kernels over cells in a single
+/// pass, and accumulate the results in a matrix and a vector. Dirichlet
+/// conditions are applied symmetrically at the element level: the
+/// contribution of the boundary condition columns is moved to the
+/// right-hand side (lifting), and boundary condition rows and columns
+/// of the matrix are zeroed. The vector entries for boundary condition
+/// rows are not zeroed, as for fem::apply_lifting.
+/// @param[in] kernel_L The linear form kernel. If empty, only the
+/// lifting contribution is added to `b`.
+template <typename T, typename U>
+void assemble_system_cells(
+    const U& mat_set, xtl::span<T> b, const mesh::Geometry& geometry,
+    const xtl::span<const std::int32_t>& cells,
+    const std::function<void(const xtl::span<T>&,
+                             const xtl::span<const std::uint32_t>&,
+                             std::int32_t, int)>& dof_transform,
+    const graph::AdjacencyList<std::int32_t>& dofmap0, int bs0,
+    const std::function<void(const xtl::span<T>&,
+                             const xtl::span<const std::uint32_t>&,
+                             std::int32_t, int)>& dof_transform_to_transpose,
+    const graph::AdjacencyList<std::int32_t>& dofmap1, int bs1,
+    const std::vector<bool>& bc0, const std::vector<bool>& bc1,
+    const xtl::span<const T>& bc_values1,
+    const std::function<void(T*, const T*, const T*, const double*, const int*,
+                             const std::uint8_t*)>& kernel_a,
+    const xtl::span<const T>& constants_a, const xtl::span<const T>& coeffs_a,
+    int cstride_a,
+    const std::function<void(T*, const T*, const T*, const double*, const int*,
+                             const std::uint8_t*)>& kernel_L,
+    const xtl::span<const T>& constants_L, const xtl::span<const T>& coeffs_L,
+    int cstride_L, const xtl::span<const std::uint32_t>& cell_info)
+{
+  // Prepare cell geometry
+  const graph::AdjacencyList<std::int32_t>& x_dofmap = geometry.dofmap();
+  const std::size_t num_dofs_g = x_dofmap.num_links(0);
+  const xt::xtensor<double, 2>& x_g = geometry.x();
+  const xtl::span<const double> x_cache = geometry.cell_coordinates();
+
+  // Iterate over active cells
+  const int num_dofs0 = dofmap0.links(0).size();
+  const int num_dofs1 = dofmap1.links(0).size();
+  const int ndim0 = bs0 * num_dofs0;
+  const int ndim1 = bs1 * num_dofs1;
+  std::vector<T> Ae(ndim0 * ndim1), be(ndim0);
+  const xtl::span<T> _Ae(Ae), _be(be);
+  std::vector<double> coordinate_dofs(3 * num_dofs_g);
+  for (std::int32_t c : cells)
+  {
+    // Get cell coordinates/geometry, shared by both kernels
+    const double* coordinate_dofs_c = get_cell_coordinates(
+        x_cache, x_dofmap, x_g, c, xtl::span<double>(coordinate_dofs));
+
+    // Tabulate element matrix
+    std::fill(Ae.begin(), Ae.end(), 0);
+    kernel_a(Ae.data(), coeffs_a.data() + c * cstride_a, constants_a.data(),
+             coordinate_dofs_c, nullptr, nullptr);
+    dof_transform(_Ae, cell_info, c, ndim1);
+    dof_transform_to_transpose(_Ae, cell_info, c, ndim0);
+
+    // Tabulate element vector
+    std::fill(be.begin(), be.end(), 0);
+    if (kernel_L)
+    {
+      kernel_L(be.data(), coeffs_L.data() + c * cstride_L, constants_L.data(),
+               coordinate_dofs_c, nullptr, nullptr);
+      dof_transform(_be, cell_info, c, 1);
+    }
+
+    // Lift boundary condition columns to the element vector and zero
+    // the columns
+    auto dofs0 = dofmap0.links(c);
+    auto dofs1 = dofmap1.links(c);
+    if (!bc1.empty())
+    {
+      for (int j = 0; j < num_dofs1; ++j)
+      {
+        for (int k = 0; k < bs1; ++k)
+        {
+          const std::int32_t jj = bs1 * dofs1[j] + k;
+          if (bc1[jj])
+          {
+            const T bc = bc_values1[jj];
+            const int col = bs1 * j + k;
+            for (int m = 0; m < ndim0; ++m)
+            {
+              be[m] -= Ae[m * ndim1 + col] * bc;
+              Ae[m * ndim1 + col] = 0.0;
+            }
+          }
+        }
+      }
+    }
+
+    // Zero boundary condition rows of the element matrix
+    if (!bc0.empty())
+    {
+      for (int i = 0; i < num_dofs0; ++i)
+      {
+        for (int k = 0; k < bs0; ++k)
+        {
+          if (bc0[bs0 * dofs0[i] + k])
+          {
+            const int row = bs0 * i + k;
+            std::fill_n(std::next(Ae.begin(), ndim1 * row), ndim1, 0.0);
+          }
+        }
+      }
+    }
+
+    mat_set(dofs0.size(), dofs0.data(), dofs1.size(), dofs1.data(), Ae.data());
+    for (int i = 0; i < num_dofs0; ++i)
+      for (int k = 0; k < bs0; ++k)
+        b[bs0 * dofs0[i] + k] += be[bs0 * i + k];
+  }
+}
+
+/// Assemble a bilinear form into a matrix and a linear form into a
+/// vector, with Dirichlet conditions applied symmetrically. Cell
+/// integrals of `a` and `L` with the same id and the same cells are
+/// computed in a single pass over the cells. Other integrals are
+/// assembled separately.
+/// @param[in] mat_set The function for adding values into the matrix
+/// @param[in,out] b The vector to assemble into. It is not zeroed.
+/// @param[in] a The bilinear form
+/// @param[in] L The linear form. It must have the same test space as
+/// `a`.
+/// @param[in] constants_a Packed constants that appear in `a`
+/// @param[in] coeffs_a Packed coefficients that appear in `a`
+/// @param[in] cstride_a Number of coefficient entries per cell for `a`
+/// @param[in] constants_L Packed constants that appear in `L`
+/// @param[in] coeffs_L Packed coefficients that appear in `L`
+/// @param[in] cstride_L Number of coefficient entries per cell for `L`
+/// @param[in] bc0 Boundary condition markers for the rows
+/// @param[in] bc1 Boundary condition markers for the columns
+/// @param[in] bc_values1 Boundary condition values for the columns
+template <typename T, typename U>
+void assemble_system(
+    const U& mat_set, xtl::span<T> b, const Form<T>& a, const Form<T>& L,
+    const xtl::span<const T>& constants_a, const xtl::span<const T>& coeffs_a,
+    int cstride_a, const xtl::span<const T>& constants_L,
+    const xtl::span<const T>& coeffs_L, int cstride_L,
+    const std::vector<bool>& bc0, const std::vector<bool>& bc1,
+    const xtl::span<const T>& bc_values1)
+{
+  std::shared_ptr<const mesh::Mesh> mesh = a.mesh();
+  assert(mesh);
+  if (L.mesh() != mesh)
+    throw std::runtime_error("Forms in system must use the same mesh.");
+
+  // Get dofmap data
+  std::shared_ptr<const fem::DofMap> dofmap0
+      = a.function_spaces().at(0)->dofmap();
+  std::shared_ptr<const fem::DofMap> dofmap1
+      = a.function_spaces().at(1)->dofmap();
+  assert(dofmap0);
+  assert(dofmap1);
+  if (L.function_spaces().at(0)->dofmap() != dofmap0)
+  {
+    throw std::runtime_error(
+        "Bilinear and linear form must have the same test space.");
+  }
+  const graph::AdjacencyList<std::int32_t>& dofs0 = dofmap0->list();
+  const int bs0 = dofmap0->bs();
+  const graph::AdjacencyList<std::int32_t>& dofs1 = dofmap1->list();
+  const int bs1 = dofmap1->bs();
+
+  std::shared_ptr<const fem::FiniteElement> element0
+      = a.function_spaces().at(0)->element();
+  std::shared_ptr<const fem::FiniteElement> element1
+      = a.function_spaces().at(1)->element();
+  const std::function<void(const xtl::span<T>&,
+                           const xtl::span<const std::uint32_t>&, std::int32_t,
+                           int)>& dof_transform
+      = element0->get_dof_transformation_function<T>();
+  const std::function<void(const xtl::span<T>&,
+                           const xtl::span<const std::uint32_t>&, std::int32_t,
+                           int)>& dof_transform_to_transpose
+      = element1->get_dof_transformation_to_transpose_function<T>();
+
+  const bool needs_transformation_data
+      = element0->needs_dof_transformations()
+        or element1->needs_dof_transformations() or a.needs_facet_permutations()
+        or L.needs_facet_permutations();
+  xtl::span<const std::uint32_t> cell_info;
+  if (needs_transformation_data)
+  {
+    mesh->topology_mutable().create_entity_permutations();
+    cell_info = xtl::span(mesh->topology().get_cell_permutation_info());
+  }
+
+  // Cell integrals of a. The cell integral of L with the same id is
+  // fused with it if both are over the same cells.
+  const std::vector<int> ids_L = L.integral_ids(IntegralType::cell);
+  std::vector<int> fused_ids;
+  for (int i : a.integral_ids(IntegralType::cell))
+  {
+    const auto& kernel_a = a.kernel(IntegralType::cell, i);
+    const std::vector<std::int32_t>& cells = a.cell_domains(i);
+    if (std::find(ids_L.begin(), ids_L.end(), i) != ids_L.end()
+        and L.cell_domains(i) == cells)
+    {
+      const auto& kernel_L = L.kernel(IntegralType::cell, i);
+      assemble_system_cells<T>(
+          mat_set, b, mesh->geometry(), cells, dof_transform, dofs0, bs0,
+          dof_transform_to_transpose, dofs1, bs1, bc0, bc1, bc_values1,
+          kernel_a, constants_a, coeffs_a, cstride_a, kernel_L, constants_L,
+          coeffs_L, cstride_L, cell_info);
+      fused_ids.push_back(i);
+    }
+    else
+    {
+      assemble_system_cells<T>(
+          mat_set, b, mesh->geometry(), cells, dof_transform, dofs0, bs0,
+          dof_transform_to_transpose, dofs1, bs1, bc0, bc1, bc_values1,
+          kernel_a, constants_a, coeffs_a, cstride_a, nullptr, constants_L,
+          coeffs_L, cstride_L, cell_info);
+    }
+  }
+
+  // Cell integrals of L that have not been fused
+  for (int i : ids_L)
+  {
+    if (std::find(fused_ids.begin(), fused_ids.end(), i) == fused_ids.end())
+    {
+      const auto& fn = L.kernel(IntegralType::cell, i);
+      const std::vector<std::int32_t>& cells = L.cell_domains(i);
+      impl::assemble_cells(dof_transform, b, mesh->geometry(), cells, dofs0,
+                           bs0, fn, constants_L, coeffs_L, cstride_L,
+                           cell_info);
+    }
+  }
+
+  // Facet integrals are assembled separately
+  if (a.num_integrals(IntegralType::exterior_facet) > 0
+      or a.num_integrals(IntegralType::interior_facet) > 0
+      or L.num_integrals(IntegralType::exterior_facet) > 0
+      or L.num_integrals(IntegralType::interior_facet) > 0)
+  {
+    std::function<std::uint8_t(std::size_t)> get_perm;
+    if (a.needs_facet_permutations() or L.needs_facet_permutations())
+    {
+      mesh->topology_mutable().create_entity_permutations();
+      const std::vector<std::uint8_t>& perms
+          = mesh->topology().get_facet_permutations();
+      get_perm = [&perms](std::size_t i) { return perms[i]; };
+    }
+    else
+      get_perm = [](std::size_t) { return 0; };
+
+    for (int i : a.integral_ids(IntegralType::exterior_facet))
+    {
+      const auto& fn = a.kernel(IntegralType::exterior_facet, i);
+      const std::vector<std::pair<std::int32_t, int>>& facets
+          = a.exterior_facet_domains(i);
+      impl::assemble_exterior_facets<T>(
+          mat_set, *mesh, facets, dof_transform, dofs0, bs0,
+          dof_transform_to_transpose, dofs1, bs1, bc0, bc1, fn, coeffs_a,
+          cstride_a, constants_a, cell_info, get_perm);
+      if (!bc1.empty())
+      {
+        _lift_bc_exterior_facets(b, *mesh, fn, facets, dof_transform, dofs0,
+                                 bs0, dof_transform_to_transpose, dofs1, bs1,
+                                 constants_a, coeffs_a, cstride_a, cell_info,
+                                 get_perm, bc_values1, bc1,
+                                 xtl::span<const T>(), 1.0);
+      }
+    }
+
+    const std::vector<int> c_offsets_a = a.coefficient_offsets();
+    for (int i : a.integral_ids(IntegralType::interior_facet))
+    {
+      const auto& fn = a.kernel(IntegralType::interior_facet, i);
+      const std::vector<std::tuple<std::int32_t, int, std::int32_t, int>>&
+          facets
+          = a.interior_facet_domains(i);
+      const InteriorFacetTable& table = a.interior_facet_table(i);
+      std::vector<std::int32_t> positions(table.cells.size());
+      std::iota(positions.begin(), positions.end(), 0);
+      impl::assemble_interior_facets<T>(
+          mat_set, mesh->geometry(), table, positions, dof_transform, bs0,
+          dof_transform_to_transpose, bs1, bc0, bc1, fn, coeffs_a, cstride_a,
+          c_offsets_a, constants_a, cell_info);
+      if (!bc1.empty())
+      {
+        _lift_bc_interior_facets(b, *mesh, fn, facets, dof_transform, dofs0,
+                                 bs0, dof_transform_to_transpose, dofs1, bs1,
+                                 constants_a, coeffs_a, cstride_a, c_offsets_a,
+                                 cell_info, get_perm, bc_values1, bc1,
+                                 xtl::span<const T>(), 1.0);
+      }
+    }
+
+    for (int i : L.integral_ids(IntegralType::exterior_facet))
+    {
+      const auto& fn = L.kernel(IntegralType::exterior_facet, i);
+      const std::vector<std::pair<std::int32_t, int>>& facets
+          = L.exterior_facet_domains(i);
+      impl::assemble_exterior_facets(dof_transform, b, *mesh, facets, dofs0,
+                                     bs0, fn, constants_L, coeffs_L, cstride_L,
+                                     cell_info, get_perm);
+    }
+
+    const std::vector<int> c_offsets_L = L.coefficient_offsets();
+    for (int i : L.integral_ids(IntegralType::interior_facet))
+    {
+      const auto& fn = L.kernel(IntegralType::interior_facet, i);
+      const InteriorFacetTable& table = L.interior_facet_table(i);
+      std::vector<std::int32_t> positions(table.cells.size());
+      std::iota(positions.begin(), positions.end(), 0);
+      impl::assemble_interior_facets(dof_transform, b, mesh->geometry(), table,
+                                     positions, bs0, fn, constants_L, coeffs_L,
+                                     cstride_L, c_offsets_L, cell_info);
+    }
+  }
+}
+
+} // namespace dolfinx::fem::impl
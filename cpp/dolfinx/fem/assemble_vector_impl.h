@@ -8,17 +8,21 @@
 
 #include "DirichletBC.h"
 #include "DofMap.h"
+#include "ElementTensorCache.h"
 #include "Form.h"
 #include "utils.h"
 #include <dolfinx/common/IndexMap.h>
 #include <dolfinx/fem/Constant.h>
 #include <dolfinx/fem/FunctionSpace.h>
 #include <dolfinx/graph/AdjacencyList.h>
+#include <dolfinx/la/Vector.h>
 #include <dolfinx/mesh/Geometry.h>
 #include <dolfinx/mesh/Mesh.h>
 #include <dolfinx/mesh/Topology.h>
+#include <algorithm>
 #include <functional>
 #include <memory>
+#include <numeric>
 #include <vector>
 #include <xtensor/xbuilder.hpp>
 #include <xtensor/xtensor.hpp>
@@ -63,6 +67,7 @@ void _lift_bc_cells(
   // FIXME: Add proper interface for num coordinate dofs
   const std::size_t num_dofs_g = x_dofmap.num_links(0);
   const xt::xtensor<double, 2>& x_g = geometry.x();
+  const xtl::span<const double> x_cache = geometry.cell_coordinates();
 
   // Data structures used in bc application
   std::vector<double> coordinate_dofs(3 * num_dofs_g);
@@ -106,12 +111,8 @@ void _lift_bc_cells(
       continue;
 
     // Get cell coordinates/geometry
-    auto x_dofs = x_dofmap.links(c);
-    for (std::size_t i = 0; i < x_dofs.size(); ++i)
-    {
-      std::copy_n(xt::row(x_g, x_dofs[i]).begin(), 3,
-                  std::next(coordinate_dofs.begin(), i * 3));
-    }
+    const double* coordinate_dofs_c = get_cell_coordinates(
+        x_cache, x_dofmap, x_g, c, xtl::span<double>(coordinate_dofs));
 
     // Size data structure for assembly
     auto dmap0 = dofmap0.links(c);
@@ -122,7 +123,7 @@ void _lift_bc_cells(
     const T* coeff_array = coeffs.data() + c * cstride;
     Ae.resize(num_rows * num_cols);
     std::fill(Ae.begin(), Ae.end(), 0);
-    kernel(Ae.data(), coeff_array, constants.data(), coordinate_dofs.data(),
+    kernel(Ae.data(), coeff_array, constants.data(), coordinate_dofs_c,
            nullptr, nullptr);
     dof_transform(Ae, cell_info, c, num_cols);
     dof_transform_to_transpose(Ae, cell_info, c, num_rows);
@@ -220,6 +221,7 @@ void _lift_bc_exterior_facets(
   // FIXME: Add proper interface for num coordinate dofs
   const std::size_t num_dofs_g = x_dofmap.num_links(0);
   const xt::xtensor<double, 2>& x_g = mesh.geometry().x();
+  const xtl::span<const double> x_cache = mesh.geometry().cell_coordinates();
 
   // Data structures used in bc application
   std::vector<double> coordinate_dofs(3 * num_dofs_g);
@@ -251,12 +253,8 @@ void _lift_bc_exterior_facets(
       continue;
 
     // Get cell coordinates/geometry
-    auto x_dofs = x_dofmap.links(cell);
-    for (std::size_t i = 0; i < x_dofs.size(); ++i)
-    {
-      std::copy_n(xt::row(x_g, x_dofs[i]).begin(), 3,
-                  std::next(coordinate_dofs.begin(), 3 * i));
-    }
+    const double* coordinate_dofs_c = get_cell_coordinates(
+        x_cache, x_dofmap, x_g, cell, xtl::span<double>(coordinate_dofs));
 
     // Size data structure for assembly
     auto dmap0 = dofmap0.links(cell);
@@ -268,7 +266,7 @@ void _lift_bc_exterior_facets(
     Ae.resize(num_rows * num_cols);
     std::fill(Ae.begin(), Ae.end(), 0);
     const std::uint8_t perm = get_perm(cell * num_cell_facets + local_facet);
-    kernel(Ae.data(), coeff_array, constants.data(), coordinate_dofs.data(),
+    kernel(Ae.data(), coeff_array, constants.data(), coordinate_dofs_c,
            &local_facet, &perm);
     dof_transform(Ae, cell_info, cell, num_cols);
     dof_transform_to_transpose(Ae, cell_info, cell, num_rows);
@@ -334,12 +332,13 @@ void _lift_bc_interior_facets(
   // FIXME: Add proper interface for num coordinate dofs
   const std::size_t num_dofs_g = x_dofmap.num_links(0);
   const xt::xtensor<double, 2>& x_g = mesh.geometry().x();
+  const xtl::span<const double> x_cache = mesh.geometry().cell_coordinates();
 
   const int num_cell_facets
       = mesh::cell_num_entities(mesh.topology().cell_type(), tdim - 1);
 
   // Data structures used in assembly
-  xt::xtensor<double, 3> coordinate_dofs({2, num_dofs_g, 3});
+  std::vector<double> coordinate_dofs(2 * 3 * num_dofs_g);
   std::vector<T> coeff_array(2 * offsets.back());
   assert(offsets.back() == cstride);
   std::vector<T> Ae, be;
@@ -355,18 +354,8 @@ void _lift_bc_interior_facets(
         = {std::get<1>(facet), std::get<3>(facet)};
 
     // Get cell geometry
-    auto x_dofs0 = x_dofmap.links(cells[0]);
-    for (std::size_t i = 0; i < x_dofs0.size(); ++i)
-    {
-      std::copy_n(xt::view(x_g, x_dofs0[i]).begin(), 3,
-                  xt::view(coordinate_dofs, 0, i, xt::all()).begin());
-    }
-    auto x_dofs1 = x_dofmap.links(cells[1]);
-    for (std::size_t i = 0; i < x_dofs1.size(); ++i)
-    {
-      std::copy_n(xt::view(x_g, x_dofs1[i]).begin(), 3,
-                  xt::view(coordinate_dofs, 1, i, xt::all()).begin());
-    }
+    get_cell_pair_coordinates(x_cache, x_dofmap, x_g, cells,
+                              xtl::span<double>(coordinate_dofs));
 
     // Get dof maps for cells and pack
     const xtl::span<const std::int32_t> dmap0_cell0 = dofmap0.links(cells[0]);
@@ -532,6 +521,7 @@ void assemble_cells(
   // FIXME: Add proper interface for num coordinate dofs
   const int num_dofs_g = x_dofmap.num_links(0);
   const xt::xtensor<double, 2>& x_g = geometry.x();
+  const xtl::span<const double> x_cache = geometry.cell_coordinates();
 
   // FIXME: Add proper interface for num_dofs
   // Create data structures used in assembly
@@ -544,17 +534,13 @@ void assemble_cells(
   for (std::int32_t c : cells)
   {
     // Get cell coordinates/geometry
-    auto x_dofs = x_dofmap.links(c);
-    for (std::size_t i = 0; i < x_dofs.size(); ++i)
-    {
-      std::copy_n(xt::row(x_g, x_dofs[i]).begin(), 3,
-                  std::next(coordinate_dofs.begin(), 3 * i));
-    }
+    const double* coordinate_dofs_c = get_cell_coordinates(
+        x_cache, x_dofmap, x_g, c, xtl::span<double>(coordinate_dofs));
 
     // Tabulate vector for cell
     std::fill(be.begin(), be.end(), 0);
     kernel(be.data(), coeffs.data() + c * cstride, constants.data(),
-           coordinate_dofs.data(), nullptr, nullptr);
+           coordinate_dofs_c, nullptr, nullptr);
     dof_transform(_be, cell_info, c, 1);
 
     // Scatter cell vector to 'global' vector array
@@ -574,6 +560,83 @@ void assemble_cells(
   }
 }
 
+/// Execute a batched kernel over cells and accumulate result in vector.
+/// The kernel computes the element vectors for `batch_size` cells per
+/// call, with the geometry, coefficients and element vectors of the
+/// cells in a batch interleaved (see impl::gather_cell_batch).
+/// @tparam T The scalar type
+/// @tparam _bs The block size of the form test function dof map. If
+/// less than zero the block size is determined at runtime. If `_bs` is
+/// positive the block size is used as a compile-time constant, which
+/// has performance benefits.
+template <typename T, int _bs = -1>
+void assemble_cells_batched(
+    const std::function<void(const xtl::span<T>&,
+                             const xtl::span<const std::uint32_t>&,
+                             std::int32_t, int)>& dof_transform,
+    xtl::span<T> b, const mesh::Geometry& geometry,
+    const xtl::span<const std::int32_t>& cells,
+    const graph::AdjacencyList<std::int32_t>& dofmap, int bs,
+    const std::function<void(T*, const T*, const T*, const double*, const int*,
+                             const std::uint8_t*)>& kernel,
+    int batch_size, const xtl::span<const T>& constants,
+    const xtl::span<const T>& coeffs, int cstride,
+    const xtl::span<const std::uint32_t>& cell_info)
+{
+  assert(_bs < 0 or _bs == bs);
+  if (cells.empty())
+    return;
+
+  // FIXME: Add proper interface for num coordinate dofs
+  const int num_dofs_g = geometry.dofmap().num_links(0);
+
+  // Create interleaved data structures for a batch of cells
+  const int num_dofs = dofmap.links(0).size();
+  std::vector<double> coordinate_dofs(batch_size * 3 * num_dofs_g);
+  std::vector<T> coeffs_batch(batch_size * cstride);
+  std::vector<T> be_batch(batch_size * bs * num_dofs);
+
+  std::vector<T> be(bs * num_dofs);
+  const xtl::span<T> _be(be);
+  for (std::size_t c0 = 0; c0 < cells.size(); c0 += batch_size)
+  {
+    auto batch = cells.subspan(
+        c0, std::min<std::size_t>(batch_size, cells.size() - c0));
+    impl::gather_cell_batch<T>(batch, geometry, coeffs, cstride, batch_size,
+                               xtl::span(coordinate_dofs),
+                               xtl::span(coeffs_batch));
+
+    // Tabulate vectors for the batch
+    std::fill(be_batch.begin(), be_batch.end(), 0);
+    kernel(be_batch.data(), coeffs_batch.data(), constants.data(),
+           coordinate_dofs.data(), nullptr, nullptr);
+
+    for (std::size_t n = 0; n < batch.size(); ++n)
+    {
+      // Extract element vector for cell n of the batch
+      const std::int32_t c = batch[n];
+      for (std::size_t i = 0; i < be.size(); ++i)
+        be[i] = be_batch[i * batch_size + n];
+      dof_transform(_be, cell_info, c, 1);
+
+      // Scatter cell vector to 'global' vector array
+      auto dofs = dofmap.links(c);
+      if constexpr (_bs > 0)
+      {
+        for (int i = 0; i < num_dofs; ++i)
+          for (int k = 0; k < _bs; ++k)
+            b[_bs * dofs[i] + k] += be[_bs * i + k];
+      }
+      else
+      {
+        for (int i = 0; i < num_dofs; ++i)
+          for (int k = 0; k < bs; ++k)
+            b[bs * dofs[i] + k] += be[bs * i + k];
+      }
+    }
+  }
+}
+
 /// Execute kernel over cells and accumulate result in vector
 /// @tparam T The scalar type
 /// @tparam _bs The block size of the form test function dof map. If
@@ -604,6 +667,7 @@ void assemble_exterior_facets(
   // FIXME: Add proper interface for num coordinate dofs
   const std::size_t num_dofs_g = x_dofmap.num_links(0);
   const xt::xtensor<double, 2>& x_g = mesh.geometry().x();
+  const xtl::span<const double> x_cache = mesh.geometry().cell_coordinates();
 
   const int num_cell_facets
       = mesh::cell_num_entities(mesh.topology().cell_type(), tdim - 1);
@@ -621,18 +685,14 @@ void assemble_exterior_facets(
     int local_facet = facet.second;
 
     // Get cell coordinates/geometry
-    auto x_dofs = x_dofmap.links(cell);
-    for (std::size_t i = 0; i < x_dofs.size(); ++i)
-    {
-      std::copy_n(xt::row(x_g, x_dofs[i]).begin(), 3,
-                  std::next(coordinate_dofs.begin(), 3 * i));
-    }
+    const double* coordinate_dofs_c = get_cell_coordinates(
+        x_cache, x_dofmap, x_g, cell, xtl::span<double>(coordinate_dofs));
 
     // Tabulate element vector
     std::fill(be.begin(), be.end(), 0);
     const std::uint8_t perm = get_perm(cell * num_cell_facets + local_facet);
     fn(be.data(), coeffs.data() + cell * cstride, constants.data(),
-       coordinate_dofs.data(), &local_facet, &perm);
+       coordinate_dofs_c, &local_facet, &perm);
 
     dof_transform(_be, cell_info, cell, 1);
 
@@ -683,9 +743,10 @@ void assemble_interior_facets(
   // FIXME: Add proper interface for num coordinate dofs
   const std::size_t num_dofs_g = x_dofmap.num_links(0);
   const xt::xtensor<double, 2>& x_g = mesh.geometry().x();
+  const xtl::span<const double> x_cache = mesh.geometry().cell_coordinates();
 
   // Create data structures used in assembly
-  xt::xtensor<double, 3> coordinate_dofs({2, num_dofs_g, 3});
+  std::vector<double> coordinate_dofs(2 * 3 * num_dofs_g);
   std::vector<T> be;
   std::vector<T> coeff_array(2 * offsets.back());
   assert(offsets.back() == cstride);
@@ -703,18 +764,8 @@ void assemble_interior_facets(
         = {std::get<1>(facet), std::get<3>(facet)};
 
     // Get cell geometry
-    auto x_dofs0 = x_dofmap.links(cells[0]);
-    for (std::size_t i = 0; i < x_dofs0.size(); ++i)
-    {
-      std::copy_n(xt::view(x_g, x_dofs0[i]).begin(), 3,
-                  xt::view(coordinate_dofs, 0, i, xt::all()).begin());
-    }
-    auto x_dofs1 = x_dofmap.links(cells[1]);
-    for (std::size_t i = 0; i < x_dofs1.size(); ++i)
-    {
-      std::copy_n(xt::view(x_g, x_dofs1[i]).begin(), 3,
-                  xt::view(coordinate_dofs, 1, i, xt::all()).begin());
-    }
+    get_cell_pair_coordinates(x_cache, x_dofmap, x_g, cells,
+                              xtl::span<double>(coordinate_dofs));
 
     // Layout for the restricted coefficients is flattened
     // w[coefficient][restriction][dof]
@@ -774,6 +825,75 @@ void assemble_interior_facets(
   }
 }
 
+/// Execute kernel over interior facets using precomputed facet data
+/// and accumulate result in vector
+/// @param[in] facets Positions of the facets to assemble in `table`
+template <typename T, int _bs = -1>
+void assemble_interior_facets(
+    const std::function<void(const xtl::span<T>&,
+                             const xtl::span<const std::uint32_t>&,
+                             std::int32_t, int)>& dof_transform,
+    xtl::span<T> b, const mesh::Geometry& geometry,
+    const InteriorFacetTable& table,
+    const xtl::span<const std::int32_t>& facets, int bs,
+    const std::function<void(T*, const T*, const T*, const double*, const int*,
+                             const std::uint8_t*)>& fn,
+    const xtl::span<const T>& constants, const xtl::span<const T>& coeffs,
+    int cstride, const xtl::span<const int>& offsets,
+    const xtl::span<const std::uint32_t>& cell_info)
+{
+  assert(_bs < 0 or _bs == bs);
+
+  // Prepare cell geometry
+  const graph::AdjacencyList<std::int32_t>& x_dofmap = geometry.dofmap();
+  const std::size_t num_dofs_g = x_dofmap.num_links(0);
+  const xt::xtensor<double, 2>& x_g = geometry.x();
+  const xtl::span<const double> x_cache = geometry.cell_coordinates();
+
+  // Create data structures used in assembly
+  std::vector<double> coordinate_dofs(2 * 3 * num_dofs_g);
+  std::vector<T> be;
+  std::vector<T> coeff_array(2 * offsets.back());
+  assert(offsets.back() == cstride);
+
+  const graph::AdjacencyList<std::int32_t>& dofs = table.dofs.at(0);
+  for (std::int32_t f : facets)
+  {
+    const std::array<std::int32_t, 2>& cells = table.cells[f];
+    get_cell_pair_coordinates(x_cache, x_dofmap, x_g, cells,
+                              xtl::span<double>(coordinate_dofs));
+    get_cell_pair_coefficients(coeffs, cstride, offsets, cells,
+                               xtl::span<T>(coeff_array));
+
+    // Tabulate element vector
+    xtl::span<const std::int32_t> dmap = dofs.links(f);
+    be.resize(bs * dmap.size());
+    std::fill(be.begin(), be.end(), 0);
+    fn(be.data(), coeff_array.data(), constants.data(),
+       coordinate_dofs.data(), table.local_facets[f].data(),
+       table.perms[f].data());
+
+    const xtl::span<T> _be(be);
+    dof_transform(_be, cell_info, cells[0], 1);
+    dof_transform(_be.subspan(bs * table.num_cell_dofs[0]), cell_info,
+                  cells[1], 1);
+
+    // Add element vector to global vector
+    if constexpr (_bs > 0)
+    {
+      for (std::size_t i = 0; i < dmap.size(); ++i)
+        for (int k = 0; k < _bs; ++k)
+          b[_bs * dmap[i] + k] += be[_bs * i + k];
+    }
+    else
+    {
+      for (std::size_t i = 0; i < dmap.size(); ++i)
+        for (int k = 0; k < bs; ++k)
+          b[bs * dmap[i] + k] += be[bs * i + k];
+    }
+  }
+}
+
 /// Modify RHS vector to account for boundary condition such that:
 ///
 /// b <- b - scale * A (x_bc - x0)
@@ -978,16 +1098,23 @@ void apply_lifting(
   }
 }
 
-/// Assemble linear form into a vector
+/// Assemble a cell integral of a linear form into a vector over a
+/// list of cells
 /// @param[in,out] b The vector to be assembled. It will not be zeroed
 /// before assembly.
-/// @param[in] L The linear forms to assemble into b
+/// @param[in] L The linear form
+/// @param[in] i The id of the cell integral
+/// @param[in] cells The cells to assemble over
 /// @param[in] constants Packed constants that appear in `L`
 /// @param[in] coeffs Packed coefficients that appear in `L`
+/// @param[in] cstride Number of coefficient entries per cell
+/// @param[in] cell_info The cell permutation data
 template <typename T>
-void assemble_vector(xtl::span<T> b, const Form<T>& L,
-                     const xtl::span<const T>& constants,
-                     const xtl::span<const T>& coeffs, int cstride)
+void assemble_cell_integral(xtl::span<T> b, const Form<T>& L, int i,
+                            const xtl::span<const std::int32_t>& cells,
+                            const xtl::span<const T>& constants,
+                            const xtl::span<const T>& coeffs, int cstride,
+                            const xtl::span<const std::uint32_t>& cell_info)
 {
   std::shared_ptr<const mesh::Mesh> mesh = L.mesh();
   assert(mesh);
@@ -1007,57 +1134,107 @@ void assemble_vector(xtl::span<T> b, const Form<T>& L,
                            int)>
       dof_transform = element->get_dof_transformation_function<T>();
 
-  const bool needs_transformation_data
-      = element->needs_dof_transformations() or L.needs_facet_permutations();
-  xtl::span<const std::uint32_t> cell_info;
-  if (needs_transformation_data)
+  const auto& fn = L.kernel(IntegralType::cell, i);
+  if (const int batch_size = L.batch_size(IntegralType::cell, i);
+      batch_size > 0)
   {
-    mesh->topology_mutable().create_entity_permutations();
-    cell_info = xtl::span(mesh->topology().get_cell_permutation_info());
-  }
-
-  for (int i : L.integral_ids(IntegralType::cell))
-  {
-    const auto& fn = L.kernel(IntegralType::cell, i);
-    const std::vector<std::int32_t>& cells = L.cell_domains(i);
+    const auto& batch_fn = L.batch_kernel(IntegralType::cell, i);
     if (bs == 1)
     {
-      impl::assemble_cells<T, 1>(dof_transform, b, mesh->geometry(), cells,
-                                 dofs, bs, fn, constants, coeffs, cstride,
-                                 cell_info);
+      impl::assemble_cells_batched<T, 1>(
+          dof_transform, b, mesh->geometry(), cells, dofs, bs, batch_fn,
+          batch_size, constants, coeffs, cstride, cell_info);
     }
     else if (bs == 3)
     {
-      impl::assemble_cells<T, 3>(dof_transform, b, mesh->geometry(), cells,
-                                 dofs, bs, fn, constants, coeffs, cstride,
-                                 cell_info);
+      impl::assemble_cells_batched<T, 3>(
+          dof_transform, b, mesh->geometry(), cells, dofs, bs, batch_fn,
+          batch_size, constants, coeffs, cstride, cell_info);
     }
     else
     {
-      impl::assemble_cells(dof_transform, b, mesh->geometry(), cells, dofs, bs,
-                           fn, constants, coeffs, cstride, cell_info);
+      impl::assemble_cells_batched(dof_transform, b, mesh->geometry(), cells,
+                                   dofs, bs, batch_fn, batch_size, constants,
+                                   coeffs, cstride, cell_info);
     }
   }
+  else if (bs == 1)
+  {
+    impl::assemble_cells<T, 1>(dof_transform, b, mesh->geometry(), cells,
+                               dofs, bs, fn, constants, coeffs, cstride,
+                               cell_info);
+  }
+  else if (bs == 3)
+  {
+    impl::assemble_cells<T, 3>(dof_transform, b, mesh->geometry(), cells,
+                               dofs, bs, fn, constants, coeffs, cstride,
+                               cell_info);
+  }
+  else
+  {
+    impl::assemble_cells(dof_transform, b, mesh->geometry(), cells, dofs, bs,
+                         fn, constants, coeffs, cstride, cell_info);
+  }
+}
 
-  if (L.num_integrals(IntegralType::exterior_facet) > 0
-      or L.num_integrals(IntegralType::interior_facet) > 0)
+/// Assemble the exterior and interior facet integrals of a linear form
+/// into a vector
+/// @param[in,out] b The vector to be assembled. It will not be zeroed
+/// before assembly.
+/// @param[in] L The linear form
+/// @param[in] constants Packed constants that appear in `L`
+/// @param[in] coeffs Packed coefficients that appear in `L`
+/// @param[in] cstride Number of coefficient entries per cell
+/// @param[in] cell_info The cell permutation data
+/// @param[in] num_threads Number of threads
+template <typename T>
+void assemble_facet_integrals(xtl::span<T> b, const Form<T>& L,
+                              const xtl::span<const T>& constants,
+                              const xtl::span<const T>& coeffs, int cstride,
+                              const xtl::span<const std::uint32_t>& cell_info,
+                              int num_threads)
+{
+  if (L.num_integrals(IntegralType::exterior_facet) == 0
+      and L.num_integrals(IntegralType::interior_facet) == 0)
   {
-    std::function<std::uint8_t(std::size_t)> get_perm;
-    if (L.needs_facet_permutations())
-    {
-      mesh->topology_mutable().create_entity_permutations();
-      const std::vector<std::uint8_t>& perms
-          = mesh->topology().get_facet_permutations();
-      get_perm = [&perms](std::size_t i) { return perms[i]; };
-    }
-    else
-      get_perm = [](std::size_t) { return 0; };
+    return;
+  }
+
+  std::shared_ptr<const mesh::Mesh> mesh = L.mesh();
+  assert(mesh);
+
+  // Get dofmap data
+  assert(L.function_spaces().at(0));
+  std::shared_ptr<const fem::FiniteElement> element
+      = L.function_spaces().at(0)->element();
+  std::shared_ptr<const fem::DofMap> dofmap
+      = L.function_spaces().at(0)->dofmap();
+  assert(dofmap);
+  const graph::AdjacencyList<std::int32_t>& dofs = dofmap->list();
+  const int bs = dofmap->bs();
+
+  const std::function<void(const xtl::span<T>&,
+                           const xtl::span<const std::uint32_t>&, std::int32_t,
+                           int)>
+      dof_transform = element->get_dof_transformation_function<T>();
+
+  std::function<std::uint8_t(std::size_t)> get_perm;
+  if (L.needs_facet_permutations())
+  {
+    mesh->topology_mutable().create_entity_permutations();
+    const std::vector<std::uint8_t>& perms
+        = mesh->topology().get_facet_permutations();
+    get_perm = [&perms](std::size_t i) { return perms[i]; };
+  }
+  else
+    get_perm = [](std::size_t) { return 0; };
 
-    for (int i : L.integral_ids(IntegralType::exterior_facet))
+  for (int i : L.integral_ids(IntegralType::exterior_facet))
+  {
+    const auto& fn = L.kernel(IntegralType::exterior_facet, i);
+    auto assemble
+        = [&](const xtl::span<const std::pair<std::int32_t, int>>& facets)
     {
-      const auto& fn = L.kernel(IntegralType::exterior_facet, i);
-      const std::vector<std::pair<std::int32_t, int>>& facets
-          = L.exterior_facet_domains(i);
       if (bs == 1)
       {
         impl::assemble_exterior_facets<T, 1>(dof_transform, b, *mesh, facets,
@@ -1076,33 +1253,367 @@ void assemble_vector(xtl::span<T> b, const Form<T>& L,
                                        bs, fn, constants, coeffs, cstride,
                                        cell_info, get_perm);
       }
+    };
+
+    const std::vector<std::pair<std::int32_t, int>>& facets
+        = L.exterior_facet_domains(i);
+    if (num_threads > 1)
+    {
+      impl::for_each_colour<std::pair<std::int32_t, int>>(
+          facets, L.colouring(IntegralType::exterior_facet, i), num_threads,
+          assemble);
     }
+    else
+      assemble(facets);
+  }
 
-    const std::vector<int> c_offsets = L.coefficient_offsets();
-    for (int i : L.integral_ids(IntegralType::interior_facet))
+  const std::vector<int> c_offsets = L.coefficient_offsets();
+  for (int i : L.integral_ids(IntegralType::interior_facet))
+  {
+    const auto& fn = L.kernel(IntegralType::interior_facet, i);
+    const InteriorFacetTable& table = L.interior_facet_table(i);
+    auto assemble = [&](const xtl::span<const std::int32_t>& facets)
     {
-      const auto& fn = L.kernel(IntegralType::interior_facet, i);
-      const std::vector<std::tuple<std::int32_t, int, std::int32_t, int>>&
-          facets
-          = L.interior_facet_domains(i);
       if (bs == 1)
       {
         impl::assemble_interior_facets<T, 1>(
-            dof_transform, b, *mesh, facets, *dofmap, fn, constants, coeffs,
-            cstride, c_offsets, cell_info, get_perm);
+            dof_transform, b, mesh->geometry(), table, facets, bs, fn,
+            constants, coeffs, cstride, c_offsets, cell_info);
       }
       else if (bs == 3)
       {
         impl::assemble_interior_facets<T, 3>(
-            dof_transform, b, *mesh, facets, *dofmap, fn, constants, coeffs,
-            cstride, c_offsets, cell_info, get_perm);
+            dof_transform, b, mesh->geometry(), table, facets, bs, fn,
+            constants, coeffs, cstride, c_offsets, cell_info);
+      }
+      else
+      {
+        impl::assemble_interior_facets(dof_transform, b, mesh->geometry(),
+                                       table, facets, bs, fn, constants,
+                                       coeffs, cstride, c_offsets, cell_info);
+      }
+    };
+
+    std::vector<std::int32_t> facets(table.cells.size());
+    std::iota(facets.begin(), facets.end(), 0);
+    if (num_threads > 1)
+    {
+      impl::for_each_colour<std::int32_t>(
+          facets, L.colouring(IntegralType::interior_facet, i), num_threads,
+          assemble);
+    }
+    else
+      assemble(facets);
+  }
+}
+
+/// Assemble linear form into a vector
+/// @param[in,out] b The vector to be assembled. It will not be zeroed
+/// before assembly.
+/// @param[in] L The linear forms to assemble into b
+/// @param[in] constants Packed constants that appear in `L`
+/// @param[in] coeffs Packed coefficients that appear in `L`
+/// @param[in] num_threads Number of threads. If greater than one,
+/// entities are coloured such that entities of the same colour do not
+/// share dofs, and entities of the same colour are assembled
+/// concurrently.
+template <typename T>
+void assemble_vector(xtl::span<T> b, const Form<T>& L,
+                     const xtl::span<const T>& constants,
+                     const xtl::span<const T>& coeffs, int cstride,
+                     int num_threads = 1)
+{
+  if (num_threads < 1)
+    throw std::runtime_error("Number of threads must be positive.");
+
+  std::shared_ptr<const mesh::Mesh> mesh = L.mesh();
+  assert(mesh);
+
+  // Build the cell geometry cache (if enabled) before any threads are
+  // launched
+  mesh->geometry().cell_coordinates();
+
+  assert(L.function_spaces().at(0));
+  const bool needs_transformation_data
+      = L.function_spaces().at(0)->element()->needs_dof_transformations()
+        or L.needs_facet_permutations();
+  xtl::span<const std::uint32_t> cell_info;
+  if (needs_transformation_data)
+  {
+    mesh->topology_mutable().create_entity_permutations();
+    cell_info = xtl::span(mesh->topology().get_cell_permutation_info());
+  }
+
+  for (int i : L.integral_ids(IntegralType::cell))
+  {
+    auto assemble = [&](const xtl::span<const std::int32_t>& cells)
+    {
+      assemble_cell_integral(b, L, i, cells, constants, coeffs, cstride,
+                             cell_info);
+    };
+
+    const std::vector<std::int32_t>& cells = L.cell_domains(i);
+    if (num_threads > 1)
+    {
+      impl::for_each_colour<std::int32_t>(
+          cells, L.colouring(IntegralType::cell, i), num_threads, assemble);
+    }
+    else
+      assemble(cells);
+  }
+
+  assemble_facet_integrals(b, L, constants, coeffs, cstride, cell_info,
+                           num_threads);
+}
+
+/// Start the assembly of a linear form into a distributed vector,
+/// overlapping the ghost updates with computation. The ghost values of
+/// the coefficient vectors in `coefficients` are updated (forward
+/// scatter) while the cells that touch only owned dofs are assembled.
+/// The remaining (boundary) cells and all facet integrals are assembled
+/// once the update is complete, after which the reverse scatter of the
+/// ghost contributions of `b` is started. The caller must complete the
+/// assembly with `b.scatter_rev_end(common::IndexMap::Mode::add)`.
+/// Facet integrals are not overlapped with the ghost updates.
+/// @param[in,out] b The vector to be assembled. It will not be zeroed
+/// before assembly.
+/// @param[in] L The linear form to assemble into b
+/// @param[in] constants Packed constants that appear in `L`
+/// @param[in] coefficients Vectors of the coefficients of `L` whose
+/// ghost values are out of date. The ghost values of all other
+/// coefficients are assumed to be up to date.
+template <typename T>
+void assemble_vector_begin(
+    la::Vector<T>& b, const Form<T>& L, const xtl::span<const T>& constants,
+    const std::vector<std::shared_ptr<la::Vector<T>>>& coefficients)
+{
+  std::shared_ptr<const mesh::Mesh> mesh = L.mesh();
+  assert(mesh);
+  for (auto& v : coefficients)
+  {
+    assert(v);
+    if (v.get() == &b)
+      throw std::runtime_error("Cannot assemble into a coefficient vector.");
+  }
+
+  // Start updating the ghost values of the coefficients
+  for (auto& v : coefficients)
+    v->scatter_fwd_begin();
+
+  // Mark the cells that touch a ghost dof of the test space or of a
+  // coefficient that is being updated
+  const int tdim = mesh->topology().dim();
+  const std::int32_t num_cells
+      = mesh->topology().index_map(tdim)->size_local()
+        + mesh->topology().index_map(tdim)->num_ghosts();
+  std::vector<std::int8_t> boundary(num_cells, false);
+  auto mark = [&boundary](const fem::DofMap& dofmap)
+  {
+    const std::int32_t size_local = dofmap.index_map->size_local();
+    const graph::AdjacencyList<std::int32_t>& dofs = dofmap.list();
+    for (std::size_t c = 0; c < boundary.size(); ++c)
+    {
+      auto cell_dofs = dofs.links(c);
+      boundary[c] = boundary[c]
+                    or std::any_of(cell_dofs.begin(), cell_dofs.end(),
+                                   [size_local](std::int32_t dof)
+                                   { return dof >= size_local; });
+    }
+  };
+
+  assert(L.function_spaces().at(0));
+  mark(*L.function_spaces().at(0)->dofmap());
+  const std::vector<std::shared_ptr<const fem::Function<T>>>
+      form_coefficients = L.coefficients();
+  const auto& quadrature_data = L.quadrature_data();
+  for (std::size_t i = 0; i < form_coefficients.size(); ++i)
+  {
+    if (auto q = quadrature_data.find(i); q != quadrature_data.end())
+    {
+      // Quadrature data is distributed by cell, so only ghost cells
+      // have values that are being updated
+      auto it = std::find(coefficients.begin(), coefficients.end(),
+                          q->second->x());
+      if (it != coefficients.end())
+      {
+        std::fill(std::next(boundary.begin(),
+                            mesh->topology().index_map(tdim)->size_local()),
+                  boundary.end(), true);
       }
+    }
+    else
+    {
+      auto& u = form_coefficients[i];
+      auto it = std::find_if(coefficients.begin(), coefficients.end(),
+                             [&u](auto& v) { return v.get() == u->x().get(); });
+      if (it != coefficients.end())
+        mark(*u->function_space()->dofmap());
+    }
+  }
+
+  std::vector<std::int32_t> interior_cells, boundary_cells;
+  for (std::int32_t c = 0; c < num_cells; ++c)
+  {
+    if (boundary[c])
+      boundary_cells.push_back(c);
+    else
+      interior_cells.push_back(c);
+  }
+
+  // Pack the coefficients on the interior cells, which depend on owned
+  // values only
+  const std::vector<int> offsets = L.coefficient_offsets();
+  const int cstride = offsets.back();
+  std::vector<T> coeffs(num_cells * cstride);
+  pack_coefficients(L, interior_cells, xtl::span<T>(coeffs));
+
+  xtl::span<const std::uint32_t> cell_info;
+  if (L.function_spaces().at(0)->element()->needs_dof_transformations()
+      or L.needs_facet_permutations())
+  {
+    mesh->topology_mutable().create_entity_permutations();
+    cell_info = xtl::span(mesh->topology().get_cell_permutation_info());
+  }
+
+  // Split the cell integration domains into interior and boundary
+  // cells
+  const std::vector<int> ids = L.integral_ids(IntegralType::cell);
+  std::vector<std::vector<std::int32_t>> domains_boundary(ids.size());
+  xtl::span<T> _b = b.mutable_array();
+  std::vector<std::int32_t> cells;
+  for (std::size_t j = 0; j < ids.size(); ++j)
+  {
+    const std::vector<std::int32_t>& domain = L.cell_domains(ids[j]);
+    cells.clear();
+    for (std::int32_t c : domain)
+    {
+      if (boundary[c])
+        domains_boundary[j].push_back(c);
       else
+        cells.push_back(c);
+    }
+
+    // Assemble interior cells while the ghost updates are in flight
+    assemble_cell_integral<T>(_b, L, ids[j], cells, constants, coeffs,
+                              cstride, cell_info);
+  }
+
+  // Complete the ghost updates and pack the remaining coefficients
+  for (auto& v : coefficients)
+    v->scatter_fwd_end();
+  pack_coefficients(L, boundary_cells, xtl::span<T>(coeffs));
+
+  // Assemble boundary cells and facets
+  for (std::size_t j = 0; j < ids.size(); ++j)
+  {
+    assemble_cell_integral<T>(_b, L, ids[j], domains_boundary[j], constants,
+                              coeffs, cstride, cell_info);
+  }
+  assemble_facet_integrals<T>(_b, L, constants, coeffs, cstride, cell_info,
+                              1);
+
+  // Start sending ghost contributions to the owners
+  b.scatter_rev_begin();
+}
+
+/// Re-assemble the cell integrals of a linear form on a subset of
+/// cells. For each cell, the element vector stored in `cache` is
+/// subtracted and the newly computed element vector is added, and the
+/// cache is updated. Cells with no stored element vector are treated as
+/// having a zero previous contribution, so passing all cells with an
+/// empty cache performs a full assembly and populates the cache.
+/// @param[in,out] b The vector to update
+/// @param[in] L The linear form. It must contain cell integrals only.
+/// @param[in] cells The cells to re-assemble (local to process)
+/// @param[in] constants Packed constants that appear in `L`
+/// @param[in] coeffs Packed coefficients that appear in `L`
+/// @param[in] cstride Number of coefficient entries per cell
+/// @param[in,out] cache The element vectors from the previous assembly
+template <typename T>
+void reassemble_vector(xtl::span<T> b, const Form<T>& L,
+                       const xtl::span<const std::int32_t>& cells,
+                       const xtl::span<const T>& constants,
+                       const xtl::span<const T>& coeffs, int cstride,
+                       ElementTensorCache<T>& cache)
+{
+  if (L.num_integrals(IntegralType::exterior_facet) > 0
+      or L.num_integrals(IntegralType::interior_facet) > 0)
+  {
+    throw std::runtime_error(
+        "Incremental re-assembly supports cell integrals only.");
+  }
+
+  std::shared_ptr<const mesh::Mesh> mesh = L.mesh();
+  assert(mesh);
+  const mesh::Geometry& geometry = mesh->geometry();
+
+  // Get dofmap data
+  assert(L.function_spaces().at(0));
+  std::shared_ptr<const fem::FiniteElement> element
+      = L.function_spaces().at(0)->element();
+  std::shared_ptr<const fem::DofMap> dofmap
+      = L.function_spaces().at(0)->dofmap();
+  assert(dofmap);
+  const graph::AdjacencyList<std::int32_t>& dofs = dofmap->list();
+  const int bs = dofmap->bs();
+
+  const std::function<void(const xtl::span<T>&,
+                           const xtl::span<const std::uint32_t>&, std::int32_t,
+                           int)>
+      dof_transform = element->get_dof_transformation_function<T>();
+
+  xtl::span<const std::uint32_t> cell_info;
+  if (element->needs_dof_transformations())
+  {
+    mesh->topology_mutable().create_entity_permutations();
+    cell_info = xtl::span(mesh->topology().get_cell_permutation_info());
+  }
+
+  // Prepare cell geometry
+  const graph::AdjacencyList<std::int32_t>& x_dofmap = geometry.dofmap();
+  const std::size_t num_dofs_g = x_dofmap.num_links(0);
+  const xt::xtensor<double, 2>& x_g = geometry.x();
+  const xtl::span<const double> x_cache = geometry.cell_coordinates();
+
+  // Sort the modified cells so that they can be intersected with the
+  // (sorted) integration domains
+  std::vector<std::int32_t> modified(cells.begin(), cells.end());
+  std::sort(modified.begin(), modified.end());
+  modified.erase(std::unique(modified.begin(), modified.end()),
+                 modified.end());
+
+  const int num_dofs = dofs.links(0).size();
+  std::vector<double> coordinate_dofs(3 * num_dofs_g);
+  std::vector<T> be(bs * num_dofs);
+  const xtl::span<T> _be(be);
+  std::vector<std::int32_t> active_cells;
+  for (int i : L.integral_ids(IntegralType::cell))
+  {
+    const auto& fn = L.kernel(IntegralType::cell, i);
+    const std::vector<std::int32_t>& domain = L.cell_domains(i);
+    active_cells.clear();
+    std::set_intersection(domain.begin(), domain.end(), modified.begin(),
+                          modified.end(), std::back_inserter(active_cells));
+    for (std::int32_t c : active_cells)
+    {
+      // Tabulate vector for cell
+      const double* coordinate_dofs_c = get_cell_coordinates(
+          x_cache, x_dofmap, x_g, c, xtl::span<double>(coordinate_dofs));
+      std::fill(be.begin(), be.end(), 0);
+      fn(be.data(), coeffs.data() + c * cstride, constants.data(),
+         coordinate_dofs_c, nullptr, nullptr);
+      dof_transform(_be, cell_info, c, 1);
+
+      // Add difference between new and stored element vector
+      std::vector<T>& be0 = cache(i, c);
+      be0.resize(be.size(), 0);
+      auto cell_dofs = dofs.links(c);
+      for (int j = 0; j < num_dofs; ++j)
       {
-        impl::assemble_interior_facets(dof_transform, b, *mesh, facets, *dofmap,
-                                       fn, constants, coeffs, cstride,
-                                       c_offsets, cell_info, get_perm);
+        for (int k = 0; k < bs; ++k)
+          b[bs * cell_dofs[j] + k] += be[bs * j + k] - be0[bs * j + k];
       }
+      std::copy(be.begin(), be.end(), be0.begin());
     }
   }
 }
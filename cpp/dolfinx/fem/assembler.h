@@ -8,8 +8,13 @@
 
 #include "assemble_matrix_impl.h"
 #include "assemble_scalar_impl.h"
+#include "assemble_system_impl.h"
 #include "assemble_vector_impl.h"
+#include <algorithm>
+#include <complex>
+#include <dolfinx/common/MPI.h>
 #include <memory>
+#include <type_traits>
 #include <vector>
 #include <xtl/xspan.hpp>
 
@@ -52,6 +57,69 @@ T assemble_scalar(const Form<T>& M)
   return assemble_scalar(M, tcb::make_span(constants), {coeffs, cstride});
 }
 
+/// Assemble functional into a scalar that is accumulated across
+/// processes, with a result that is bitwise independent of the number
+/// of processes, the mesh partitioning and the order of the integration
+/// entities. The contribution of each integration entity is computed
+/// separately and the contributions are summed by
+/// dolfinx::MPI::reproducible_sum. For interior facet integrals, the
+/// '+' restriction is the cell whose sorted input global geometry node
+/// indices are lexicographically smallest, rather than the cell that
+/// comes first locally. The caller supplies the form constants and
+/// coefficients for this version.
+/// @note This function is collective on the mesh communicator
+/// @param[in] M The form (functional) to assemble
+/// @param[in] constants The constants that appear in `M`
+/// @param[in] coeffs The coefficients that appear in `M`
+/// @return The value of the form (functional), accumulated across all
+/// processes
+template <typename T>
+T assemble_scalar_reproducible(const Form<T>& M,
+                               const xtl::span<const T>& constants,
+                               const std::pair<xtl::span<const T>, int>& coeffs)
+{
+  std::vector<T> contributions;
+  impl::assemble_scalar(M, constants, coeffs.first, coeffs.second,
+                        &contributions);
+
+  assert(M.mesh());
+  MPI_Comm comm = M.mesh()->mpi_comm();
+  if constexpr (std::is_floating_point_v<T>)
+  {
+    const std::vector<double> values(contributions.begin(),
+                                     contributions.end());
+    return dolfinx::MPI::reproducible_sum(comm, values);
+  }
+  else
+  {
+    std::vector<double> real(contributions.size());
+    std::vector<double> imag(contributions.size());
+    std::transform(contributions.begin(), contributions.end(), real.begin(),
+                   [](auto x) { return std::real(x); });
+    std::transform(contributions.begin(), contributions.end(), imag.begin(),
+                   [](auto x) { return std::imag(x); });
+    return T(dolfinx::MPI::reproducible_sum(comm, real),
+             dolfinx::MPI::reproducible_sum(comm, imag));
+  }
+}
+
+/// Assemble functional into a scalar that is accumulated across
+/// processes, with a result that is bitwise independent of the number
+/// of processes, the mesh partitioning and the order of the integration
+/// entities. See fem::assemble_scalar_reproducible.
+/// @note This function is collective on the mesh communicator
+/// @param[in] M The form (functional) to assemble
+/// @return The value of the form (functional), accumulated across all
+/// processes
+template <typename T>
+T assemble_scalar_reproducible(const Form<T>& M)
+{
+  const std::vector<T> constants = pack_constants(M);
+  const auto [coeffs, cstride] = pack_coefficients(M);
+  return assemble_scalar_reproducible(M, tcb::make_span(constants),
+                                      {coeffs, cstride});
+}
+
 // -- Vectors ----------------------------------------------------------------
 
 /// Assemble linear form into a vector, The caller supplies the form
@@ -62,24 +130,117 @@ T assemble_scalar(const Form<T>& M)
 /// @param[in] L The linear forms to assemble into b
 /// @param[in] constants The constants that appear in `L`
 /// @param[in] coeffs The coefficients that appear in `L`
+/// @param[in] num_threads The number of threads to use. If greater
+/// than one, entities that share dofs are coloured and entities of the
+/// same colour are assembled concurrently. The result is independent of
+/// the number of threads, but may differ in the last bits from the
+/// serial (num_threads = 1) result.
 template <typename T>
 void assemble_vector(xtl::span<T> b, const Form<T>& L,
                      const xtl::span<const T>& constants,
-                     const std::pair<xtl::span<const T>, int>& coeffs)
+                     const std::pair<xtl::span<const T>, int>& coeffs,
+                     int num_threads = 1)
 {
-  impl::assemble_vector(b, L, constants, coeffs.first, coeffs.second);
+  impl::assemble_vector(b, L, constants, coeffs.first, coeffs.second,
+                        num_threads);
 }
 
 /// Assemble linear form into a vector
 /// @param[in,out] b The vector to be assembled. It will not be zeroed
 /// before assembly.
 /// @param[in] L The linear forms to assemble into b
+/// @param[in] num_threads The number of threads to use. If greater
+/// than one, entities that share dofs are coloured and entities of the
+/// same colour are assembled concurrently. The result is independent of
+/// the number of threads, but may differ in the last bits from the
+/// serial (num_threads = 1) result.
+template <typename T>
+void assemble_vector(xtl::span<T> b, const Form<T>& L, int num_threads = 1)
+{
+  const std::vector<T> constants = pack_constants(L);
+  const auto [coeffs, cstride] = pack_coefficients(L);
+  assemble_vector(b, L, tcb::make_span(constants), {coeffs, cstride},
+                  num_threads);
+}
+
+/// Start the assembly of a linear form into a distributed vector,
+/// overlapping parallel communication with computation. The ghost
+/// values of the vectors in `coefficients` are updated while cells
+/// that touch only owned dofs are assembled. The remaining cells and
+/// the facet integrals are then assembled and the accumulation of
+/// ghost contributions on the owning processes is started. The
+/// assembly must be completed by calling fem::assemble_vector_end.
+///
+/// This is equivalent to updating the ghosts of `coefficients`,
+/// calling fem::assemble_vector and calling
+/// `b.scatter_rev(common::IndexMap::Mode::add)`, but hides message
+/// latency behind computation.
+/// @note Only cell integrals are overlapped with the ghost updates.
+/// Facet integrals are assembled after the updates have completed.
+/// @param[in,out] b The vector to be assembled. It will not be zeroed
+/// before assembly.
+/// @param[in] L The linear form to assemble into b
+/// @param[in] coefficients The vectors of the coefficients in `L`
+/// whose ghost values are out of date, e.g. `{u->x()}`
+template <typename T>
+void assemble_vector_begin(
+    la::Vector<T>& b, const Form<T>& L,
+    const std::vector<std::shared_ptr<la::Vector<T>>>& coefficients)
+{
+  const std::vector<T> constants = pack_constants(L);
+  impl::assemble_vector_begin(b, L, tcb::make_span(constants), coefficients);
+}
+
+/// Complete the assembly of a linear form into a distributed vector
+/// that was started by fem::assemble_vector_begin
+/// @param[in,out] b The vector being assembled
 template <typename T>
-void assemble_vector(xtl::span<T> b, const Form<T>& L)
+void assemble_vector_end(la::Vector<T>& b)
+{
+  b.scatter_rev_end(common::IndexMap::Mode::add);
+}
+
+/// Incrementally re-assemble a linear form into a vector on a subset
+/// of cells. The element vector stored in `cache` for each cell is
+/// subtracted from `b` and the newly computed element vector is added.
+/// Cells without a stored element vector are treated as having a zero
+/// previous contribution, so calling this function for all cells with
+/// an empty cache assembles the form and populates the cache.
+/// @note Only cell integrals are supported.
+/// @note Ghost contributions are not accumulated (not sent to owner)
+/// and boundary condition lifting is not applied.
+/// @param[in,out] b The vector to be updated
+/// @param[in] L The linear form
+/// @param[in] cells The modified cells (local to process)
+/// @param[in,out] cache The element vectors from the previous assembly
+/// @param[in] constants Constants that appear in `L`
+/// @param[in] coeffs Coefficients that appear in `L`
+template <typename T>
+void reassemble_vector(xtl::span<T> b, const Form<T>& L,
+                       const xtl::span<const std::int32_t>& cells,
+                       ElementTensorCache<T>& cache,
+                       const xtl::span<const T>& constants,
+                       const std::pair<xtl::span<const T>, int>& coeffs)
+{
+  impl::reassemble_vector(b, L, cells, constants, coeffs.first, coeffs.second,
+                          cache);
+}
+
+/// Incrementally re-assemble a linear form into a vector on a subset
+/// of cells. See fem::reassemble_vector.
+/// @param[in,out] b The vector to be updated
+/// @param[in] L The linear form
+/// @param[in] cells The modified cells (local to process)
+/// @param[in,out] cache The element vectors from the previous assembly
+template <typename T>
+void reassemble_vector(xtl::span<T> b, const Form<T>& L,
+                       const xtl::span<const std::int32_t>& cells,
+                       ElementTensorCache<T>& cache)
 {
   const std::vector<T> constants = pack_constants(L);
   const auto [coeffs, cstride] = pack_coefficients(L);
-  assemble_vector(b, L, tcb::make_span(constants), {coeffs, cstride});
+  reassemble_vector(b, L, cells, cache, tcb::make_span(constants),
+                    {coeffs, cstride});
 }
 
 // FIXME: clarify how x0 is used
@@ -155,19 +316,25 @@ void apply_lifting(
 // -- Matrices ---------------------------------------------------------------
 
 /// Assemble bilinear form into a matrix
-/// @param[in] mat_add The function for adding values into the matrix
+/// @param[in] mat_add The function for adding values into the matrix.
+/// Any callable with signature `int(std::int32_t, const std::int32_t*,
+/// std::int32_t, const std::int32_t*, const T*)` can be used, which
+/// allows insertion to be inlined.
 /// @param[in] a The bilinear from to assemble
 /// @param[in] constants Constants that appear in `a`
 /// @param[in] coeffs Coefficients that appear in `a`
 /// @param[in] bcs Boundary conditions to apply. For boundary condition
 ///  dofs the row and column are zeroed. The diagonal  entry is not set.
-template <typename T>
+/// @param[in] num_threads The number of threads to use. If greater
+/// than one, entities that share rows are coloured and entities of the
+/// same colour are assembled concurrently. Calls to `mat_add` are
+/// serialised.
+template <typename T, typename U>
 void assemble_matrix(
-    const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
-                            const std::int32_t*, const T*)>& mat_add,
-    const Form<T>& a, const xtl::span<const T>& constants,
+    const U& mat_add, const Form<T>& a, const xtl::span<const T>& constants,
     const std::pair<xtl::span<const T>, int>& coeffs,
-    const std::vector<std::shared_ptr<const DirichletBC<T>>>& bcs)
+    const std::vector<std::shared_ptr<const DirichletBC<T>>>& bcs,
+    int num_threads = 1)
 {
   // Index maps for dof ranges
   auto map0 = a.function_spaces().at(0)->dofmap()->index_map;
@@ -200,20 +367,26 @@ void assemble_matrix(
 
   // Assemble
   impl::assemble_matrix(mat_add, a, constants, coeffs.first, coeffs.second,
-                        dof_marker0, dof_marker1);
+                        dof_marker0, dof_marker1, num_threads);
 }
 
 /// Assemble bilinear form into a matrix
-/// @param[in] mat_add The function for adding values into the matrix
+/// @param[in] mat_add The function for adding values into the matrix.
+/// Any callable with signature `int(std::int32_t, const std::int32_t*,
+/// std::int32_t, const std::int32_t*, const T*)` can be used, which
+/// allows insertion to be inlined.
 /// @param[in] a The bilinear from to assemble
 /// @param[in] bcs Boundary conditions to apply. For boundary condition
 ///  dofs the row and column are zeroed. The diagonal  entry is not set.
-template <typename T>
+/// @param[in] num_threads The number of threads to use. If greater
+/// than one, entities that share rows are coloured and entities of the
+/// same colour are assembled concurrently. Calls to `mat_add` are
+/// serialised.
+template <typename T, typename U>
 void assemble_matrix(
-    const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
-                            const std::int32_t*, const T*)>& mat_add,
-    const Form<T>& a,
-    const std::vector<std::shared_ptr<const DirichletBC<T>>>& bcs)
+    const U& mat_add, const Form<T>& a,
+    const std::vector<std::shared_ptr<const DirichletBC<T>>>& bcs,
+    int num_threads = 1)
 {
   // Prepare constants and coefficients
   const std::vector<T> constants = pack_constants(a);
@@ -221,12 +394,15 @@ void assemble_matrix(
 
   // Assemble
   assemble_matrix(mat_add, a, tcb::make_span(constants),
-                  {coeffs.first, coeffs.second}, bcs);
+                  {coeffs.first, coeffs.second}, bcs, num_threads);
 }
 
 /// Assemble bilinear form into a matrix. Matrix must already be
 /// initialised. Does not zero or finalise the matrix.
-/// @param[in] mat_add The function for adding values into the matrix
+/// @param[in] mat_add The function for adding values into the matrix.
+/// Any callable with signature `int(std::int32_t, const std::int32_t*,
+/// std::int32_t, const std::int32_t*, const T*)` can be used, which
+/// allows insertion to be inlined.
 /// @param[in] a The bilinear form to assemble
 /// @param[in] constants Constants that appear in `a`
 /// @param[in] coeffs Coefficients that appear in `a`
@@ -236,22 +412,27 @@ void assemble_matrix(
 /// @param[in] dof_marker1 Boundary condition markers for the columns.
 /// If bc[i] is true then rows i in A will be zeroed. The index i is a
 /// local index.
-template <typename T>
+/// @param[in] num_threads The number of threads to use. If greater
+/// than one, entities that share rows are coloured and entities of the
+/// same colour are assembled concurrently. Calls to `mat_add` are
+/// serialised.
+template <typename T, typename U>
 void assemble_matrix(
-    const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
-                            const std::int32_t*, const T*)>& mat_add,
-    const Form<T>& a, const xtl::span<const T>& constants,
+    const U& mat_add, const Form<T>& a, const xtl::span<const T>& constants,
     const std::pair<xtl::span<const T>, int>& coeffs,
-    const std::vector<bool>& dof_marker0, const std::vector<bool>& dof_marker1)
-
+    const std::vector<bool>& dof_marker0, const std::vector<bool>& dof_marker1,
+    int num_threads = 1)
 {
   impl::assemble_matrix(mat_add, a, constants, coeffs.first, coeffs.second,
-                        dof_marker0, dof_marker1);
+                        dof_marker0, dof_marker1, num_threads);
 }
 
 /// Assemble bilinear form into a matrix. Matrix must already be
 /// initialised. Does not zero or finalise the matrix.
-/// @param[in] mat_add The function for adding values into the matrix
+/// @param[in] mat_add The function for adding values into the matrix.
+/// Any callable with signature `int(std::int32_t, const std::int32_t*,
+/// std::int32_t, const std::int32_t*, const T*)` can be used, which
+/// allows insertion to be inlined.
 /// @param[in] a The bilinear form to assemble
 /// @param[in] dof_marker0 Boundary condition markers for the rows. If
 ///   bc[i] is true then rows i in A will be zeroed. The index i is a
@@ -259,21 +440,203 @@ void assemble_matrix(
 /// @param[in] dof_marker1 Boundary condition markers for the columns.
 ///   If bc[i] is true then rows i in A will be zeroed. The index i is a
 ///   local index.
+/// @param[in] num_threads The number of threads to use. If greater
+/// than one, entities that share rows are coloured and entities of the
+/// same colour are assembled concurrently. Calls to `mat_add` are
+/// serialised.
+template <typename T, typename U>
+void assemble_matrix(
+    const U& mat_add, const Form<T>& a, const std::vector<bool>& dof_marker0,
+    const std::vector<bool>& dof_marker1, int num_threads = 1)
+{
+  // Prepare constants and coefficients
+  const std::vector<T> constants = pack_constants(a);
+  const auto [coeffs, cstride] = pack_coefficients(a);
+
+  // Assemble
+  assemble_matrix(mat_add, a, tcb::make_span(constants), {coeffs, cstride},
+                  dof_marker0, dof_marker1, num_threads);
+}
+
+/// Assemble bilinear form into a matrix. Version with the insertion
+/// function as a std::function.
+/// @param[in] mat_add The function for adding values into the matrix
+/// @param[in] a The bilinear from to assemble
+/// @param[in] constants Constants that appear in `a`
+/// @param[in] coeffs Coefficients that appear in `a`
+/// @param[in] bcs Boundary conditions to apply
+/// @param[in] num_threads The number of threads to use
+template <typename T>
+void assemble_matrix(
+    const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
+                            const std::int32_t*, const T*)>& mat_add,
+    const Form<T>& a, const xtl::span<const T>& constants,
+    const std::pair<xtl::span<const T>, int>& coeffs,
+    const std::vector<std::shared_ptr<const DirichletBC<T>>>& bcs,
+    int num_threads = 1)
+{
+  using U = std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
+                              const std::int32_t*, const T*)>;
+  assemble_matrix<T, U>(mat_add, a, constants, coeffs, bcs, num_threads);
+}
+
+/// Assemble bilinear form into a matrix. Version with the insertion
+/// function as a std::function.
+/// @param[in] mat_add The function for adding values into the matrix
+/// @param[in] a The bilinear from to assemble
+/// @param[in] bcs Boundary conditions to apply
+/// @param[in] num_threads The number of threads to use
+template <typename T>
+void assemble_matrix(
+    const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
+                            const std::int32_t*, const T*)>& mat_add,
+    const Form<T>& a,
+    const std::vector<std::shared_ptr<const DirichletBC<T>>>& bcs,
+    int num_threads = 1)
+{
+  using U = std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
+                              const std::int32_t*, const T*)>;
+  assemble_matrix<T, U>(mat_add, a, bcs, num_threads);
+}
+
+/// Assemble bilinear form into a matrix. Version with the insertion
+/// function as a std::function.
+/// @param[in] mat_add The function for adding values into the matrix
+/// @param[in] a The bilinear form to assemble
+/// @param[in] constants Constants that appear in `a`
+/// @param[in] coeffs Coefficients that appear in `a`
+/// @param[in] dof_marker0 Boundary condition markers for the rows
+/// @param[in] dof_marker1 Boundary condition markers for the columns
+/// @param[in] num_threads The number of threads to use
+template <typename T>
+void assemble_matrix(
+    const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
+                            const std::int32_t*, const T*)>& mat_add,
+    const Form<T>& a, const xtl::span<const T>& constants,
+    const std::pair<xtl::span<const T>, int>& coeffs,
+    const std::vector<bool>& dof_marker0, const std::vector<bool>& dof_marker1,
+    int num_threads = 1)
+{
+  using U = std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
+                              const std::int32_t*, const T*)>;
+  assemble_matrix<T, U>(mat_add, a, constants, coeffs, dof_marker0,
+                        dof_marker1, num_threads);
+}
+
+/// Assemble bilinear form into a matrix. Version with the insertion
+/// function as a std::function.
+/// @param[in] mat_add The function for adding values into the matrix
+/// @param[in] a The bilinear form to assemble
+/// @param[in] dof_marker0 Boundary condition markers for the rows
+/// @param[in] dof_marker1 Boundary condition markers for the columns
+/// @param[in] num_threads The number of threads to use
 template <typename T>
 void assemble_matrix(
     const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
                             const std::int32_t*, const T*)>& mat_add,
     const Form<T>& a, const std::vector<bool>& dof_marker0,
-    const std::vector<bool>& dof_marker1)
+    const std::vector<bool>& dof_marker1, int num_threads = 1)
+{
+  using U = std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
+                              const std::int32_t*, const T*)>;
+  assemble_matrix<T, U>(mat_add, a, dof_marker0, dof_marker1, num_threads);
+}
 
+/// Compute the action y = A u of a bilinear form without assembling
+/// the matrix A. Element matrices are computed on-the-fly. The result
+/// for owned entries of y is the same as the product with the matrix
+/// assembled by fem::assemble_matrix with boundary conditions `bcs`
+/// followed by fem::set_diagonal with value `diagonal`.
+/// @param[out] y The result vector, with the layout of the test space.
+/// It is zeroed before computing the action. Only owned entries are
+/// valid on return.
+/// @param[in] a The bilinear form
+/// @param[in,out] u The vector to compute the action on, with the
+/// layout of the trial space. Its ghost entries are updated.
+/// @param[in] constants Constants that appear in `a`
+/// @param[in] coeffs Coefficients that appear in `a`
+/// @param[in] bcs Boundary conditions to apply. For boundary condition
+/// dofs the row and column are zeroed.
+/// @param[in] diagonal The diagonal value for rows with a boundary
+/// condition applied, if the test and trial spaces are the same
+/// @note Collective MPI operation
+template <typename T>
+void assemble_action(
+    la::Vector<T>& y, const Form<T>& a, la::Vector<T>& u,
+    const xtl::span<const T>& constants,
+    const std::pair<xtl::span<const T>, int>& coeffs,
+    const std::vector<std::shared_ptr<const DirichletBC<T>>>& bcs,
+    T diagonal = 1.0)
+{
+  // Index maps for dof ranges
+  auto map0 = a.function_spaces().at(0)->dofmap()->index_map;
+  auto map1 = a.function_spaces().at(1)->dofmap()->index_map;
+  auto bs0 = a.function_spaces().at(0)->dofmap()->index_map_bs();
+  auto bs1 = a.function_spaces().at(1)->dofmap()->index_map_bs();
+
+  // Build dof markers
+  std::vector<bool> dof_marker0, dof_marker1;
+  assert(map0);
+  std::int32_t dim0 = bs0 * (map0->size_local() + map0->num_ghosts());
+  assert(map1);
+  std::int32_t dim1 = bs1 * (map1->size_local() + map1->num_ghosts());
+  for (std::size_t k = 0; k < bcs.size(); ++k)
+  {
+    assert(bcs[k]);
+    assert(bcs[k]->function_space());
+    if (a.function_spaces().at(0)->contains(*bcs[k]->function_space()))
+    {
+      dof_marker0.resize(dim0, false);
+      bcs[k]->mark_dofs(dof_marker0);
+    }
+
+    if (a.function_spaces().at(1)->contains(*bcs[k]->function_space()))
+    {
+      dof_marker1.resize(dim1, false);
+      bcs[k]->mark_dofs(dof_marker1);
+    }
+  }
+
+  impl::assemble_action(y, a, u, constants, coeffs.first, coeffs.second,
+                        dof_marker0, dof_marker1);
+
+  // Add diagonal contribution for owned boundary condition rows
+  if (*a.function_spaces().at(0) == *a.function_spaces().at(1))
+  {
+    xtl::span<T> _y = y.mutable_array();
+    xtl::span<const T> _u = u.array();
+    for (const auto& bc : bcs)
+    {
+      if (a.function_spaces().at(0)->contains(*bc->function_space()))
+      {
+        const auto [dofs, range] = bc->dof_indices();
+        for (std::int32_t dof : dofs.first(range))
+          _y[dof] += diagonal * _u[dof];
+      }
+    }
+  }
+}
+
+/// Compute the action y = A u of a bilinear form without assembling
+/// the matrix A. See fem::assemble_action for details.
+/// @param[out] y The result vector, with the layout of the test space
+/// @param[in] a The bilinear form
+/// @param[in,out] u The vector to compute the action on, with the
+/// layout of the trial space
+/// @param[in] bcs Boundary conditions to apply
+/// @param[in] diagonal The diagonal value for rows with a boundary
+/// condition applied
+/// @note Collective MPI operation
+template <typename T>
+void assemble_action(
+    la::Vector<T>& y, const Form<T>& a, la::Vector<T>& u,
+    const std::vector<std::shared_ptr<const DirichletBC<T>>>& bcs = {},
+    T diagonal = 1.0)
 {
-  // Prepare constants and coefficients
   const std::vector<T> constants = pack_constants(a);
   const auto [coeffs, cstride] = pack_coefficients(a);
-
-  // Assemble
-  assemble_matrix(mat_add, a, tcb::make_span(constants), {coeffs, cstride},
-                  dof_marker0, dof_marker1);
+  assemble_action(y, a, u, tcb::make_span(constants), {coeffs, cstride}, bcs,
+                  diagonal);
 }
 
 /// Sets a value to the diagonal of a matrix for specified rows. It is
@@ -333,6 +696,185 @@ void set_diagonal(
   }
 }
 
+/// Incrementally re-assemble a bilinear form into a matrix on a subset
+/// of cells. The element matrix stored in `cache` for each cell is
+/// subtracted and the newly computed element matrix is added via
+/// `mat_add`. Cells without a stored element matrix are treated as
+/// having a zero previous contribution, so calling this function for
+/// all cells with an empty cache assembles the form and populates the
+/// cache. The sparsity of the matrix is unchanged.
+/// @note Only cell integrals are supported. The boundary conditions
+/// must be the same as for the assembly that populated the cache.
+/// @param[in] mat_add The function for adding values into the matrix
+/// @param[in] a The bilinear form
+/// @param[in] cells The modified cells (local to process)
+/// @param[in,out] cache The element matrices from the previous assembly
+/// @param[in] constants Constants that appear in `a`
+/// @param[in] coeffs Coefficients that appear in `a`
+/// @param[in] bcs Boundary conditions to apply. For boundary condition
+///  dofs the row and column are zeroed. The diagonal entry is not set.
+template <typename T>
+void reassemble_matrix(
+    const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
+                            const std::int32_t*, const T*)>& mat_add,
+    const Form<T>& a, const xtl::span<const std::int32_t>& cells,
+    ElementTensorCache<T>& cache, const xtl::span<const T>& constants,
+    const std::pair<xtl::span<const T>, int>& coeffs,
+    const std::vector<std::shared_ptr<const DirichletBC<T>>>& bcs)
+{
+  // Index maps for dof ranges
+  auto map0 = a.function_spaces().at(0)->dofmap()->index_map;
+  auto map1 = a.function_spaces().at(1)->dofmap()->index_map;
+  auto bs0 = a.function_spaces().at(0)->dofmap()->index_map_bs();
+  auto bs1 = a.function_spaces().at(1)->dofmap()->index_map_bs();
+
+  // Build dof markers
+  std::vector<bool> dof_marker0, dof_marker1;
+  assert(map0);
+  std::int32_t dim0 = bs0 * (map0->size_local() + map0->num_ghosts());
+  assert(map1);
+  std::int32_t dim1 = bs1 * (map1->size_local() + map1->num_ghosts());
+  for (std::size_t k = 0; k < bcs.size(); ++k)
+  {
+    assert(bcs[k]);
+    assert(bcs[k]->function_space());
+    if (a.function_spaces().at(0)->contains(*bcs[k]->function_space()))
+    {
+      dof_marker0.resize(dim0, false);
+      bcs[k]->mark_dofs(dof_marker0);
+    }
+
+    if (a.function_spaces().at(1)->contains(*bcs[k]->function_space()))
+    {
+      dof_marker1.resize(dim1, false);
+      bcs[k]->mark_dofs(dof_marker1);
+    }
+  }
+
+  impl::reassemble_matrix(mat_add, a, cells, constants, coeffs.first,
+                          coeffs.second, dof_marker0, dof_marker1, cache);
+}
+
+/// Incrementally re-assemble a bilinear form into a matrix on a subset
+/// of cells. See fem::reassemble_matrix.
+/// @param[in] mat_add The function for adding values into the matrix
+/// @param[in] a The bilinear form
+/// @param[in] cells The modified cells (local to process)
+/// @param[in,out] cache The element matrices from the previous assembly
+/// @param[in] bcs Boundary conditions to apply. For boundary condition
+///  dofs the row and column are zeroed. The diagonal entry is not set.
+template <typename T>
+void reassemble_matrix(
+    const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
+                            const std::int32_t*, const T*)>& mat_add,
+    const Form<T>& a, const xtl::span<const std::int32_t>& cells,
+    ElementTensorCache<T>& cache,
+    const std::vector<std::shared_ptr<const DirichletBC<T>>>& bcs)
+{
+  const std::vector<T> constants = pack_constants(a);
+  const auto [coeffs, cstride] = pack_coefficients(a);
+  reassemble_matrix(mat_add, a, cells, cache, tcb::make_span(constants),
+                    {coeffs, cstride}, bcs);
+}
+
+// -- Systems ----------------------------------------------------------------
+
+/// Assemble a bilinear form into a matrix and a linear form into a
+/// vector in a single pass over the cells, with Dirichlet boundary
+/// conditions applied symmetrically at the element level. The result
+/// is the same as assemble_matrix followed by assemble_vector and
+/// apply_lifting (with x0 = 0 and scale = 1), but for cell integrals
+/// of `a` and `L` with the same id and the same cells the cell loop,
+/// the geometry gather and the kernel calls for the lifting are
+/// shared. Matrix rows and columns of boundary condition dofs are
+/// zeroed, but the diagonal is not set. Ghost contributions to `b` are
+/// not accumulated, and the entries of `b` for boundary condition dofs
+/// hold the assembled and lifted values, as after apply_lifting. The
+/// caller is responsible for finishing the system, e.g. via
+/// la::Vector::scatter_rev, fem::set_bc and fem::set_diagonal.
+/// @param[in] mat_add The function for adding values into the matrix
+/// @param[in,out] b The vector to assemble into. It is not zeroed.
+/// @param[in] a The bilinear form
+/// @param[in] L The linear form. It must have the same test space as
+/// `a`.
+/// @param[in] constants_a Constants that appear in `a`
+/// @param[in] coeffs_a Coefficients that appear in `a`
+/// @param[in] constants_L Constants that appear in `L`
+/// @param[in] coeffs_L Coefficients that appear in `L`
+/// @param[in] bcs Boundary conditions to apply
+template <typename T>
+void assemble_system(
+    const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
+                            const std::int32_t*, const T*)>& mat_add,
+    xtl::span<T> b, const Form<T>& a, const Form<T>& L,
+    const xtl::span<const T>& constants_a,
+    const std::pair<xtl::span<const T>, int>& coeffs_a,
+    const xtl::span<const T>& constants_L,
+    const std::pair<xtl::span<const T>, int>& coeffs_L,
+    const std::vector<std::shared_ptr<const DirichletBC<T>>>& bcs)
+{
+  // Index maps for dof ranges
+  auto map0 = a.function_spaces().at(0)->dofmap()->index_map;
+  auto map1 = a.function_spaces().at(1)->dofmap()->index_map;
+  auto bs0 = a.function_spaces().at(0)->dofmap()->index_map_bs();
+  auto bs1 = a.function_spaces().at(1)->dofmap()->index_map_bs();
+
+  // Build dof markers, and boundary values for the columns
+  std::vector<bool> dof_marker0, dof_marker1;
+  std::vector<T> bc_values1;
+  assert(map0);
+  std::int32_t dim0 = bs0 * (map0->size_local() + map0->num_ghosts());
+  assert(map1);
+  std::int32_t dim1 = bs1 * (map1->size_local() + map1->num_ghosts());
+  for (std::size_t k = 0; k < bcs.size(); ++k)
+  {
+    assert(bcs[k]);
+    assert(bcs[k]->function_space());
+    if (a.function_spaces().at(0)->contains(*bcs[k]->function_space()))
+    {
+      dof_marker0.resize(dim0, false);
+      bcs[k]->mark_dofs(dof_marker0);
+    }
+
+    if (a.function_spaces().at(1)->contains(*bcs[k]->function_space()))
+    {
+      dof_marker1.resize(dim1, false);
+      bc_values1.resize(dim1, 0);
+      bcs[k]->mark_dofs(dof_marker1);
+      bcs[k]->dof_values(bc_values1);
+    }
+  }
+
+  impl::assemble_system(mat_add, b, a, L, constants_a, coeffs_a.first,
+                        coeffs_a.second, constants_L, coeffs_L.first,
+                        coeffs_L.second, dof_marker0, dof_marker1,
+                        xtl::span<const T>(bc_values1));
+}
+
+/// Assemble a bilinear form into a matrix and a linear form into a
+/// vector in a single pass over the cells. See fem::assemble_system.
+/// @param[in] mat_add The function for adding values into the matrix
+/// @param[in,out] b The vector to assemble into. It is not zeroed.
+/// @param[in] a The bilinear form
+/// @param[in] L The linear form. It must have the same test space as
+/// `a`.
+/// @param[in] bcs Boundary conditions to apply
+template <typename T>
+void assemble_system(
+    const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
+                            const std::int32_t*, const T*)>& mat_add,
+    xtl::span<T> b, const Form<T>& a, const Form<T>& L,
+    const std::vector<std::shared_ptr<const DirichletBC<T>>>& bcs)
+{
+  const std::vector<T> constants_a = pack_constants(a);
+  const auto [coeffs_a, cstride_a] = pack_coefficients(a);
+  const std::vector<T> constants_L = pack_constants(L);
+  const auto [coeffs_L, cstride_L] = pack_coefficients(L);
+  assemble_system(mat_add, b, a, L, tcb::make_span(constants_a),
+                  {coeffs_a, cstride_a}, tcb::make_span(constants_L),
+                  {coeffs_L, cstride_L}, bcs);
+}
+
 // -- Setting bcs ------------------------------------------------------------
 
 // FIXME: Move these function elsewhere?
@@ -18,6 +18,8 @@ namespace dolfinx
 #include <dolfinx/fem/Form.h>
 #include <dolfinx/fem/Function.h>
 #include <dolfinx/fem/FunctionSpace.h>
+#include <dolfinx/fem/QuadratureData.h>
+#include <dolfinx/fem/SparsityPatternCache.h>
 #include <dolfinx/fem/assembler.h>
 #include <dolfinx/fem/discreteoperators.h>
 #include <dolfinx/fem/sparsitybuild.h>
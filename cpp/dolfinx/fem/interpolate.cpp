@@ -6,7 +6,12 @@
 
 #include "interpolate.h"
 #include "FiniteElement.h"
+#include <dolfinx/common/log.h>
+#include <dolfinx/geometry/BoundingBoxTree.h>
+#include <dolfinx/geometry/utils.h>
 #include <dolfinx/mesh/Mesh.h>
+#include <algorithm>
+#include <numeric>
 #include <xtensor/xbuilder.hpp>
 #include <xtensor/xtensor.hpp>
 #include <xtensor/xview.hpp>
@@ -64,3 +69,153 @@ fem::interpolation_coords(const fem::FiniteElement& element,
   return x;
 }
 //-----------------------------------------------------------------------------
+fem::NonmatchingInterpolationData::NonmatchingInterpolationData(
+    const FunctionSpace& V, const mesh::Mesh& mesh, double padding)
+    : _comm(MPI_COMM_NULL)
+{
+  MPI_Comm comm = mesh.mpi_comm();
+  const int size = dolfinx::MPI::size(comm);
+
+  // Compute the interpolation points of V on all cells
+  assert(V.mesh());
+  assert(V.element());
+  const int tdim_to = V.mesh()->topology().dim();
+  auto cell_map_to = V.mesh()->topology().index_map(tdim_to);
+  assert(cell_map_to);
+  _cells.resize(cell_map_to->size_local() + cell_map_to->num_ghosts());
+  std::iota(_cells.begin(), _cells.end(), 0);
+  _x = fem::interpolation_coords(*V.element(), *V.mesh(), _cells);
+  const std::size_t num_points = _x.shape(1);
+
+  // Build a bounding box tree for the owned cells of the source mesh,
+  // and a global tree of the process bounding boxes
+  const int tdim = mesh.topology().dim();
+  auto cell_map = mesh.topology().index_map(tdim);
+  assert(cell_map);
+  std::vector<std::int32_t> owned_cells(cell_map->size_local());
+  std::iota(owned_cells.begin(), owned_cells.end(), 0);
+  geometry::BoundingBoxTree tree(mesh, tdim, owned_cells, padding);
+  geometry::BoundingBoxTree global_tree = tree.create_global_tree(comm);
+
+  // Send each point to the processes whose bounding box contains it
+  std::vector<std::vector<std::int32_t>> candidates(size);
+  for (std::size_t p = 0; p < num_points; ++p)
+  {
+    const std::array<double, 3> xp = {_x(0, p), _x(1, p), _x(2, p)};
+    for (int r : geometry::compute_collisions(global_tree, xp))
+      candidates[r].push_back(p);
+  }
+
+  std::vector<double> send_x;
+  std::vector<std::int32_t> send_offsets(1, 0);
+  for (int r = 0; r < size; ++r)
+  {
+    for (std::int32_t p : candidates[r])
+      for (int j = 0; j < 3; ++j)
+        send_x.push_back(_x(j, p));
+    send_offsets.push_back(send_x.size());
+  }
+  const graph::AdjacencyList<double> recv_x = dolfinx::MPI::all_to_all(
+      comm, graph::AdjacencyList<double>(std::move(send_x),
+                                         std::move(send_offsets)));
+
+  // Find the owned cell (if any) that contains each received point
+  std::vector<std::int32_t> found_cells(recv_x.array().size() / 3, -1);
+  for (std::size_t i = 0; tree.num_bboxes() > 0 and i < found_cells.size();
+       ++i)
+  {
+    const std::array<double, 3> xp
+        = {recv_x.array()[3 * i], recv_x.array()[3 * i + 1],
+           recv_x.array()[3 * i + 2]};
+    const std::vector<int> leaves = geometry::compute_collisions(tree, xp);
+    const std::vector<std::int32_t> cells
+        = geometry::select_colliding_cells(mesh, leaves, xp, 1);
+    if (!cells.empty())
+      found_cells[i] = cells.front();
+  }
+
+  // Return the search results to the requesting processes
+  std::vector<std::int32_t> found_offsets(recv_x.offsets());
+  std::for_each(found_offsets.begin(), found_offsets.end(),
+                [](std::int32_t& offset) { offset /= 3; });
+  const graph::AdjacencyList<std::int32_t> found = dolfinx::MPI::all_to_all(
+      comm, graph::AdjacencyList<std::int32_t>(found_cells, found_offsets));
+
+  // The owner of each point is the lowest ranked process that found it
+  std::vector<int> owner(num_points, -1);
+  for (int r = 0; r < size; ++r)
+  {
+    auto found_r = found.links(r);
+    for (std::size_t i = 0; i < found_r.size(); ++i)
+    {
+      if (const std::int32_t p = candidates[r][i];
+          owner[p] == -1 and found_r[i] >= 0)
+      {
+        owner[p] = r;
+      }
+    }
+  }
+
+  const std::size_t num_lost = std::count(owner.begin(), owner.end(), -1);
+  if (num_lost > 0)
+  {
+    LOG(WARNING) << num_lost
+                 << " interpolation points were not found in the source mesh.";
+  }
+
+  // Tell each candidate process which of the points it was sent (by
+  // position in the message) it should evaluate. The values are
+  // received from the owners in order of rank.
+  std::vector<std::int32_t> accepted, accepted_offsets(1, 0);
+  std::vector<int> src_ranks;
+  for (int r = 0; r < size; ++r)
+  {
+    for (std::size_t i = 0; i < candidates[r].size(); ++i)
+    {
+      if (const std::int32_t p = candidates[r][i]; owner[p] == r)
+      {
+        accepted.push_back(i);
+        _point_indices.push_back(p);
+      }
+    }
+    if (accepted.size() > std::size_t(accepted_offsets.back()))
+      src_ranks.push_back(r);
+    accepted_offsets.push_back(accepted.size());
+  }
+  const graph::AdjacencyList<std::int32_t> to_eval = dolfinx::MPI::all_to_all(
+      comm, graph::AdjacencyList<std::int32_t>(std::move(accepted),
+                                               std::move(accepted_offsets)));
+
+  // Build the list of points to evaluate, grouped by requesting process
+  std::vector<int> dest_ranks;
+  std::vector<double> x_eval;
+  _eval_offsets = {0};
+  for (int r = 0; r < size; ++r)
+  {
+    auto positions = to_eval.links(r);
+    if (positions.empty())
+      continue;
+
+    dest_ranks.push_back(r);
+    auto x_r = recv_x.links(r);
+    const std::int32_t* cells_r = found_cells.data() + found_offsets[r];
+    for (std::int32_t i : positions)
+    {
+      x_eval.insert(x_eval.end(), std::next(x_r.begin(), 3 * i),
+                    std::next(x_r.begin(), 3 * (i + 1)));
+      _cells_eval.push_back(cells_r[i]);
+    }
+    _eval_offsets.push_back(_cells_eval.size());
+  }
+  _x_eval = xt::adapt(x_eval, std::vector<std::size_t>{_cells_eval.size(), 3});
+
+  // Create the neighbourhood communicator (evaluating processes ->
+  // requesting processes)
+  MPI_Comm neighbor_comm;
+  MPI_Dist_graph_create_adjacent(comm, src_ranks.size(), src_ranks.data(),
+                                 MPI_UNWEIGHTED, dest_ranks.size(),
+                                 dest_ranks.data(), MPI_UNWEIGHTED,
+                                 MPI_INFO_NULL, false, &neighbor_comm);
+  _comm = dolfinx::MPI::Comm(neighbor_comm, false);
+}
+//-----------------------------------------------------------------------------
@@ -7,14 +7,19 @@
 #pragma once
 
 #include "FunctionSpace.h"
+#include <dolfinx/common/MPI.h>
 #include <dolfinx/fem/DofMap.h>
 #include <dolfinx/fem/FiniteElement.h>
+#include <dolfinx/graph/AdjacencyList.h>
 #include <dolfinx/mesh/Mesh.h>
+#include <algorithm>
 #include <functional>
 #include <numeric>
 #include <variant>
+#include <vector>
 #include <xtensor/xadapt.hpp>
 #include <xtensor/xarray.hpp>
+#include <xtensor/xbuilder.hpp>
 #include <xtensor/xtensor.hpp>
 #include <xtensor/xview.hpp>
 #include <xtl/xspan.hpp>
@@ -39,6 +44,83 @@ xt::xtensor<double, 2>
 interpolation_coords(const fem::FiniteElement& element, const mesh::Mesh& mesh,
                      const xtl::span<const std::int32_t>& cells);
 
+/// Data for interpolation into a finite element space from a Function
+/// on a different (non-matching) mesh. For each interpolation point of
+/// the destination space, the process and the cell of the source mesh
+/// that contain the point are located once, using a bounding box tree
+/// of the source mesh and a global tree of the process bounding boxes.
+/// Interpolation with this data is then an evaluation of the source
+/// Function at the points located on this process followed by a single
+/// neighbourhood exchange of the values, so the data should be re-used
+/// for repeated interpolation between the same pair of meshes.
+class NonmatchingInterpolationData
+{
+public:
+  /// Locate the interpolation points of a function space in a mesh
+  /// @note Collective MPI operation on the communicator of `mesh`
+  /// @param[in] V The function space to interpolate into
+  /// @param[in] mesh The mesh of the Functions to interpolate from
+  /// @param[in] padding Padding of the cell bounding boxes in the
+  /// source mesh, used to locate points that lie on a cell boundary
+  NonmatchingInterpolationData(const FunctionSpace& V, const mesh::Mesh& mesh,
+                               double padding = 1.0e-8);
+
+  /// Interpolation points of the destination space, shape (3,
+  /// num_points)
+  const xt::xtensor<double, 2>& x() const { return _x; }
+
+  /// The cells of the destination mesh for which the interpolation
+  /// points have been computed
+  const std::vector<std::int32_t>& cells() const { return _cells; }
+
+  /// The points at which the source Function is evaluated on this
+  /// process, shape (num_eval_points, 3). The points are grouped by the
+  /// process that requested them.
+  const xt::xtensor<double, 2>& x_eval() const { return _x_eval; }
+
+  /// The cells of the source mesh (local to this process) that contain
+  /// the points in x_eval
+  const std::vector<std::int32_t>& cells_eval() const { return _cells_eval; }
+
+  /// Offsets into x_eval for each destination process of comm()
+  const std::vector<std::int32_t>& eval_offsets() const
+  {
+    return _eval_offsets;
+  }
+
+  /// The index of the interpolation point for each value that is
+  /// received, in the order of receipt. Interpolation points that are
+  /// not located in the source mesh do not appear.
+  const std::vector<std::int32_t>& point_indices() const
+  {
+    return _point_indices;
+  }
+
+  /// Neighbourhood communicator. Its destinations are the processes
+  /// that requested evaluations from this process and its sources are
+  /// the processes that evaluate the interpolation points of this
+  /// process.
+  MPI_Comm comm() const { return _comm.comm(); }
+
+private:
+  // Interpolation points and destination cells
+  xt::xtensor<double, 2> _x;
+  std::vector<std::int32_t> _cells;
+
+  // Points evaluated on this process, their source cells and the
+  // offsets for each requesting process
+  xt::xtensor<double, 2> _x_eval;
+  std::vector<std::int32_t> _cells_eval;
+  std::vector<std::int32_t> _eval_offsets;
+
+  // Interpolation point index for each received value
+  std::vector<std::int32_t> _point_indices;
+
+  // Neighbourhood communicator (evaluating processes -> requesting
+  // processes)
+  dolfinx::MPI::Comm _comm;
+};
+
 /// Interpolate an expression in a finite element space
 ///
 /// @param[out] u The function to interpolate into
@@ -276,8 +358,61 @@ void interpolate_c(
   interpolate<T>(u, fn, x, cells);
 }
 
-/// Interpolate from one finite element Function to another on the same
-/// mesh
+/// Interpolate from one finite element Function to another on a
+/// different (non-matching) mesh, using precomputed interpolation data.
+/// Interpolation points that are not located in the mesh of `v` are
+/// given the value zero.
+/// @note Collective MPI operation
+/// @param[out] u The function to interpolate into
+/// @param[in] v The function to be interpolated
+/// @param[in] data Interpolation data for the space of `u` and the
+/// mesh of `v`
+template <typename T>
+void interpolate(Function<T>& u, const Function<T>& v,
+                 const NonmatchingInterpolationData& data)
+{
+  assert(u.function_space());
+  assert(v.function_space());
+  const std::size_t value_size = u.function_space()->element()->value_size();
+  if (std::size_t(v.function_space()->element()->value_size()) != value_size)
+    throw std::runtime_error("Functions must have the same value size.");
+
+  // Evaluate v at the points located on this process
+  const xt::xtensor<double, 2>& x_eval = data.x_eval();
+  xt::xtensor<T, 2> values({x_eval.shape(0), value_size});
+  v.eval(x_eval, data.cells_eval(), values);
+
+  // Send the values to the processes that requested them
+  std::vector<std::int32_t> send_offsets(data.eval_offsets());
+  std::transform(send_offsets.begin(), send_offsets.end(),
+                 send_offsets.begin(),
+                 [value_size](std::int32_t offset)
+                 { return offset * value_size; });
+  const graph::AdjacencyList<T> recv_values
+      = dolfinx::MPI::neighbor_all_to_all(
+          data.comm(),
+          graph::AdjacencyList<T>(std::vector<T>(values.begin(), values.end()),
+                                  std::move(send_offsets)));
+
+  // Arrange the received values by interpolation point
+  const xt::xtensor<double, 2>& x = data.x();
+  const std::vector<std::int32_t>& point_indices = data.point_indices();
+  xt::xarray<T> point_values = xt::zeros<T>({value_size, x.shape(1)});
+  const std::vector<T>& _recv_values = recv_values.array();
+  for (std::size_t i = 0; i < point_indices.size(); ++i)
+    for (std::size_t j = 0; j < value_size; ++j)
+      point_values(j, point_indices[i]) = _recv_values[i * value_size + j];
+
+  interpolate<T>(
+      u, [&point_values](const xt::xtensor<double, 2>&)
+      { return point_values; },
+      x, data.cells());
+}
+
+/// Interpolate from one finite element Function to another. If the
+/// Functions are defined on different meshes, the interpolation points
+/// are located using NonmatchingInterpolationData. Create and re-use
+/// this data for repeated interpolation between non-matching meshes.
 /// @param[out] u The function to interpolate into
 /// @param[in] v The function to be interpolated
 template <typename T>
@@ -289,8 +424,11 @@ void interpolate(Function<T>& u, const Function<T>& v)
   assert(v.function_space()->mesh());
   if (mesh != v.function_space()->mesh())
   {
-    throw std::runtime_error(
-        "Interpolation on different meshes not supported (yet).");
+    // --- Different meshes
+    interpolate(u, v,
+                NonmatchingInterpolationData(*u.function_space(),
+                                             *v.function_space()->mesh()));
+    return;
   }
 
   const int tdim = mesh->topology().dim();
@@ -351,8 +489,8 @@ void interpolate(Function<T>& u, const Function<T>& v)
     const auto dofmap_u = u.function_space()->dofmap();
     const auto dofmap_v = v.function_space()->dofmap();
 
-    // Create interpolation operator
-    const xt::xtensor<double, 2> i_m
+    // Create interpolation operator, stored with the scalar type of u
+    const xt::xtensor<T, 2> i_m
         = element_to->create_interpolation_operator(*element_from);
 
     // Get block sizes and dof transformation operators
@@ -363,13 +501,92 @@ void interpolate(Function<T>& u, const Function<T>& v)
     const auto apply_inverse_dof_transform
         = element_to->get_dof_transformation_function<T>(true, true, false);
 
-    // Creat working array
+    // Split cells into those that need dof transformations and those
+    // that do not. Cells with zero permutation info have identity
+    // transformations.
+    const int num_cells = map->size_local() + map->num_ghosts();
+    std::vector<std::int32_t> cells_batched, cells_transformed;
+    if (cell_info.empty())
+    {
+      cells_batched.resize(num_cells);
+      std::iota(cells_batched.begin(), cells_batched.end(), 0);
+    }
+    else
+    {
+      for (std::int32_t c = 0; c < num_cells; ++c)
+      {
+        if (cell_info[c] == 0)
+          cells_batched.push_back(c);
+        else
+          cells_transformed.push_back(c);
+      }
+    }
+
+    const std::size_t dim_to = i_m.shape(0);
+    const std::size_t dim_from = i_m.shape(1);
+
+    // Interpolate cells without transformations in batches. The local
+    // dofs for a batch of cells are gathered row-wise into V and U =
+    // V i_m^T is computed with a blocked product so that each block of
+    // i_m is reused across all cells in the batch.
+    constexpr std::size_t batch_size = 64;
+    constexpr std::size_t block = 32;
+    std::vector<T> V(batch_size * dim_from), U(batch_size * dim_to);
+    for (std::size_t c0 = 0; c0 < cells_batched.size(); c0 += batch_size)
+    {
+      const std::size_t nb = std::min(batch_size, cells_batched.size() - c0);
+      xtl::span<const std::int32_t> batch(cells_batched.data() + c0, nb);
+
+      // Gather local dofs of v
+      for (std::size_t b = 0; b < nb; ++b)
+      {
+        xtl::span<const std::int32_t> dofs_v = dofmap_v->cell_dofs(batch[b]);
+        T* _V = V.data() + b * dim_from;
+        for (std::size_t i = 0; i < dofs_v.size(); i++)
+          for (int k = 0; k < v_bs; k++)
+            _V[v_bs * i + k] = v_array[v_bs * dofs_v[i] + k];
+      }
+
+      // U = V i_m^T
+      std::fill_n(U.begin(), nb * dim_to, 0);
+      for (std::size_t j0 = 0; j0 < dim_from; j0 += block)
+      {
+        const std::size_t j1 = std::min(j0 + block, dim_from);
+        for (std::size_t i0 = 0; i0 < dim_to; i0 += block)
+        {
+          const std::size_t i1 = std::min(i0 + block, dim_to);
+          for (std::size_t b = 0; b < nb; ++b)
+          {
+            const T* _V = V.data() + b * dim_from;
+            T* _U = U.data() + b * dim_to;
+            for (std::size_t i = i0; i < i1; ++i)
+            {
+              const T* _i_m = i_m.data() + i * dim_from;
+              T acc = 0;
+              for (std::size_t j = j0; j < j1; ++j)
+                acc += _i_m[j] * _V[j];
+              _U[i] += acc;
+            }
+          }
+        }
+      }
+
+      // Scatter local dofs into u
+      for (std::size_t b = 0; b < nb; ++b)
+      {
+        xtl::span<const std::int32_t> dofs_u = dofmap_u->cell_dofs(batch[b]);
+        const T* _U = U.data() + b * dim_to;
+        for (std::size_t i = 0; i < dofs_u.size(); ++i)
+          for (int k = 0; k < u_bs; ++k)
+            u_array[u_bs * dofs_u[i] + k] = _U[u_bs * i + k];
+      }
+    }
+
+    // Interpolate remaining cells one at a time, applying dof
+    // transformations
     std::vector<T> v_local(element_from->space_dimension());
     std::vector<T> u_local(element_to->space_dimension());
-
-    // Iterate over mesh and interpolate on each cell
-    const int num_cells = map->size_local() + map->num_ghosts();
-    for (int c = 0; c < num_cells; ++c)
+    for (std::int32_t c : cells_transformed)
     {
       xtl::span<const std::int32_t> dofs_v = dofmap_v->cell_dofs(c);
       for (std::size_t i = 0; i < dofs_v.size(); i++)
@@ -378,11 +595,10 @@ void interpolate(Function<T>& u, const Function<T>& v)
 
       apply_dof_transformation(v_local, cell_info, c, 1);
 
-      // FIXME: Get compile-time ranges from Basix
       // Apply interpolation operator
       std::fill(u_local.begin(), u_local.end(), 0);
-      for (std::size_t i = 0; i < i_m.shape(0); ++i)
-        for (std::size_t j = 0; j < i_m.shape(1); ++j)
+      for (std::size_t i = 0; i < dim_to; ++i)
+        for (std::size_t j = 0; j < dim_from; ++j)
           u_local[i] += i_m(i, j) * v_local[j];
 
       apply_inverse_dof_transform(u_local, cell_info, c, 1);
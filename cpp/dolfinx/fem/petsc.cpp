@@ -12,6 +12,7 @@
 #include <dolfinx/la/PETScMatrix.h>
 #include <dolfinx/la/PETScVector.h>
 #include <dolfinx/la/SparsityPattern.h>
+#include <dolfinx/la/Vector.h>
 #include <xtl/xspan.hpp>
 
 using namespace dolfinx;
@@ -29,6 +30,143 @@ Mat dolfinx::fem::create_matrix(const Form<PetscScalar>& a,
   return la::create_petsc_matrix(a.mesh()->mpi_comm(), pattern, type);
 }
 //-----------------------------------------------------------------------------
+namespace
+{
+// Context for a shell matrix that computes the action of a bilinear
+// form
+struct ShellContext
+{
+  std::shared_ptr<const fem::Form<PetscScalar>> a;
+  std::vector<std::shared_ptr<const fem::DirichletBC<PetscScalar>>> bcs;
+  PetscScalar diagonal;
+  la::Vector<PetscScalar> u, y;
+};
+
+// Compute y = A x for a shell matrix. Errors are returned to PETSc as
+// error codes since exceptions must not propagate through PETSc.
+PetscErrorCode shell_mult(Mat A, Vec x, Vec y)
+{
+  try
+  {
+    ShellContext* ctx = nullptr;
+    PetscErrorCode ierr = MatShellGetContext(A, &ctx);
+    if (ierr != 0)
+      la::petsc_error(ierr, __FILE__, "MatShellGetContext");
+    assert(ctx);
+
+    // Copy owned entries of x into vector with ghosts
+    const PetscScalar* x_array = nullptr;
+    ierr = VecGetArrayRead(x, &x_array);
+    if (ierr != 0)
+      la::petsc_error(ierr, __FILE__, "VecGetArrayRead");
+    const std::int32_t size_u = ctx->u.bs() * ctx->u.map()->size_local();
+    std::copy_n(x_array, size_u, ctx->u.mutable_array().begin());
+    ierr = VecRestoreArrayRead(x, &x_array);
+    if (ierr != 0)
+      la::petsc_error(ierr, __FILE__, "VecRestoreArrayRead");
+
+    fem::assemble_action(ctx->y, *ctx->a, ctx->u, ctx->bcs, ctx->diagonal);
+
+    // Copy owned entries of result into y
+    PetscScalar* y_array = nullptr;
+    ierr = VecGetArray(y, &y_array);
+    if (ierr != 0)
+      la::petsc_error(ierr, __FILE__, "VecGetArray");
+    const std::int32_t size_y = ctx->y.bs() * ctx->y.map()->size_local();
+    std::copy_n(ctx->y.array().begin(), size_y, y_array);
+    ierr = VecRestoreArray(y, &y_array);
+    if (ierr != 0)
+      la::petsc_error(ierr, __FILE__, "VecRestoreArray");
+  }
+  catch (const std::exception& e)
+  {
+    SETERRQ1(PETSC_COMM_SELF, PETSC_ERR_LIB, "%s", e.what());
+  }
+
+  return 0;
+}
+
+// Destroy context of a shell matrix
+PetscErrorCode shell_destroy(Mat A)
+{
+  try
+  {
+    ShellContext* ctx = nullptr;
+    PetscErrorCode ierr = MatShellGetContext(A, &ctx);
+    if (ierr != 0)
+      la::petsc_error(ierr, __FILE__, "MatShellGetContext");
+    delete ctx;
+  }
+  catch (const std::exception& e)
+  {
+    SETERRQ1(PETSC_COMM_SELF, PETSC_ERR_LIB, "%s", e.what());
+  }
+
+  return 0;
+}
+} // namespace
+//-----------------------------------------------------------------------------
+Mat fem::create_matrix_shell(
+    std::shared_ptr<const Form<PetscScalar>> a,
+    const std::vector<std::shared_ptr<const DirichletBC<PetscScalar>>>& bcs,
+    PetscScalar diagonal)
+{
+  assert(a);
+  if (a->rank() != 2)
+  {
+    throw std::runtime_error(
+        "Cannot create shell matrix. Form is not a bilinear form");
+  }
+
+  std::array<std::shared_ptr<const fem::DofMap>, 2> dofmaps
+      = {a->function_spaces().at(0)->dofmap(),
+         a->function_spaces().at(1)->dofmap()};
+  std::array<std::int32_t, 2> size_local;
+  std::array<std::int64_t, 2> size_global;
+  for (int i = 0; i < 2; ++i)
+  {
+    assert(dofmaps[i]);
+    const int bs = dofmaps[i]->index_map_bs();
+    size_local[i] = bs * dofmaps[i]->index_map->size_local();
+    size_global[i] = bs * dofmaps[i]->index_map->size_global();
+  }
+
+  auto ctx = new ShellContext{
+      a, bcs, diagonal,
+      la::Vector<PetscScalar>(dofmaps[1]->index_map,
+                              dofmaps[1]->index_map_bs()),
+      la::Vector<PetscScalar>(dofmaps[0]->index_map,
+                              dofmaps[0]->index_map_bs())};
+
+  Mat A;
+  PetscErrorCode ierr
+      = MatCreateShell(a->mesh()->mpi_comm(), size_local[0], size_local[1],
+                       size_global[0], size_global[1], ctx, &A);
+  if (ierr != 0)
+  {
+    delete ctx;
+    la::petsc_error(ierr, __FILE__, "MatCreateShell");
+  }
+
+  // Set the destroy operation first so that ctx is owned by A
+  ierr = MatShellSetOperation(A, MATOP_DESTROY, (void (*)(void))shell_destroy);
+  if (ierr != 0)
+  {
+    delete ctx;
+    MatDestroy(&A);
+    la::petsc_error(ierr, __FILE__, "MatShellSetOperation");
+  }
+
+  ierr = MatShellSetOperation(A, MATOP_MULT, (void (*)(void))shell_mult);
+  if (ierr != 0)
+  {
+    MatDestroy(&A);
+    la::petsc_error(ierr, __FILE__, "MatShellSetOperation");
+  }
+
+  return A;
+}
+//-----------------------------------------------------------------------------
 Mat fem::create_matrix_block(
     const std::vector<std::vector<const fem::Form<PetscScalar>*>>& a,
     const std::string& type)
@@ -36,6 +36,24 @@ class FunctionSpace;
 Mat create_matrix(const Form<PetscScalar>& a,
                   const std::string& type = std::string());
 
+/// Create a PETSc shell matrix (MATSHELL) that computes the action of
+/// a bilinear form on-the-fly, without assembling the matrix (see
+/// fem::assemble_action). The returned Mat can be wrapped in a
+/// la::PETScOperator for use with la::PETScKrylovSolver. Coefficients
+/// and constants are packed each time the action is computed.
+/// @param[in] a A bilinear form
+/// @param[in] bcs Boundary conditions to apply. For boundary condition
+/// dofs the row and column are zeroed.
+/// @param[in] diagonal The diagonal value for rows with a boundary
+/// condition applied
+/// @return A shell matrix with the parallel layout of the bilinear
+/// form. The caller is responsible for destroying the Mat object.
+Mat create_matrix_shell(
+    std::shared_ptr<const Form<PetscScalar>> a,
+    const std::vector<std::shared_ptr<const DirichletBC<PetscScalar>>>& bcs
+    = {},
+    PetscScalar diagonal = 1.0);
+
 /// Initialise a monolithic matrix for an array of bilinear forms
 /// @param[in] a Rectangular array of bilinear forms. The `a(i, j)` form
 /// will correspond to the `(i, j)` block in the returned matrix
@@ -9,14 +9,26 @@
 #include "CoordinateElement.h"
 #include "DofMap.h"
 #include "ElementDofLayout.h"
+#include "QuadratureData.h"
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <dolfinx/common/MPI.h>
 #include <dolfinx/fem/Form.h>
 #include <dolfinx/fem/Function.h>
 #include <dolfinx/la/SparsityPattern.h>
+#include <dolfinx/mesh/Geometry.h>
 #include <dolfinx/mesh/cell_types.h>
+#include <exception>
 #include <functional>
+#include <limits>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <numeric>
 #include <set>
 #include <string>
+#include <thread>
 #include <ufc.h>
 #include <utility>
 #include <vector>
@@ -437,19 +449,263 @@ fem::FunctionSpace create_functionspace(
 
 namespace impl
 {
+/// Execute a function over entities, one colour at a time, with the
+/// entities of each colour split into contiguous blocks that are
+/// processed concurrently by a pool of threads. The threads are created
+/// once and a colour is completed by all threads before the next colour
+/// is started.
+///
+/// If @p fn throws on any thread, the remaining colours are skipped,
+/// all threads are joined and the first exception is rethrown on the
+/// calling thread.
+/// @param[in] entities The entities, e.g. cells or (cell, local facet)
+/// pairs
+/// @param[in] colouring The positions in @p entities for each colour
+/// @param[in] num_threads The number of threads
+/// @param[in] fn The function to execute. It is called with a list of
+/// entities that all have the same colour.
+template <typename E, typename F>
+void for_each_colour(const xtl::span<const E>& entities,
+                     const graph::AdjacencyList<std::int32_t>& colouring,
+                     int num_threads, const F& fn)
+{
+  if (num_threads < 1)
+    throw std::runtime_error("Number of threads must be positive.");
+
+  // Barrier state. The number of participating threads is set once the
+  // threads have been created, which releases the threads.
+  std::mutex mutex;
+  std::condition_variable cv;
+  int num_participants = 0, num_waiting = 0;
+  std::size_t generation = 0;
+  bool failed = false;
+  std::exception_ptr error;
+
+  // Wait for all threads, and return true if an error has occurred
+  auto barrier = [&]()
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&num_participants]() { return num_participants > 0; });
+    const std::size_t g = generation;
+    if (++num_waiting == num_participants)
+    {
+      num_waiting = 0;
+      ++generation;
+      cv.notify_all();
+    }
+    else
+      cv.wait(lock, [&generation, g]() { return generation != g; });
+    return failed;
+  };
+
+  auto record_error = [&]()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!error)
+      error = std::current_exception();
+    failed = true;
+  };
+
+  // Process block t of each colour
+  auto work = [&](int t)
+  {
+    std::vector<E> e;
+    bool stop = barrier();
+    for (int c = 0; c < colouring.num_nodes(); ++c)
+    {
+      if (!stop)
+      {
+        try
+        {
+          auto positions = colouring.links(c);
+          const std::array<std::int64_t, 2> range
+              = dolfinx::MPI::local_range(t, positions.size(), num_threads);
+          e.resize(range[1] - range[0]);
+          for (std::size_t j = 0; j < e.size(); ++j)
+            e[j] = entities[positions[range[0] + j]];
+          fn(xtl::span<const E>(e));
+        }
+        catch (...)
+        {
+          record_error();
+        }
+      }
+      stop = barrier();
+    }
+  };
+
+  // Create the worker threads and process the first block on the
+  // calling thread. If thread creation fails, the threads that were
+  // created skip all colours.
+  std::vector<std::thread> threads;
+  try
+  {
+    threads.reserve(num_threads - 1);
+    for (int t = 1; t < num_threads; ++t)
+      threads.emplace_back(work, t);
+  }
+  catch (...)
+  {
+    record_error();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    num_participants = threads.size() + 1;
+  }
+  cv.notify_all();
+  work(0);
+  for (std::thread& t : threads)
+    t.join();
+
+  if (error)
+    std::rethrow_exception(error);
+}
+
+/// Get the coordinate dofs of a cell. If the cell geometry cache is
+/// populated the cached (contiguous) data is used directly, otherwise
+/// the coordinate dofs are gathered into a work array.
+/// @param[in] x_cache Cached cell coordinates (empty if not cached)
+/// @param[in] x_dofmap The geometry dofmap
+/// @param[in] x_g The geometry coordinates
+/// @param[in] c The cell index
+/// @param[in,out] coordinate_dofs Work array (size 3 * num_dofs_g)
+/// @return Pointer to the coordinate dofs of cell `c`
+inline const double*
+get_cell_coordinates(const xtl::span<const double>& x_cache,
+                     const graph::AdjacencyList<std::int32_t>& x_dofmap,
+                     const xt::xtensor<double, 2>& x_g, std::int32_t c,
+                     const xtl::span<double>& coordinate_dofs)
+{
+  if (!x_cache.empty())
+    return x_cache.data() + c * coordinate_dofs.size();
+
+  auto x_dofs = x_dofmap.links(c);
+  for (std::size_t i = 0; i < x_dofs.size(); ++i)
+  {
+    std::copy_n(xt::row(x_g, x_dofs[i]).begin(), 3,
+                std::next(coordinate_dofs.begin(), 3 * i));
+  }
+  return coordinate_dofs.data();
+}
+
+/// Gather the coordinate dofs of the two cells attached to an interior
+/// facet into a work array, with the coordinates of the first cell
+/// followed by the coordinates of the second cell
+/// @param[in] x_cache Cached cell coordinates (empty if not cached)
+/// @param[in] x_dofmap The geometry dofmap
+/// @param[in] x_g The geometry coordinates
+/// @param[in] cells The two cells
+/// @param[in,out] coordinate_dofs Work array (size 2 * 3 * num_dofs_g)
+inline void
+get_cell_pair_coordinates(const xtl::span<const double>& x_cache,
+                          const graph::AdjacencyList<std::int32_t>& x_dofmap,
+                          const xt::xtensor<double, 2>& x_g,
+                          const std::array<std::int32_t, 2>& cells,
+                          const xtl::span<double>& coordinate_dofs)
+{
+  const std::size_t size = coordinate_dofs.size() / 2;
+  for (int k = 0; k < 2; ++k)
+  {
+    xtl::span<double> x_k = coordinate_dofs.subspan(k * size, size);
+    const double* x
+        = get_cell_coordinates(x_cache, x_dofmap, x_g, cells[k], x_k);
+    if (x != x_k.data())
+      std::copy_n(x, size, x_k.begin());
+  }
+}
+
+/// Gather the packed coefficients of the two cells attached to an
+/// interior facet into the layout w[coefficient][restriction][dof]
+/// used by interior facet kernels
+/// @param[in] coeffs The packed coefficients for all cells
+/// @param[in] cstride Number of coefficient entries per cell
+/// @param[in] offsets The offset of each coefficient in the packed data
+/// for a cell
+/// @param[in] cells The two cells
+/// @param[out] coeff_array The restricted coefficients (size 2 *
+/// cstride)
+template <typename T>
+void get_cell_pair_coefficients(const xtl::span<const T>& coeffs,
+                                int cstride,
+                                const xtl::span<const int>& offsets,
+                                const std::array<std::int32_t, 2>& cells,
+                                const xtl::span<T>& coeff_array)
+{
+  const T* coeff_cell0 = coeffs.data() + cells[0] * cstride;
+  const T* coeff_cell1 = coeffs.data() + cells[1] * cstride;
+  for (std::size_t i = 0; i < offsets.size() - 1; ++i)
+  {
+    const int num_entries = offsets[i + 1] - offsets[i];
+    std::copy_n(coeff_cell0 + offsets[i], num_entries,
+                std::next(coeff_array.begin(), 2 * offsets[i]));
+    std::copy_n(coeff_cell1 + offsets[i], num_entries,
+                std::next(coeff_array.begin(), offsets[i + 1] + offsets[i]));
+  }
+}
+
+/// Gather the coordinate dofs and packed coefficients for a batch of
+/// cells into interleaved (struct-of-arrays) buffers, i.e. entry j for
+/// cell k of the batch is stored at position j * batch_size + k. If
+/// there are fewer cells than the batch size, the data for the last
+/// cell is repeated to fill the batch.
+/// @param[in] cells The cells in the batch
+/// @param[in] geometry The mesh geometry
+/// @param[in] coeffs Packed coefficients for all cells
+/// @param[in] cstride Number of coefficient entries per cell
+/// @param[in] batch_size The batch size
+/// @param[out] coordinate_dofs Interleaved coordinate dofs (size 3 *
+/// num_dofs_g * batch_size)
+/// @param[out] coeffs_batch Interleaved coefficients (size cstride *
+/// batch_size)
+template <typename T>
+void gather_cell_batch(const xtl::span<const std::int32_t>& cells,
+                       const mesh::Geometry& geometry,
+                       const xtl::span<const T>& coeffs, int cstride,
+                       int batch_size, const xtl::span<double>& coordinate_dofs,
+                       const xtl::span<T>& coeffs_batch)
+{
+  assert(!cells.empty());
+  assert((int)cells.size() <= batch_size);
+  const graph::AdjacencyList<std::int32_t>& x_dofmap = geometry.dofmap();
+  const xt::xtensor<double, 2>& x_g = geometry.x();
+  const xtl::span<const double> x_cache = geometry.cell_coordinates();
+  const std::size_t num_dofs_g = x_dofmap.num_links(0);
+  for (int k = 0; k < batch_size; ++k)
+  {
+    const std::int32_t c = cells[std::min<std::size_t>(k, cells.size() - 1)];
+    if (!x_cache.empty())
+    {
+      const double* x_c = x_cache.data() + 3 * num_dofs_g * c;
+      for (std::size_t i = 0; i < 3 * num_dofs_g; ++i)
+        coordinate_dofs[i * batch_size + k] = x_c[i];
+    }
+    else
+    {
+      auto x_dofs = x_dofmap.links(c);
+      for (std::size_t i = 0; i < x_dofs.size(); ++i)
+        for (int j = 0; j < 3; ++j)
+          coordinate_dofs[(3 * i + j) * batch_size + k] = x_g(x_dofs[i], j);
+    }
+    for (int j = 0; j < cstride; ++j)
+      coeffs_batch[j * batch_size + k] = coeffs[c * cstride + j];
+  }
+}
+
 // Pack a single coefficient
 template <typename T, int _bs = -1>
 void pack_coefficient(
     const xtl::span<T>& c, int cstride, const xtl::span<const T>& v,
     const xtl::span<const std::uint32_t>& cell_info, const fem::DofMap& dofmap,
-    std::int32_t num_cells, std::int32_t offset, int space_dim,
+    const xtl::span<const std::int32_t>& cells, std::int32_t offset,
+    int space_dim,
     const std::function<void(const xtl::span<T>&,
                              const xtl::span<const std::uint32_t>&,
                              std::int32_t, int)>& transformation)
 {
   const int bs = dofmap.bs();
   assert(_bs < 0 or _bs == bs);
-  for (std::int32_t cell = 0; cell < num_cells; ++cell)
+  for (std::int32_t cell : cells)
   {
     auto dofs = dofmap.cell_dofs(cell);
     auto cell_coeff = c.subspan(cell * cstride + offset, space_dim);
@@ -474,94 +730,179 @@ void pack_coefficient(
     transformation(cell_coeff, cell_info, cell, 1);
   }
 }
-} // namespace impl
 
-// NOTE: This is subject to change
-/// Pack coefficients of u of generic type U ready for assembly
+/// Quadrature point data used for the coefficients of a form
+template <typename T>
+const std::map<int, std::shared_ptr<const QuadratureData<T>>>&
+get_quadrature_data(const Form<T>& form)
+{
+  return form.quadrature_data();
+}
+
+/// Quadrature point data used for the coefficients of u of generic
+/// type U. Only forms support quadrature point data.
 template <typename U>
-std::pair<std::vector<typename U::scalar_type>, int>
-pack_coefficients(const U& u)
+std::map<int, std::shared_ptr<const QuadratureData<typename U::scalar_type>>>
+get_quadrature_data(const U&)
+{
+  return {};
+}
+
+/// Pack a selection of the coefficients of u of generic type U for a
+/// subset of cells into an existing array
+/// @param[in] u The form or expression
+/// @param[in] indices The indices of the coefficients to pack
+/// @param[in] cells The cells (local indices) to pack
+/// @param[in,out] c The packed coefficient array
+template <typename U>
+void pack_coefficients(const U& u, const std::vector<int>& indices,
+                       const xtl::span<const std::int32_t>& cells,
+                       const xtl::span<typename U::scalar_type>& c)
 {
   using T = typename U::scalar_type;
+  if (indices.empty())
+    return;
 
   // Get form coefficient offsets and dofmaps
   const std::vector<std::shared_ptr<const fem::Function<T>>> coefficients
       = u.coefficients();
   const std::vector<int> offsets = u.coefficient_offsets();
+  const int cstride = offsets.back();
+
+  // Copy quadrature point data directly into the coefficient array, and
+  // collect the remaining (Function) coefficients
+  const auto quadrature_data = get_quadrature_data(u);
+  std::vector<int> function_indices;
+  for (int coeff : indices)
+  {
+    auto it = quadrature_data.find(coeff);
+    if (it == quadrature_data.end())
+    {
+      function_indices.push_back(coeff);
+      continue;
+    }
+
+    const QuadratureData<T>& data = *it->second;
+    const int size = data.num_points() * data.value_size();
+    xtl::span<const T> values = data.x()->array();
+    for (std::int32_t cell : cells)
+    {
+      std::copy_n(std::next(values.begin(), size * cell), size,
+                  std::next(c.begin(), cstride * cell + offsets[coeff]));
+    }
+  }
+
   std::vector<const fem::DofMap*> dofmaps(coefficients.size());
   std::vector<const fem::FiniteElement*> elements(coefficients.size());
-  std::vector<xtl::span<const T>> v;
-  v.reserve(coefficients.size());
-  for (std::size_t i = 0; i < coefficients.size(); ++i)
+  std::vector<xtl::span<const T>> v(coefficients.size());
+  for (int i : function_indices)
   {
     elements[i] = coefficients[i]->function_space()->element().get();
     dofmaps[i] = coefficients[i]->function_space()->dofmap().get();
-    v.push_back(coefficients[i]->x()->array());
+    v[i] = coefficients[i]->x()->array();
   }
 
   // Get mesh
   std::shared_ptr<const mesh::Mesh> mesh = u.mesh();
   assert(mesh);
-  const int tdim = mesh->topology().dim();
-  const std::int32_t num_cells
-      = mesh->topology().index_map(tdim)->size_local()
-        + mesh->topology().index_map(tdim)->num_ghosts();
 
   // Copy data into coefficient array
-  std::vector<T> c(num_cells * offsets.back());
-  const int cstride = offsets.back();
-  if (!coefficients.empty())
+  bool needs_dof_transformations = false;
+  for (int coeff : function_indices)
   {
-    bool needs_dof_transformations = false;
-    for (std::size_t coeff = 0; coeff < dofmaps.size(); ++coeff)
+    if (elements[coeff]->needs_dof_transformations())
     {
-      if (elements[coeff]->needs_dof_transformations())
-      {
-        needs_dof_transformations = true;
-        mesh->topology_mutable().create_entity_permutations();
-      }
+      needs_dof_transformations = true;
+      mesh->topology_mutable().create_entity_permutations();
     }
+  }
 
-    // Iterate over coefficients
-    xtl::span<const std::uint32_t> cell_info;
-    if (needs_dof_transformations)
-      cell_info = xtl::span(mesh->topology().get_cell_permutation_info());
-    for (std::size_t coeff = 0; coeff < dofmaps.size(); ++coeff)
+  // Iterate over coefficients
+  xtl::span<const std::uint32_t> cell_info;
+  if (needs_dof_transformations)
+    cell_info = xtl::span(mesh->topology().get_cell_permutation_info());
+  for (int coeff : function_indices)
+  {
+    const std::function<void(const xtl::span<T>&,
+                             const xtl::span<const std::uint32_t>&,
+                             std::int32_t, int)>
+        transformation
+        = elements[coeff]->get_dof_transformation_function<T>(false, true);
+    if (int bs = dofmaps[coeff]->bs(); bs == 1)
     {
-      const std::function<void(const xtl::span<T>&,
-                               const xtl::span<const std::uint32_t>&,
-                               std::int32_t, int)>
-          transformation
-          = elements[coeff]->get_dof_transformation_function<T>(false, true);
-      if (int bs = dofmaps[coeff]->bs(); bs == 1)
-      {
-        impl::pack_coefficient<T, 1>(
-            xtl::span<T>(c), cstride, v[coeff], cell_info, *dofmaps[coeff],
-            num_cells, offsets[coeff], elements[coeff]->space_dimension(),
-            transformation);
-      }
-      else if (bs == 2)
-      {
-        impl::pack_coefficient<T, 2>(
-            xtl::span<T>(c), cstride, v[coeff], cell_info, *dofmaps[coeff],
-            num_cells, offsets[coeff], elements[coeff]->space_dimension(),
-            transformation);
-      }
-      else if (bs == 3)
-      {
-        impl::pack_coefficient<T, 3>(
-            xtl::span<T>(c), cstride, v[coeff], cell_info, *dofmaps[coeff],
-            num_cells, offsets[coeff], elements[coeff]->space_dimension(),
-            transformation);
-      }
-      else
-      {
-        impl::pack_coefficient<T>(xtl::span<T>(c), cstride, v[coeff], cell_info,
-                                  *dofmaps[coeff], num_cells, offsets[coeff],
-                                  elements[coeff]->space_dimension(),
-                                  transformation);
-      }
+      impl::pack_coefficient<T, 1>(c, cstride, v[coeff], cell_info,
+                                   *dofmaps[coeff], cells, offsets[coeff],
+                                   elements[coeff]->space_dimension(),
+                                   transformation);
+    }
+    else if (bs == 2)
+    {
+      impl::pack_coefficient<T, 2>(c, cstride, v[coeff], cell_info,
+                                   *dofmaps[coeff], cells, offsets[coeff],
+                                   elements[coeff]->space_dimension(),
+                                   transformation);
     }
+    else if (bs == 3)
+    {
+      impl::pack_coefficient<T, 3>(c, cstride, v[coeff], cell_info,
+                                   *dofmaps[coeff], cells, offsets[coeff],
+                                   elements[coeff]->space_dimension(),
+                                   transformation);
+    }
+    else
+    {
+      impl::pack_coefficient<T>(c, cstride, v[coeff], cell_info,
+                                *dofmaps[coeff], cells, offsets[coeff],
+                                elements[coeff]->space_dimension(),
+                                transformation);
+    }
+  }
+}
+} // namespace impl
+
+// NOTE: This is subject to change
+/// Pack coefficients of u of generic type U for a subset of cells into
+/// an existing array. Only the entries of @p c belonging to @p cells are
+/// modified, which allows cells whose coefficient dofs are all owned to
+/// be packed before ghost values have been updated.
+/// @param[in] u The form or expression
+/// @param[in] cells The cells (local indices) to pack
+/// @param[in,out] c The packed coefficient array, of size (number of
+/// cells including ghosts) x (coefficient stride)
+template <typename U>
+void pack_coefficients(const U& u, const xtl::span<const std::int32_t>& cells,
+                       const xtl::span<typename U::scalar_type>& c)
+{
+  std::vector<int> indices(u.coefficients().size());
+  std::iota(indices.begin(), indices.end(), 0);
+  impl::pack_coefficients(u, indices, cells, c);
+}
+
+// NOTE: This is subject to change
+/// Pack coefficients of u of generic type U ready for assembly
+template <typename U>
+std::pair<std::vector<typename U::scalar_type>, int>
+pack_coefficients(const U& u)
+{
+  using T = typename U::scalar_type;
+
+  // Get mesh
+  std::shared_ptr<const mesh::Mesh> mesh = u.mesh();
+  assert(mesh);
+  const int tdim = mesh->topology().dim();
+  const std::int32_t num_cells
+      = mesh->topology().index_map(tdim)->size_local()
+        + mesh->topology().index_map(tdim)->num_ghosts();
+
+  // Pack all cells
+  const std::vector<int> offsets = u.coefficient_offsets();
+  const int cstride = offsets.back();
+  std::vector<T> c(num_cells * cstride);
+  if (cstride > 0)
+  {
+    std::vector<std::int32_t> cells(num_cells);
+    std::iota(cells.begin(), cells.end(), 0);
+    pack_coefficients(u, cells, xtl::span<T>(c));
   }
 
   return {std::move(c), cstride};
@@ -595,4 +936,73 @@ std::vector<typename U::scalar_type> pack_constants(const U& u)
   return constant_values;
 }
 
+/// Pack the coefficients of a form, re-using the packed data that is
+/// retained by the form (see Form::packed_data). Only coefficients
+/// whose version (see Function::version) has changed since the last
+/// call are re-packed, which avoids allocating and re-filling the full
+/// packed array when coefficients are unchanged, e.g. between Newton
+/// iterations. The result can be passed to the assembly functions
+/// that take packed coefficients.
+/// @note The returned data is owned by the form and is overwritten by
+/// subsequent calls. Concurrent calls for the same form are not safe.
+/// @note Coefficient values that are modified through a previously
+/// obtained view of their vector are not detected, see
+/// la::Vector::version.
+/// @param[in] form The form
+/// @return The packed coefficients and the number of coefficient
+/// entries per cell
+template <typename T>
+std::pair<xtl::span<const T>, int> pack_coefficients_cached(Form<T>& form)
+{
+  typename Form<T>::PackedData& data = form.packed_data();
+  const std::vector<std::shared_ptr<const fem::Function<T>>> coefficients
+      = form.coefficients();
+  const std::vector<int> offsets = form.coefficient_offsets();
+  const int cstride = offsets.back();
+
+  std::shared_ptr<const mesh::Mesh> mesh = form.mesh();
+  assert(mesh);
+  const int tdim = mesh->topology().dim();
+  const std::int32_t num_cells
+      = mesh->topology().index_map(tdim)->size_local()
+        + mesh->topology().index_map(tdim)->num_ghosts();
+
+  // Invalidate all coefficients if the layout has changed
+  if (data.coefficients.size() != std::size_t(num_cells * cstride)
+      or data.coefficient_versions.size() != coefficients.size())
+  {
+    data.coefficients.resize(num_cells * cstride);
+    data.coefficient_versions.assign(
+        coefficients.size(), {std::numeric_limits<std::size_t>::max(),
+                              std::numeric_limits<std::size_t>::max()});
+  }
+
+  // Find the coefficients that have changed
+  const auto& quadrature_data = form.quadrature_data();
+  std::vector<int> indices;
+  for (std::size_t i = 0; i < coefficients.size(); ++i)
+  {
+    auto it = quadrature_data.find(i);
+    std::pair<std::size_t, std::size_t> version
+        = it != quadrature_data.end()
+              ? std::pair(it->second->id(), it->second->version())
+              : std::pair(coefficients[i]->id(), coefficients[i]->version());
+    if (version != data.coefficient_versions[i])
+    {
+      indices.push_back(i);
+      data.coefficient_versions[i] = version;
+    }
+  }
+
+  if (!indices.empty())
+  {
+    std::vector<std::int32_t> cells(num_cells);
+    std::iota(cells.begin(), cells.end(), 0);
+    impl::pack_coefficients(form, indices, cells,
+                            xtl::span<T>(data.coefficients));
+  }
+
+  return {xtl::span<const T>(data.coefficients), cstride};
+}
+
 } // namespace dolfinx::fem
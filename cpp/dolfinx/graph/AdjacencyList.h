@@ -7,6 +7,7 @@
 #pragma once
 
 #include <cassert>
+#include <memory>
 #include <numeric>
 #include <sstream>
 #include <utility>
@@ -41,6 +42,11 @@ auto create_adjacency_data(const xt::xtensor<T, 2>& array)
 /// contiguous list of nodes [0, 1, 2, ..., n) it stores the connected
 /// nodes. The representation is strictly local, i.e. it is not parallel
 /// aware.
+///
+/// If every node has the same number of links (a constant degree
+/// list, e.g. cell-to-vertex connectivity and dofmaps for meshes with
+/// one cell type), the offsets are not stored and the links of a node
+/// are located using the degree. See build_adjacency_list.
 template <typename T>
 class AdjacencyList
 {
@@ -48,10 +54,9 @@ public:
   /// Construct trivial adjacency list where each of the n nodes is
   /// connected to itself
   /// @param [in] n Number of nodes
-  explicit AdjacencyList(const std::int32_t n) : _array(n), _offsets(n + 1)
+  explicit AdjacencyList(const std::int32_t n) : _array(n), _degree(1)
   {
     std::iota(_array.begin(), _array.end(), 0);
-    std::iota(_offsets.begin(), _offsets.end(), 0);
   }
 
   /// Construct adjacency list from arrays of data
@@ -64,18 +69,33 @@ public:
           std::is_same<std::vector<T>, std::decay_t<U>>::value
           && std::is_same<std::vector<std::int32_t>, std::decay_t<V>>::value>>
   AdjacencyList(U&& data, V&& offsets)
-      : _array(std::forward<U>(data)), _offsets(std::forward<V>(offsets))
+      : _array(std::forward<U>(data)), _offsets(std::forward<V>(offsets)),
+        _degree(-1)
   {
     _array.reserve(_offsets.back());
     assert(_offsets.back() == (std::int32_t)_array.size());
   }
 
+  /// Construct a constant degree adjacency list from an array of data
+  /// @param [in] data Adjacency array, where the links for node i are
+  /// in positions [i * degree, (i + 1) * degree)
+  /// @param [in] degree The number of links for each node. Must be
+  /// positive.
+  template <typename U, typename = std::enable_if_t<std::is_same<
+                            std::vector<T>, std::decay_t<U>>::value>>
+  AdjacencyList(U&& data, int degree)
+      : _array(std::forward<U>(data)), _degree(degree)
+  {
+    assert(degree > 0);
+    assert(_array.size() % degree == 0);
+  }
+
   /// Set all connections for all entities (T is a '2D' container, e.g.
   /// a std::vector<<std::vector<std::size_t>>,
   /// std::vector<<std::set<std::size_t>>, etc)
   /// @param [in] data TODO
   template <typename X>
-  explicit AdjacencyList(const std::vector<X>& data)
+  explicit AdjacencyList(const std::vector<X>& data) : _degree(-1)
   {
     // Initialize offsets and compute total size
     _offsets.reserve(data.size() + 1);
@@ -89,7 +109,12 @@ public:
   }
 
   /// Copy constructor
-  AdjacencyList(const AdjacencyList& list) = default;
+  AdjacencyList(const AdjacencyList& list)
+      : _array(list._array), _offsets(list._offsets),
+        _degree_offsets(std::atomic_load(&list._degree_offsets)),
+        _degree(list._degree)
+  {
+  }
 
   /// Move constructor
   AdjacencyList(AdjacencyList&& list) = default;
@@ -98,7 +123,14 @@ public:
   ~AdjacencyList() = default;
 
   /// Assignment
-  AdjacencyList& operator=(const AdjacencyList& list) = default;
+  AdjacencyList& operator=(const AdjacencyList& list)
+  {
+    _array = list._array;
+    _offsets = list._offsets;
+    _degree_offsets = std::atomic_load(&list._degree_offsets);
+    _degree = list._degree;
+    return *this;
+  }
 
   /// Move assignment
   AdjacencyList& operator=(AdjacencyList&& list) = default;
@@ -106,18 +138,34 @@ public:
   /// Equality operator
   bool operator==(const AdjacencyList& list) const
   {
-    return this->_array == list._array and this->_offsets == list._offsets;
+    if (this->_degree > 0 and list._degree > 0)
+    {
+      return this->_array == list._array
+             and (this->_degree == list._degree or _array.empty());
+    }
+    else
+      return this->_array == list._array and this->offsets() == list.offsets();
   }
 
   /// Get the number of nodes
   /// @return The number of nodes
-  std::int32_t num_nodes() const { return _offsets.size() - 1; }
+  std::int32_t num_nodes() const
+  {
+    return _degree > 0 ? _array.size() / _degree : _offsets.size() - 1;
+  }
+
+  /// Number of links of every node for a constant degree list
+  /// @return The number of links for each node, or -1 if the list does
+  /// not have constant degree (offsets are stored)
+  int degree() const { return _degree; }
 
   /// Number of connections for given node
   /// @param [in] node Node index
   /// @return The number of outgoing links (edges) from the node
   int num_links(int node) const
   {
+    if (_degree > 0)
+      return _degree;
     assert((node + 1) < (int)_offsets.size());
     return _offsets[node + 1] - _offsets[node];
   }
@@ -128,6 +176,9 @@ public:
   /// AdjacencyList:num_links(node).
   xtl::span<T> links(int node)
   {
+    if (_degree > 0)
+      return xtl::span<T>(_array.data() + std::size_t(node) * _degree,
+                          _degree);
     return xtl::span<T>(_array.data() + _offsets[node],
                         _offsets[node + 1] - _offsets[node]);
   }
@@ -138,6 +189,11 @@ public:
   /// AdjacencyList:num_links(node).
   xtl::span<const T> links(int node) const
   {
+    if (_degree > 0)
+    {
+      return xtl::span<const T>(_array.data() + std::size_t(node) * _degree,
+                                _degree);
+    }
     return xtl::span<const T>(_array.data() + _offsets[node],
                               _offsets[node + 1] - _offsets[node]);
   }
@@ -149,7 +205,49 @@ public:
   std::vector<T>& array() { return _array; }
 
   /// Offset for each node in array() (const version)
-  const std::vector<std::int32_t>& offsets() const { return _offsets; }
+  /// @note The offsets of a constant degree list are not stored. They
+  /// are created on the first call and then kept. Creation is
+  /// thread-safe, but it allocates memory. Use degree() to avoid
+  /// creating them.
+  const std::vector<std::int32_t>& offsets() const
+  {
+    if (_degree < 1)
+      return _offsets;
+
+    std::shared_ptr<const std::vector<std::int32_t>> offsets
+        = std::atomic_load(&_degree_offsets);
+    if (!offsets)
+    {
+      auto created
+          = std::make_shared<std::vector<std::int32_t>>(num_nodes() + 1);
+      for (std::size_t i = 0; i < created->size(); ++i)
+        (*created)[i] = i * _degree;
+
+      // If another thread has created the offsets first, use them
+      offsets = created;
+      std::shared_ptr<const std::vector<std::int32_t>> expected;
+      if (!std::atomic_compare_exchange_strong(&_degree_offsets, &expected,
+                                               offsets))
+      {
+        offsets = expected;
+      }
+    }
+    return *offsets;
+  }
+
+  /// Capacity of the stored offsets. Unlike offsets(), this does not
+  /// create the offsets of a constant degree list.
+  /// @return The number of offsets that storage is allocated for. It is
+  /// zero for a constant degree list whose offsets have not been
+  /// created.
+  std::size_t offsets_capacity() const
+  {
+    if (_degree < 1)
+      return _offsets.capacity();
+    std::shared_ptr<const std::vector<std::int32_t>> offsets
+        = std::atomic_load(&_degree_offsets);
+    return offsets ? offsets->capacity() : 0;
+  }
 
   /// Return informal string representation (pretty-print)
   std::string str() const
@@ -157,7 +255,7 @@ public:
     std::stringstream s;
     s << "<AdjacencyList> with " + std::to_string(this->num_nodes()) + " nodes"
       << std::endl;
-    for (std::size_t e = 0; e < _offsets.size() - 1; ++e)
+    for (std::int32_t e = 0; e < this->num_nodes(); ++e)
     {
       s << "  " << e << ": [";
       for (auto link : this->links(e))
@@ -171,25 +269,35 @@ private:
   // Connections for all entities stored as a contiguous array
   std::vector<T> _array;
 
-  // Position of first connection for each entity (using local index)
+  // Position of first connection for each entity (using local index).
+  // Empty for constant degree lists.
   std::vector<std::int32_t> _offsets;
+
+  // Offsets of a constant degree list, created by offsets() on first
+  // use. Accessed atomically since offsets() is const.
+  mutable std::shared_ptr<const std::vector<std::int32_t>> _degree_offsets;
+
+  // Number of links for each node if constant, otherwise -1
+  int _degree;
 };
 
 /// Construct an adjacency list from array of data for a graph with
 /// constant degree (valency). A constant degree graph has the same
-/// number of edges for every node.
+/// number of edges for every node, and the offsets are not stored.
 /// @param [in] data Adjacency array
 /// @param [in] degree The number of (outgoing) edges for each node
 /// @return An adjacency list
 template <typename T, typename U>
 AdjacencyList<T> build_adjacency_list(U&& data, int degree)
 {
-  // using T = typename U::value_type;
-  assert(data.size() % degree == 0);
-  std::vector<std::int32_t> offsets((data.size() / degree) + 1, 0);
-  for (std::size_t i = 1; i < offsets.size(); ++i)
-    offsets[i] = offsets[i - 1] + degree;
-  return AdjacencyList<T>(std::forward<U>(data), std::move(offsets));
+  if (degree > 0)
+    return AdjacencyList<T>(std::forward<U>(data), degree);
+  else
+  {
+    // A graph without edges
+    assert(data.empty());
+    return AdjacencyList<T>(std::vector<T>(), std::vector<std::int32_t>(1, 0));
+  }
 }
 
 } // namespace dolfinx::graph
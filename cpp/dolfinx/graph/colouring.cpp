@@ -0,0 +1,68 @@
+// Copyright (C) 2021 Garth N. Wells
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#include "colouring.h"
+#include "AdjacencyList.h"
+#include <algorithm>
+#include <dolfinx/common/Timer.h>
+#include <numeric>
+#include <vector>
+
+using namespace dolfinx;
+
+//-----------------------------------------------------------------------------
+graph::AdjacencyList<std::int32_t>
+graph::compute_colouring(const graph::AdjacencyList<std::int32_t>& resources)
+{
+  common::Timer timer("Compute graph colouring");
+
+  const std::vector<std::int32_t>& r = resources.array();
+  const std::int32_t num_resources
+      = r.empty() ? 0 : *std::max_element(r.begin(), r.end()) + 1;
+
+  // Markers for resources that are used by a node of the current colour
+  std::vector<bool> marked(num_resources, false);
+
+  // Nodes that have not yet been assigned a colour
+  std::vector<std::int32_t> nodes(resources.num_nodes());
+  std::iota(nodes.begin(), nodes.end(), 0);
+
+  std::vector<std::int32_t> data, offsets(1, 0), remaining;
+  data.reserve(nodes.size());
+  while (!nodes.empty())
+  {
+    // Assign the current colour to each node that does not share a
+    // resource with a node that already has the current colour
+    remaining.clear();
+    for (std::int32_t n : nodes)
+    {
+      auto links = resources.links(n);
+      if (std::any_of(links.begin(), links.end(),
+                      [&marked](auto r) { return marked[r]; }))
+      {
+        remaining.push_back(n);
+      }
+      else
+      {
+        for (std::int32_t r : links)
+          marked[r] = true;
+        data.push_back(n);
+      }
+    }
+
+    // Reset markers for the resources used by the current colour
+    for (auto n = std::next(data.begin(), offsets.back()); n != data.end(); ++n)
+      for (std::int32_t r : resources.links(*n))
+        marked[r] = false;
+
+    offsets.push_back(data.size());
+    nodes.swap(remaining);
+  }
+
+  return graph::AdjacencyList<std::int32_t>(std::move(data),
+                                            std::move(offsets));
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,32 @@
+// Copyright (C) 2021 Garth N. Wells
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include <cstdint>
+
+namespace dolfinx::graph
+{
+
+template <typename T>
+class AdjacencyList;
+
+/// Compute a colouring of nodes such that two nodes that share a
+/// resource (e.g., a degree-of-freedom) do not have the same colour.
+/// The colouring is computed greedily, with the nodes visited in
+/// ascending order. The colouring therefore depends only on the input
+/// graph, and nodes with the same colour can be processed concurrently
+/// without write conflicts.
+///
+/// @param[in] resources The resources used by each node, i.e.
+/// `resources.links(i)` are the resources used by node `i`
+/// @return The nodes for each colour, i.e. `colouring.links(c)` are the
+/// nodes with colour `c`. Nodes are sorted in ascending order for each
+/// colour.
+AdjacencyList<std::int32_t>
+compute_colouring(const AdjacencyList<std::int32_t>& resources);
+
+} // namespace dolfinx::graph
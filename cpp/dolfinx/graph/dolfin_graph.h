@@ -13,4 +13,5 @@ namespace dolfinx
 // DOLFINx graph interface
 
 #include <dolfinx/graph/boostordering.h>
+#include <dolfinx/graph/colouring.h>
 #include <dolfinx/graph/partition.h>
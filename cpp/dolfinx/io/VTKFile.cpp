@@ -366,11 +366,14 @@ void add_mesh(const mesh::Mesh& mesh, pugi::xml_node& piece_node)
   offsets_node.append_attribute("type") = "Int32";
   offsets_node.append_attribute("Name") = "offsets";
   offsets_node.append_attribute("format") = "ascii";
-  const std::vector<std::int32_t>& offsets = x_dofmap.offsets();
   std::stringstream ss_offset;
   ss_offset.precision(0);
-  for (std::int32_t i = 1; i <= num_cells; ++i)
-    ss_offset << offsets[i] << " ";
+  std::int32_t offset = 0;
+  for (std::int32_t i = 0; i < num_cells; ++i)
+  {
+    offset += x_dofmap.num_links(i);
+    ss_offset << offset << " ";
+  }
 
   offsets_node.append_child(pugi::node_pcdata)
       .set_value(ss_offset.str().c_str());
@@ -0,0 +1,493 @@
+// Copyright (C) 2021 Garth N. Wells and Chris Richardson
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "SparsityPattern.h"
+#include "Vector.h"
+#include <algorithm>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/graph/AdjacencyList.h>
+#include <functional>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <set>
+#include <vector>
+#include <xtl/xspan.hpp>
+
+namespace dolfinx::la
+{
+
+/// Distributed sparse matrix in compressed row storage (CSR) format
+///
+/// The matrix is created from a finalised SparsityPattern. Each rank
+/// stores the rows that it owns and the ghost rows of the row
+/// IndexMap. Values added to ghost rows, e.g. during finite element
+/// assembly, are accumulated on the owning rank by
+/// MatrixCSR::finalize. Blocked sparsity patterns are expanded, i.e.
+/// rows and columns are stored unblocked, but insertion uses blocked
+/// (local) indices.
+///
+/// The column IndexMap of the matrix includes all off-process columns
+/// in the owned rows, which can be more than the ghosts of the column
+/// IndexMap of the sparsity pattern.
+
+template <typename T, class Allocator = std::allocator<T>>
+class MatrixCSR
+{
+public:
+  /// Insertion functor for setting values in the matrix. It is
+  /// typically used in finite element assembly functions.
+  /// @param[in] A The matrix to insert into
+  /// @return Function for inserting values into `A`
+  static std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
+                           const std::int32_t*, const T*)>
+  mat_set_values(MatrixCSR& A)
+  {
+    return [&A](std::int32_t m, const std::int32_t* rows, std::int32_t n,
+                const std::int32_t* cols, const T* vals) -> int
+    {
+      A.set(xtl::span<const T>(vals, m * n * A._bs[0] * A._bs[1]),
+            xtl::span<const std::int32_t>(rows, m),
+            xtl::span<const std::int32_t>(cols, n));
+      return 0;
+    };
+  }
+
+  /// Insertion functor for accumulating values in the matrix. It is
+  /// typically used in finite element assembly functions.
+  /// @param[in] A The matrix to add to
+  /// @return Function for adding values to `A`
+  static std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
+                           const std::int32_t*, const T*)>
+  mat_add_values(MatrixCSR& A)
+  {
+    return [&A](std::int32_t m, const std::int32_t* rows, std::int32_t n,
+                const std::int32_t* cols, const T* vals) -> int
+    {
+      A.add(xtl::span<const T>(vals, m * n * A._bs[0] * A._bs[1]),
+            xtl::span<const std::int32_t>(rows, m),
+            xtl::span<const std::int32_t>(cols, n));
+      return 0;
+    };
+  }
+
+  /// Create a distributed matrix
+  /// @note Collective MPI operation
+  /// @param[in] p The sparsity pattern. It must be finalised.
+  /// @param[in] alloc The allocator for the matrix values
+  MatrixCSR(const SparsityPattern& p, const Allocator& alloc = Allocator())
+      : _index_maps({p.index_map(0), nullptr}),
+        _bs({p.block_size(0), p.block_size(1)}), _data(alloc)
+  {
+    const graph::AdjacencyList<std::int32_t>& pattern_diag
+        = p.diagonal_pattern();
+    const graph::AdjacencyList<std::int32_t>& pattern_off
+        = p.off_diagonal_pattern();
+    const graph::AdjacencyList<std::int32_t>& pattern_ghost
+        = p.ghost_row_pattern();
+    const int bs0 = _bs[0];
+    const int bs1 = _bs[1];
+
+    // Create column map that includes all ghost columns in the owned
+    // rows
+    std::shared_ptr<const common::IndexMap> col_map = p.index_map(1);
+    MPI_Comm comm = col_map->comm();
+    const std::int32_t local_size1 = col_map->size_local();
+    const std::array local_range1 = col_map->local_range();
+    const std::vector<std::int64_t> col_global = p.column_indices();
+    const std::vector<std::int64_t> col_ghosts(
+        std::next(col_global.begin(), local_size1), col_global.end());
+    {
+      std::vector<std::int64_t> ranges(dolfinx::MPI::size(comm) + 1, 0);
+      MPI_Allgather(&local_range1[1], 1, MPI_INT64_T, ranges.data() + 1, 1,
+                    MPI_INT64_T, comm);
+      std::vector<int> owners(col_ghosts.size());
+      std::transform(col_ghosts.begin(), col_ghosts.end(), owners.begin(),
+                     [&ranges](std::int64_t idx)
+                     {
+                       auto it
+                           = std::upper_bound(ranges.begin(), ranges.end(), idx);
+                       return std::distance(ranges.begin(), it) - 1;
+                     });
+      _index_maps[1] = std::make_shared<common::IndexMap>(
+          comm, local_size1,
+          dolfinx::MPI::compute_graph_edges(
+              comm, std::set<int>(owners.begin(), owners.end())),
+          col_ghosts, owners);
+    }
+
+    // Build expanded CSR structure for owned rows, followed by ghost
+    // rows
+    const std::int32_t num_owned0 = _index_maps[0]->size_local();
+    const std::int32_t num_ghosts0 = _index_maps[0]->num_ghosts();
+    _row_ptr.reserve(bs0 * (num_owned0 + num_ghosts0) + 1);
+    _row_ptr.push_back(0);
+    _off_diagonal_offset.reserve(bs0 * num_owned0);
+    for (std::int32_t i = 0; i < num_owned0 + num_ghosts0; ++i)
+    {
+      std::vector<std::int32_t> block_cols;
+      if (i < num_owned0)
+      {
+        auto diag = pattern_diag.links(i);
+        auto off = pattern_off.links(i);
+        block_cols.insert(block_cols.end(), diag.begin(), diag.end());
+        block_cols.insert(block_cols.end(), off.begin(), off.end());
+      }
+      else
+      {
+        auto ghost = pattern_ghost.links(i - num_owned0);
+        block_cols.assign(ghost.begin(), ghost.end());
+      }
+
+      for (int k = 0; k < bs0; ++k)
+      {
+        if (i < num_owned0)
+        {
+          _off_diagonal_offset.push_back(_row_ptr.back()
+                                         + bs1 * pattern_diag.num_links(i));
+        }
+        for (std::int32_t c : block_cols)
+          for (int j = 0; j < bs1; ++j)
+            _cols.push_back(bs1 * c + j);
+        _row_ptr.push_back(_cols.size());
+      }
+    }
+    _data.resize(_cols.size(), 0);
+
+    // Compute neighbourhood rank of the owner of each ghost row
+    MPI_Comm comm0
+        = _index_maps[0]->comm(common::IndexMap::Direction::reverse);
+    const std::vector<int> dest_ranks = dolfinx::MPI::neighbors(comm0)[1];
+    std::map<int, std::int32_t> dest_proc_to_neighbor;
+    for (std::size_t i = 0; i < dest_ranks.size(); ++i)
+      dest_proc_to_neighbor.insert({dest_ranks[i], i});
+    const std::vector<int> ghost_owners0 = _index_maps[0]->ghost_owner_rank();
+    std::vector<int> ghost_to_neighbour_rank(num_ghosts0);
+    _send_sizes.resize(dest_ranks.size(), 0);
+    for (std::int32_t i = 0; i < num_ghosts0; ++i)
+    {
+      const auto it = dest_proc_to_neighbor.find(ghost_owners0[i]);
+      assert(it != dest_proc_to_neighbor.end());
+      ghost_to_neighbour_rank[i] = it->second;
+      _send_sizes[it->second] += bs0 * bs1 * pattern_ghost.num_links(i);
+    }
+    _send_disp.resize(dest_ranks.size() + 1, 0);
+    std::partial_sum(_send_sizes.begin(), _send_sizes.end(),
+                     std::next(_send_disp.begin()));
+
+    // Pack (global row, global column) pairs for each ghost row entry
+    // and record the position of each entry in the send buffer
+    const std::vector<std::int64_t>& ghosts0 = _index_maps[0]->ghosts();
+    std::vector<int> insert_pos(_send_disp);
+    std::vector<std::int64_t> ghost_index_data(2 * _send_disp.back());
+    _ghost_row_to_buffer.reserve(_send_disp.back());
+    for (std::int32_t i = 0; i < num_ghosts0; ++i)
+    {
+      const int neighbour_rank = ghost_to_neighbour_rank[i];
+      for (int k = 0; k < bs0; ++k)
+      {
+        for (std::int32_t c : pattern_ghost.links(i))
+        {
+          for (int j = 0; j < bs1; ++j)
+          {
+            const int pos = insert_pos[neighbour_rank]++;
+            _ghost_row_to_buffer.push_back(pos);
+            ghost_index_data[2 * pos] = bs0 * ghosts0[i] + k;
+            ghost_index_data[2 * pos + 1] = bs1 * col_global[c] + j;
+          }
+        }
+      }
+    }
+
+    // Send ghost row indices to owning ranks
+    std::vector<std::int32_t> index_disp(_send_disp.size());
+    std::transform(_send_disp.begin(), _send_disp.end(), index_disp.begin(),
+                   [](auto d) { return 2 * d; });
+    const graph::AdjacencyList<std::int64_t> ghost_index_in
+        = dolfinx::MPI::neighbor_all_to_all(
+            comm0, graph::AdjacencyList<std::int64_t>(
+                       std::move(ghost_index_data), std::move(index_disp)));
+    const std::vector<std::int32_t>& recv_index_disp = ghost_index_in.offsets();
+    _recv_disp.resize(recv_index_disp.size());
+    std::transform(recv_index_disp.begin(), recv_index_disp.end(),
+                   _recv_disp.begin(), [](auto d) { return d / 2; });
+    _recv_sizes.resize(_recv_disp.size() - 1);
+    std::adjacent_difference(std::next(_recv_disp.begin()), _recv_disp.end(),
+                             _recv_sizes.begin());
+
+    // Compute position in the value array of each received entry
+    std::map<std::int64_t, std::int32_t> global_to_local;
+    for (std::size_t i = 0; i < col_ghosts.size(); ++i)
+      global_to_local.insert({col_ghosts[i], local_size1 + i});
+    const std::array local_range0 = _index_maps[0]->local_range();
+    const std::vector<std::int64_t>& in = ghost_index_in.array();
+    _unpack_pos.reserve(in.size() / 2);
+    for (std::size_t i = 0; i < in.size(); i += 2)
+    {
+      const std::int32_t row = in[i] - bs0 * local_range0[0];
+      const std::int64_t col_block = in[i + 1] / bs1;
+      const std::int32_t col_local
+          = (col_block >= local_range1[0] and col_block < local_range1[1])
+                ? col_block - local_range1[0]
+                : global_to_local.at(col_block);
+      const std::int32_t col = bs1 * col_local + in[i + 1] % bs1;
+      auto cols0 = std::next(_cols.begin(), _row_ptr[row]);
+      auto cols1 = std::next(_cols.begin(), _row_ptr[row + 1]);
+      auto it = std::lower_bound(cols0, cols1, col);
+      assert(it != cols1 and *it == col);
+      _unpack_pos.push_back(std::distance(_cols.begin(), it));
+    }
+  }
+
+  /// Move constructor
+  MatrixCSR(MatrixCSR&& A) = default;
+
+  /// Copy constructor (deleted)
+  MatrixCSR(const MatrixCSR& A) = delete;
+
+  /// Destructor
+  ~MatrixCSR() = default;
+
+  /// Move assignment
+  MatrixCSR& operator=(MatrixCSR&& A) = default;
+
+  /// Copy assignment (deleted)
+  MatrixCSR& operator=(const MatrixCSR& A) = delete;
+
+  /// Set all stored entries to a value, e.g. zero. Ghost rows are also
+  /// set.
+  /// @param[in] x The value
+  void set(T x) { std::fill(_data.begin(), _data.end(), x); }
+
+  /// Set values in the matrix
+  /// @param[in] x The `m` by `n` dense block of values (row-major) to
+  /// set, where `m = bs0 * rows.size()` and `n = bs1 * cols.size()`
+  /// @param[in] rows The (blocked) row indices, using local indices
+  /// including ghost rows
+  /// @param[in] cols The (blocked) column indices, using local indices
+  void set(const xtl::span<const T>& x,
+           const xtl::span<const std::int32_t>& rows,
+           const xtl::span<const std::int32_t>& cols)
+  {
+    insert(x, rows, cols, [](T& a, T b) { a = b; });
+  }
+
+  /// Accumulate values in the matrix
+  /// @param[in] x The `m` by `n` dense block of values (row-major) to
+  /// add, where `m = bs0 * rows.size()` and `n = bs1 * cols.size()`
+  /// @param[in] rows The (blocked) row indices, using local indices
+  /// including ghost rows
+  /// @param[in] cols The (blocked) column indices, using local indices
+  void add(const xtl::span<const T>& x,
+           const xtl::span<const std::int32_t>& rows,
+           const xtl::span<const std::int32_t>& cols)
+  {
+    insert(x, rows, cols, [](T& a, T b) { a += b; });
+  }
+
+  /// Begin sending values accumulated in ghost rows to the owning
+  /// rank. Must be followed by MatrixCSR::finalize_end, and the matrix
+  /// must not be changed in between.
+  /// @note Collective MPI operation
+  void finalize_begin()
+  {
+    // Pack ghost row values into send buffer
+    const std::int32_t ghost_start
+        = _row_ptr[_bs[0] * _index_maps[0]->size_local()];
+    _ghost_value_send.resize(_send_disp.back());
+    for (std::size_t i = 0; i < _ghost_row_to_buffer.size(); ++i)
+      _ghost_value_send[_ghost_row_to_buffer[i]] = _data[ghost_start + i];
+    _ghost_value_recv.resize(_recv_disp.back());
+
+    MPI_Ineighbor_alltoallv(
+        _ghost_value_send.data(), _send_sizes.data(), _send_disp.data(),
+        dolfinx::MPI::mpi_type<T>(), _ghost_value_recv.data(),
+        _recv_sizes.data(), _recv_disp.data(), dolfinx::MPI::mpi_type<T>(),
+        _index_maps[0]->comm(common::IndexMap::Direction::reverse),
+        &_request);
+  }
+
+  /// Complete sending of ghost row values, accumulate received values
+  /// in the owned rows and zero the ghost rows
+  /// @note Collective MPI operation
+  void finalize_end()
+  {
+    MPI_Wait(&_request, MPI_STATUS_IGNORE);
+    for (std::size_t i = 0; i < _unpack_pos.size(); ++i)
+      _data[_unpack_pos[i]] += _ghost_value_recv[i];
+
+    const std::int32_t ghost_start
+        = _row_ptr[_bs[0] * _index_maps[0]->size_local()];
+    std::fill(std::next(_data.begin(), ghost_start), _data.end(), 0);
+  }
+
+  /// Accumulate values in ghost rows on the owning rank and zero the
+  /// ghost rows. Typically called after assembly.
+  /// @note Collective MPI operation
+  void finalize()
+  {
+    finalize_begin();
+    finalize_end();
+  }
+
+  /// Compute y += Ax for the owned rows. The vector x must have the
+  /// column layout of the matrix, i.e. be created with the IndexMap
+  /// MatrixCSR::index_maps()[1] and block size
+  /// MatrixCSR::block_size()[1]. The ghost values of x are updated by
+  /// this function, with communication overlapped with the computation
+  /// of the product with the owned columns. The matrix must be
+  /// finalised.
+  /// @note Collective MPI operation
+  /// @param[in,out] x The vector to multiply
+  /// @param[in,out] y The vector to add the result to
+  template <class AllocatorX, class AllocatorY>
+  void mult(Vector<T, AllocatorX>& x, Vector<T, AllocatorY>& y)
+  {
+    assert(x.map()->size_local() == _index_maps[1]->size_local());
+    assert(x.map()->num_ghosts() == _index_maps[1]->num_ghosts());
+    assert(x.bs() == _bs[1]);
+    assert(y.map()->size_local() == _index_maps[0]->size_local());
+    assert(y.bs() == _bs[0]);
+
+    x.scatter_fwd_begin();
+
+    // Compute product with owned columns
+    xtl::span<const T> _x = x.array();
+    xtl::span<T> _y = y.mutable_array();
+    const std::int32_t num_rows = _bs[0] * _index_maps[0]->size_local();
+    for (std::int32_t i = 0; i < num_rows; ++i)
+    {
+      T sum = 0;
+      for (std::int32_t k = _row_ptr[i]; k < _off_diagonal_offset[i]; ++k)
+        sum += _data[k] * _x[_cols[k]];
+      _y[i] += sum;
+    }
+
+    x.scatter_fwd_end();
+
+    // Compute product with ghost columns
+    for (std::int32_t i = 0; i < num_rows; ++i)
+    {
+      T sum = 0;
+      for (std::int32_t k = _off_diagonal_offset[i]; k < _row_ptr[i + 1]; ++k)
+        sum += _data[k] * _x[_cols[k]];
+      _y[i] += sum;
+    }
+  }
+
+  /// Compute the squared Frobenius norm of the owned rows
+  /// @note Collective MPI operation
+  double squared_norm() const
+  {
+    const std::int32_t num_owned
+        = _row_ptr[_bs[0] * _index_maps[0]->size_local()];
+    const double local = std::transform_reduce(
+        _data.begin(), std::next(_data.begin(), num_owned), 0.0,
+        std::plus<double>(), [](T val) { return std::norm(val); });
+    double norm2;
+    MPI_Allreduce(&local, &norm2, 1, MPI_DOUBLE, MPI_SUM,
+                  _index_maps[0]->comm());
+    return norm2;
+  }
+
+  /// Index maps for the row and column space. The row IndexMap
+  /// contains ghost entries for rows which may be inserted into and the
+  /// column IndexMap contains all local and ghost columns that may
+  /// exist in the owned rows.
+  /// @return Row (0) and column (1) index maps
+  const std::array<std::shared_ptr<const common::IndexMap>, 2>&
+  index_maps() const
+  {
+    return _index_maps;
+  }
+
+  /// Block sizes of the rows (0) and columns (1)
+  const std::array<int, 2>& block_size() const { return _bs; }
+
+  /// Number of local (unblocked) rows, excluding ghost rows
+  std::int32_t num_owned_rows() const
+  {
+    return _bs[0] * _index_maps[0]->size_local();
+  }
+
+  /// Number of local (unblocked) rows, including ghost rows
+  std::int32_t num_all_rows() const { return _row_ptr.size() - 1; }
+
+  /// Get local values (const version)
+  xtl::span<const T> values() const { return xtl::span<const T>(_data); }
+
+  /// Get local values
+  xtl::span<T> values() { return xtl::span<T>(_data); }
+
+  /// Get local (unblocked) column indices
+  const std::vector<std::int32_t>& cols() const { return _cols; }
+
+  /// Get offsets into the column and value arrays for each row
+  const std::vector<std::int32_t>& row_ptr() const { return _row_ptr; }
+
+private:
+  // Insert a dense block of values using blocked local indices, with
+  // op(a, b) combining an existing value a with the inserted value b
+  template <typename BinaryOp>
+  void insert(const xtl::span<const T>& x,
+              const xtl::span<const std::int32_t>& rows,
+              const xtl::span<const std::int32_t>& cols, BinaryOp op)
+  {
+    const int bs0 = _bs[0];
+    const int bs1 = _bs[1];
+    const std::size_t nc = bs1 * cols.size();
+    assert(x.size() == bs0 * rows.size() * nc);
+    for (std::size_t r = 0; r < rows.size(); ++r)
+    {
+      for (int k = 0; k < bs0; ++k)
+      {
+        const std::int32_t row = bs0 * rows[r] + k;
+        auto cols0 = std::next(_cols.begin(), _row_ptr[row]);
+        auto cols1 = std::next(_cols.begin(), _row_ptr[row + 1]);
+        const T* xr = x.data() + (bs0 * r + k) * nc;
+        for (std::size_t c = 0; c < cols.size(); ++c)
+        {
+          // Find position of first column of the block. Columns of a
+          // block are contiguous.
+          auto it = std::lower_bound(cols0, cols1, bs1 * cols[c]);
+          if (it == cols1 or *it != bs1 * cols[c])
+            throw std::runtime_error("Entry not in sparsity pattern.");
+          const std::size_t d = std::distance(_cols.begin(), it);
+          for (int j = 0; j < bs1; ++j)
+            op(_data[d + j], xr[bs1 * c + j]);
+        }
+      }
+    }
+  }
+
+  // Maps for the distribution of the rows and columns
+  std::array<std::shared_ptr<const common::IndexMap>, 2> _index_maps;
+
+  // Block sizes
+  std::array<int, 2> _bs;
+
+  // Matrix data
+  std::vector<T, Allocator> _data;
+  std::vector<std::int32_t> _cols, _row_ptr;
+
+  // Position of the first ghost column in each owned row
+  std::vector<std::int32_t> _off_diagonal_offset;
+
+  // Send/receive sizes and displacements for ghost row values, position
+  // in the send buffer of each ghost row value, and position in _data of
+  // each received value
+  std::vector<int> _send_sizes, _send_disp, _recv_sizes, _recv_disp;
+  std::vector<std::int32_t> _ghost_row_to_buffer, _unpack_pos;
+
+  // Buffers and request for ghost row communication
+  std::vector<T> _ghost_value_send, _ghost_value_recv;
+  MPI_Request _request = MPI_REQUEST_NULL;
+};
+
+} // namespace dolfinx::la
@@ -384,6 +384,19 @@ void SparsityPattern::assemble()
 
   _off_diagonal = std::make_shared<graph::AdjacencyList<std::int32_t>>(
       std::move(adj_data_off), std::move(adj_offsets_off));
+
+  // Sort and remove duplicate column indices in each ghost row
+  std::vector<std::int32_t> adj_data_ghost, adj_offsets_ghost(1, 0);
+  for (std::vector<std::int32_t>& row : _cache_unowned)
+  {
+    std::sort(row.begin(), row.end());
+    adj_data_ghost.insert(adj_data_ghost.end(), row.begin(),
+                          std::unique(row.begin(), row.end()));
+    adj_offsets_ghost.push_back(adj_data_ghost.size());
+  }
+  std::vector<std::vector<std::int32_t>>().swap(_cache_unowned);
+  _ghost_rows = std::make_shared<graph::AdjacencyList<std::int32_t>>(
+      std::move(adj_data_ghost), std::move(adj_offsets_ghost));
 }
 //-----------------------------------------------------------------------------
 std::int64_t SparsityPattern::num_nonzeros() const
@@ -410,5 +423,13 @@ SparsityPattern::off_diagonal_pattern() const
   return *_off_diagonal;
 }
 //-----------------------------------------------------------------------------
+const graph::AdjacencyList<std::int32_t>&
+SparsityPattern::ghost_row_pattern() const
+{
+  if (!_ghost_rows)
+    throw std::runtime_error("Sparsity pattern has not been finalised.");
+  return *_ghost_rows;
+}
+//-----------------------------------------------------------------------------
 MPI_Comm SparsityPattern::mpi_comm() const { return _mpi_comm.comm(); }
 //-----------------------------------------------------------------------------
@@ -110,6 +110,11 @@ public:
   /// indices for the columns. Translate to global with column IndexMap.
   const graph::AdjacencyList<std::int32_t>& off_diagonal_pattern() const;
 
+  /// Sparsity pattern for the ghost (un-owned) rows, as inserted on
+  /// this process before finalisation. Row i corresponds to ghost i of
+  /// the row IndexMap. Uses local indices for the columns.
+  const graph::AdjacencyList<std::int32_t>& ghost_row_pattern() const;
+
   /// Return MPI communicator
   MPI_Comm mpi_comm() const;
 
@@ -131,5 +136,6 @@ private:
   // Sparsity pattern data (computed once pattern is finalised)
   std::shared_ptr<graph::AdjacencyList<std::int32_t>> _diagonal;
   std::shared_ptr<graph::AdjacencyList<std::int32_t>> _off_diagonal;
+  std::shared_ptr<graph::AdjacencyList<std::int32_t>> _ghost_rows;
 };
 } // namespace dolfinx::la
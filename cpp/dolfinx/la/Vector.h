@@ -43,7 +43,7 @@ public:
   Vector(const Vector& x)
       : _map(x._map), _bs(x._bs), _request(MPI_REQUEST_NULL),
         _buffer_send_fwd(x._buffer_send_fwd),
-        _buffer_recv_fwd(x._buffer_recv_fwd), _x(x._x)
+        _buffer_recv_fwd(x._buffer_recv_fwd), _x(x._x), _version(x._version)
   {
     MPI_Type_dup(x._datatype, &_datatype);
   }
@@ -54,7 +54,8 @@ public:
         _datatype(std::exchange(x._datatype, MPI_DATATYPE_NULL)),
         _request(std::exchange(x._request, MPI_REQUEST_NULL)),
         _buffer_send_fwd(std::move(x._buffer_send_fwd)),
-        _buffer_recv_fwd(std::move(x._buffer_recv_fwd)), _x(std::move(x._x))
+        _buffer_recv_fwd(std::move(x._buffer_recv_fwd)), _x(std::move(x._x)),
+        _version(x._version)
   {
   }
 
@@ -110,6 +111,7 @@ public:
       std::copy_n(std::next(_buffer_recv_fwd.cbegin(), _bs * pos), _bs,
                   std::next(xremote.begin(), _bs * i));
     }
+    ++_version;
   }
 
   /// Scatter local data to ghost positions on other ranks
@@ -173,6 +175,7 @@ public:
           _x[shared_indices[i] * _bs + j] += _buffer_send_fwd[i * _bs + j];
       break;
     }
+    ++_version;
   }
 
   /// Scatter ghost data to owner. This process may receive data from
@@ -238,8 +241,28 @@ public:
   /// Get local part of the vector (const version)
   xtl::span<const T> array() const { return xtl::span<const T>(_x); }
 
-  /// Get local part of the vector
-  xtl::span<T> mutable_array() { return xtl::span(_x); }
+  /// Get local part of the vector. This increments the version of
+  /// the vector.
+  xtl::span<T> mutable_array()
+  {
+    ++_version;
+    return xtl::span(_x);
+  }
+
+  /// Modification counter. It is incremented whenever the vector
+  /// entries may have changed, i.e. when mutable access to the entries
+  /// is requested and when a ghost update completes. It can be used to
+  /// detect that data derived from the vector is out of date.
+  /// @note The counter is incremented when a view is requested, not
+  /// when entries are written. Changes made through a view that was
+  /// obtained earlier (e.g. a span returned by mutable_array or a
+  /// Python array) are not detected, and increment_version must be
+  /// called after such changes. Otherwise, data such as the packed
+  /// coefficients retained by fem::Form is not updated.
+  std::size_t version() const { return _version; }
+
+  /// Increment the modification counter, see version()
+  void increment_version() { ++_version; }
 
 private:
   // Map describing the data layout
@@ -255,6 +278,9 @@ private:
 
   // Data
   std::vector<T, Allocator> _x;
+
+  // Modification counter
+  std::size_t _version = 0;
 };
 
 /// Compute the inner product of two vectors. The two vectors must have
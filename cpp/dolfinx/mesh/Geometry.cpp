@@ -29,7 +29,12 @@ std::shared_ptr<const common::IndexMap> Geometry::index_map() const
   return _index_map;
 }
 //-----------------------------------------------------------------------------
-xt::xtensor<double, 2>& Geometry::x() { return _x; }
+xt::xtensor<double, 2>& Geometry::x()
+{
+  // Caller may modify the coordinates
+  _cache.valid = false;
+  return _x;
+}
 //-----------------------------------------------------------------------------
 const xt::xtensor<double, 2>& Geometry::x() const { return _x; }
 //-----------------------------------------------------------------------------
@@ -40,6 +45,50 @@ const std::vector<std::int64_t>& Geometry::input_global_indices() const
   return _input_global_indices;
 }
 //-----------------------------------------------------------------------------
+void Geometry::cache_cell_geometry(bool enable)
+{
+  if (!enable)
+    _cache = CellGeometryCache();
+  else if (!_cache.enabled)
+  {
+    _cache.enabled = true;
+    _cache.valid = false;
+  }
+}
+//-----------------------------------------------------------------------------
+bool Geometry::cell_geometry_cached() const { return _cache.enabled; }
+//-----------------------------------------------------------------------------
+void Geometry::invalidate_cell_cache() { _cache.valid = false; }
+//-----------------------------------------------------------------------------
+xtl::span<const double> Geometry::cell_coordinates() const
+{
+  update_cell_geometry_cache();
+  return xtl::span<const double>(_cache.x);
+}
+//-----------------------------------------------------------------------------
+void Geometry::update_cell_geometry_cache() const
+{
+  if (!_cache.enabled or _cache.valid)
+    return;
+
+  const std::int32_t num_cells = _dofmap.num_nodes();
+  const std::size_t num_dofs_g = num_cells > 0 ? _dofmap.num_links(0) : 0;
+
+  // Gather coordinate dofs cell-by-cell
+  _cache.x.resize(num_cells * num_dofs_g * 3);
+  for (std::int32_t c = 0; c < num_cells; ++c)
+  {
+    auto x_dofs = _dofmap.links(c);
+    for (std::size_t i = 0; i < x_dofs.size(); ++i)
+    {
+      std::copy_n(xt::row(_x, x_dofs[i]).begin(), 3,
+                  std::next(_cache.x.begin(), 3 * (c * num_dofs_g + i)));
+    }
+  }
+
+  _cache.valid = true;
+}
+//-----------------------------------------------------------------------------
 
 //-----------------------------------------------------------------------------
 mesh::Geometry mesh::create_geometry(
@@ -16,6 +16,7 @@
 #include <xtensor/xbuilder.hpp>
 #include <xtensor/xtensor.hpp>
 #include <xtensor/xview.hpp>
+#include <xtl/xspan.hpp>
 
 namespace dolfinx::common
 {
@@ -89,6 +90,10 @@ public:
   std::shared_ptr<const common::IndexMap> index_map() const;
 
   /// Geometry degrees-of-freedom
+  /// @note Calling the non-const version invalidates the cell geometry
+  /// cache, if enabled. If the returned reference (or a view of it) is
+  /// kept and modified later, invalidate_cell_cache() must be called
+  /// after the modification.
   xt::xtensor<double, 2>& x();
 
   /// Geometry degrees-of-freedom
@@ -101,7 +106,36 @@ public:
   /// Global user indices
   const std::vector<std::int64_t>& input_global_indices() const;
 
+  /// Enable or disable the cell geometry cache. When enabled, the
+  /// coordinate dofs of each cell are stored contiguously (cell-major)
+  /// so that assemblers can read them without an indirect gather over
+  /// x(). The cache is built on first use and rebuilt after x() has
+  /// been accessed for modification or invalidate_cell_cache() has been
+  /// called.
+  /// @param[in] enable Turn caching on (true) or off (false)
+  void cache_cell_geometry(bool enable);
+
+  /// Check if the cell geometry cache is enabled
+  bool cell_geometry_cached() const;
+
+  /// Mark the cell geometry cache as out-of-date so that it is rebuilt
+  /// on next use. Must be called after modifying the coordinates
+  /// through a reference or view to x() that was obtained before the
+  /// last use of the cache.
+  void invalidate_cell_cache();
+
+  /// Cached coordinate dofs for all cells (including ghosts), stored
+  /// row-major with shape (num_cells, num_dofs_per_cell, 3). The cache
+  /// is (re)built if out-of-date.
+  /// @return The cell coordinate dofs. Empty if caching is not enabled.
+  /// @note Not thread-safe if the cache needs to be (re)built. Call
+  /// before launching threads.
+  xtl::span<const double> cell_coordinates() const;
+
 private:
+  // (Re)build the cell geometry cache if it is out-of-date
+  void update_cell_geometry_cache() const;
+
   // Geometric dimension
   int _dim;
 
@@ -119,6 +153,15 @@ private:
 
   // Global indices as provided on Geometry creation
   std::vector<std::int64_t> _input_global_indices;
+
+  // Cell geometry cache. Mutable since the cache is built lazily.
+  struct CellGeometryCache
+  {
+    bool enabled = false;
+    bool valid = false;
+    std::vector<double> x;
+  };
+  mutable CellGeometryCache _cache;
 };
 
 /// Build Geometry
@@ -33,6 +33,19 @@ reorder_list(const graph::AdjacencyList<T>& list,
 {
   // Copy existing data to keep ghost values (not reordered)
   std::vector<T> data(list.array());
+
+  // Constant degree lists are re-ordered without offsets
+  if (const int degree = list.degree(); degree > 0)
+  {
+    for (std::size_t n = 0; n < nodemap.size(); ++n)
+    {
+      auto links_old = list.links(n);
+      std::copy(links_old.begin(), links_old.end(),
+                std::next(data.begin(), std::size_t(nodemap[n]) * degree));
+    }
+    return graph::AdjacencyList<T>(std::move(data), degree);
+  }
+
   std::vector<std::int32_t> offsets(list.offsets().size());
 
   // Compute new offsets (owned and ghost)
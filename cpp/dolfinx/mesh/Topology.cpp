@@ -138,10 +138,15 @@ compute_vertex_markers(const graph::AdjacencyList<std::int64_t>& cells,
   common::Timer t0(
       "Topology: mark vertices by type (owned, possibly owned, ghost)");
 
+  // Number of vertex entries for the local cells
+  const std::int32_t num_local_entries
+      = cells.degree() > 0 ? num_local_cells * cells.degree()
+                           : cells.offsets()[num_local_cells];
+
   // Build a set of 'local' cell vertices
   std::vector<std::int64_t> local_vertex_set(
       cells.array().begin(),
-      std::next(cells.array().begin(), cells.offsets()[num_local_cells]));
+      std::next(cells.array().begin(), num_local_entries));
   dolfinx::radix_sort(xtl::span(local_vertex_set));
   local_vertex_set.erase(
       std::unique(local_vertex_set.begin(), local_vertex_set.end()),
@@ -149,8 +154,7 @@ compute_vertex_markers(const graph::AdjacencyList<std::int64_t>& cells,
 
   // Build a set of ghost cell vertices
   std::vector<std::int64_t> ghost_vertex_set(
-      std::next(cells.array().begin(), cells.offsets()[num_local_cells]),
-      cells.array().end());
+      std::next(cells.array().begin(), num_local_entries), cells.array().end());
   dolfinx::radix_sort(xtl::span(ghost_vertex_set));
   ghost_vertex_set.erase(
       std::unique(ghost_vertex_set.begin(), ghost_vertex_set.end()),
@@ -388,6 +392,23 @@ graph::AdjacencyList<std::int32_t> convert_cells_to_local_indexing(
     const std::unordered_map<std::int64_t, std::int32_t>
         global_to_local_vertices)
 {
+  auto to_local = [&global_to_local_vertices](std::int64_t i)
+  { return global_to_local_vertices.at(i); };
+
+  // Keep constant degree (single cell type) lists without offsets
+  if (const int degree = cells.degree(); degree > 0)
+  {
+    const std::int32_t num_cells = ghost_mode == mesh::GhostMode::none
+                                       ? num_local_cells
+                                       : cells.num_nodes();
+    std::vector<std::int32_t> cells_array_local(num_cells * degree);
+    std::transform(cells.array().begin(),
+                   std::next(cells.array().begin(), cells_array_local.size()),
+                   cells_array_local.begin(), to_local);
+    return graph::AdjacencyList<std::int32_t>(std::move(cells_array_local),
+                                              degree);
+  }
+
   std::vector<std::int32_t> local_offsets;
   if (ghost_mode == mesh::GhostMode::none)
   {
@@ -402,9 +423,7 @@ graph::AdjacencyList<std::int32_t> convert_cells_to_local_indexing(
   std::vector<std::int32_t> cells_array_local(local_offsets.back());
   std::transform(cells.array().begin(),
                  std::next(cells.array().begin(), cells_array_local.size()),
-                 cells_array_local.begin(),
-                 [&global_to_local_vertices](std::int64_t i)
-                 { return global_to_local_vertices.at(i); });
+                 cells_array_local.begin(), to_local);
 
   return graph::AdjacencyList<std::int32_t>(std::move(cells_array_local),
                                             std::move(local_offsets));
@@ -468,7 +487,7 @@ std::shared_ptr<const common::IndexMap> Topology::index_map(int dim) const
   return _index_map[dim];
 }
 //-----------------------------------------------------------------------------
-std::int32_t Topology::create_entities(int dim)
+std::int32_t Topology::create_entities(int dim, int num_threads)
 {
   // TODO: is this check sufficient/correct? Does not catch the cell_entity
   // entity case. Should there also be a check for
@@ -479,7 +498,7 @@ std::int32_t Topology::create_entities(int dim)
 
   // Create local entities
   const auto [cell_entity, entity_vertex, index_map]
-      = mesh::compute_entities(_mpi_comm.comm(), *this, dim);
+      = mesh::compute_entities(_mpi_comm.comm(), *this, dim, num_threads);
 
   if (cell_entity)
     set_connectivity(cell_entity, this->dim(), dim);
@@ -494,14 +513,15 @@ std::int32_t Topology::create_entities(int dim)
   return index_map->size_local();
 }
 //-----------------------------------------------------------------------------
-void Topology::create_connectivity(int d0, int d1)
+void Topology::create_connectivity(int d0, int d1, int num_threads)
 {
   // Make sure entities exist
-  create_entities(d0);
-  create_entities(d1);
+  create_entities(d0, num_threads);
+  create_entities(d1, num_threads);
 
   // Compute connectivity
-  const auto [c_d0_d1, c_d1_d0] = mesh::compute_connectivity(*this, d0, d1);
+  const auto [c_d0_d1, c_d1_d0]
+      = mesh::compute_connectivity(*this, d0, d1, num_threads);
 
   // NOTE: that to compute the (d0, d1) connections is it sometimes
   // necessary to compute the (d1, d0) connections. We store the (d1,
@@ -515,11 +535,12 @@ void Topology::create_connectivity(int d0, int d1)
   // Concerning the note above: Provide an overload
   // create_connectivity(std::vector<std::pair<int, int>>)?
 
-  // Attach connectivities
-  if (c_d0_d1)
-    set_connectivity(c_d0_d1, d0, d1);
+  // Attach connectivities. The requested connectivity is attached last
+  // so that it is not released if there is a memory budget.
   if (c_d1_d0)
     set_connectivity(c_d1_d0, d1, d0);
+  if (c_d0_d1)
+    set_connectivity(c_d0_d1, d0, d1);
 }
 //-----------------------------------------------------------------------------
 void Topology::create_entity_permutations()
@@ -547,6 +568,20 @@ Topology::connectivity(int d0, int d1) const
 {
   assert(d0 < (int)_connectivity.size());
   assert(d1 < (int)_connectivity[d0].size());
+  if (_released[d0][d1])
+  {
+    // Recompute released connectivity. Clear the flag first since
+    // compute_connectivity checks if (d0, d1) exists.
+    LOG(INFO) << "Recomputing released connectivity " << d0 << " - " << d1;
+    _released[d0][d1] = false;
+    _connectivity[d0][d1] = mesh::compute_connectivity(*this, d0, d1)[0];
+    assert(_connectivity[d0][d1]);
+    _last_access[d0][d1] = ++_access_count;
+    enforce_memory_budget(d0, d1);
+  }
+  else if (_memory_budget > 0)
+    _last_access[d0][d1] = ++_access_count;
+
   return _connectivity[d0][d1];
 }
 //-----------------------------------------------------------------------------
@@ -556,6 +591,113 @@ void Topology::set_connectivity(
   assert(d0 < (int)_connectivity.size());
   assert(d1 < (int)_connectivity[d0].size());
   _connectivity[d0][d1] = c;
+  _released[d0][d1] = false;
+  _last_access[d0][d1] = ++_access_count;
+  enforce_memory_budget(d0, d1);
+}
+//-----------------------------------------------------------------------------
+void Topology::release_connectivity(int d0, int d1)
+{
+  const int tdim = this->dim();
+  assert(d0 <= tdim);
+  assert(d1 <= tdim);
+  if (!is_entity_connectivity(d0, d1))
+  {
+    // Derived connectivity, which can be recomputed locally
+    if (_connectivity[d0][d1])
+    {
+      _connectivity[d0][d1] = nullptr;
+      _released[d0][d1] = true;
+    }
+    return;
+  }
+
+  const int d = (d1 == 0) ? d0 : d1;
+  if (d == 0 or d == tdim)
+  {
+    throw std::runtime_error("Cannot release connectivity "
+                             + std::to_string(d0) + " - " + std::to_string(d1)
+                             + ". Vertices and cells cannot be released.");
+  }
+
+  // Remove the entities of dimension d
+  for (int i = 0; i <= tdim; ++i)
+  {
+    _connectivity[d][i] = nullptr;
+    _connectivity[i][d] = nullptr;
+    _released[d][i] = false;
+    _released[i][d] = false;
+  }
+  _index_map[d] = nullptr;
+}
+//-----------------------------------------------------------------------------
+void Topology::set_connectivity_memory_budget(std::size_t bytes)
+{
+  _memory_budget = bytes;
+  enforce_memory_budget(-1, -1);
+}
+//-----------------------------------------------------------------------------
+std::size_t Topology::connectivity_memory_budget() const
+{
+  return _memory_budget;
+}
+//-----------------------------------------------------------------------------
+std::size_t Topology::connectivity_memory(int d0, int d1) const
+{
+  assert(d0 < (int)_connectivity.size());
+  assert(d1 < (int)_connectivity[d0].size());
+  if (auto c = _connectivity[d0][d1]; c)
+  {
+    // Offsets of constant degree lists are only counted if they have
+    // been created
+    return sizeof(std::int32_t)
+           * (c->array().capacity() + c->offsets_capacity());
+  }
+  else
+    return 0;
+}
+//-----------------------------------------------------------------------------
+bool Topology::is_entity_connectivity(int d0, int d1) const
+{
+  return d1 == 0 or d0 == this->dim();
+}
+//-----------------------------------------------------------------------------
+void Topology::enforce_memory_budget(int d0, int d1) const
+{
+  if (_memory_budget == 0)
+    return;
+
+  const int tdim = this->dim();
+  while (true)
+  {
+    // Compute memory used by derived connectivities, and find the
+    // least recently used one
+    std::size_t memory = 0;
+    std::array<int, 2> lru = {-1, -1};
+    for (int i = 0; i <= tdim; ++i)
+    {
+      for (int j = 0; j <= tdim; ++j)
+      {
+        if (!_connectivity[i][j] or is_entity_connectivity(i, j))
+          continue;
+        memory += connectivity_memory(i, j);
+        if ((i != d0 or j != d1)
+            and (lru[0] == -1
+                 or _last_access[i][j] < _last_access[lru[0]][lru[1]]))
+        {
+          lru = {i, j};
+        }
+      }
+    }
+
+    if (memory <= _memory_budget or lru[0] == -1)
+      return;
+
+    LOG(INFO) << "Releasing connectivity " << lru[0] << " - " << lru[1]
+              << " to meet memory budget";
+    _connectivity[lru[0]][lru[1]] = nullptr;
+    _released[lru[0]][lru[1]] = true;
+  }
 }
 //-----------------------------------------------------------------------------
 const std::vector<std::uint32_t>& Topology::get_cell_permutation_info() const
@@ -52,6 +52,14 @@ std::vector<bool> compute_boundary_facets(const Topology& topology);
 /// A mesh entity e may be identified globally as a pair e = (dim, i),
 /// where dim is the topological dimension and i is the index of the
 /// entity within that topological dimension.
+///
+/// The connectivities (d, 0) and (tdim, d) define the entities of
+/// dimension d and their parallel numbering. All other connectivities
+/// are derived from these without parallel communication. Derived
+/// connectivities can be released to save memory, either explicitly
+/// (see release_connectivity) or by setting a memory budget (see
+/// set_connectivity_memory_budget), and are recomputed when next
+/// requested.
 class Topology
 {
 public:
@@ -97,6 +105,12 @@ public:
   /// @return The adjacency list that for each entity of dimension d0
   /// gives the list of incident entities of dimension d1. Returns
   /// `nullptr` if connectivity has not been computed.
+  /// @note A derived connectivity that has been released is recomputed
+  /// by this function, and when a memory budget is set (see
+  /// set_connectivity_memory_budget) every call records the access for
+  /// least recently used release. Both modify the topology, so this
+  /// function is not thread-safe if connectivities have been released
+  /// or a memory budget is set.
   std::shared_ptr<const graph::AdjacencyList<std::int32_t>>
   connectivity(int d0, int d1) const;
 
@@ -105,6 +119,39 @@ public:
   void set_connectivity(std::shared_ptr<graph::AdjacencyList<std::int32_t>> c,
                         int d0, int d1);
 
+  /// Release the connectivity (d0, d1). A derived connectivity is
+  /// recomputed when next requested via connectivity(d0, d1). If (d0,
+  /// d1) defines the entities of dimension d, i.e. (d, 0) or (tdim, d)
+  /// with 0 < d < tdim, the entities of dimension d are removed
+  /// together with their index map and all connectivities involving
+  /// dimension d. They can be created again with create_entities.
+  ///
+  /// Connectivity that is still used elsewhere (through a shared
+  /// pointer returned by connectivity) is freed when the last user
+  /// releases it.
+  /// @param[in] d0 Topological dimension
+  /// @param[in] d1 Topological dimension
+  void release_connectivity(int d0, int d1);
+
+  /// Set a memory budget for the derived connectivities. When the
+  /// connectivities that can be recomputed exceed the budget, the
+  /// least recently used are released until the budget is met. The
+  /// connectivities that define the entities are not counted.
+  /// @param[in] bytes The budget in bytes. A budget of zero (the
+  /// default) means no limit.
+  void set_connectivity_memory_budget(std::size_t bytes);
+
+  /// Memory budget for the derived connectivities
+  /// @return The budget in bytes, zero if there is no limit
+  std::size_t connectivity_memory_budget() const;
+
+  /// Memory used by the connectivity (d0, d1)
+  /// @param[in] d0 Topological dimension
+  /// @param[in] d1 Topological dimension
+  /// @return The size of the connectivity data in bytes, zero if the
+  /// connectivity does not exist
+  std::size_t connectivity_memory(int d0, int d1) const;
+
   /// Returns the permutation information
   const std::vector<std::uint32_t>& get_cell_permutation_info() const;
 
@@ -125,20 +172,18 @@ public:
   /// @return Cell type that the topology is for
   mesh::CellType cell_type() const noexcept;
 
-  // TODO: Rework memory management and associated API
-  // Currently, there is no clear caching policy implemented and no way of
-  // discarding cached data.
-
   /// Create entities of given topological dimension.
   /// @param[in] dim Topological dimension
+  /// @param[in] num_threads Number of threads to use
   /// @return Number of newly created entities, returns -1 if entities
   /// already existed
-  std::int32_t create_entities(int dim);
+  std::int32_t create_entities(int dim, int num_threads = 1);
 
   /// Create connectivity between given pair of dimensions, d0 -> d1
   /// @param[in] d0 Topological dimension
   /// @param[in] d1 Topological dimension
-  void create_connectivity(int d0, int d1);
+  /// @param[in] num_threads Number of threads to use
+  void create_connectivity(int d0, int d1, int num_threads = 1);
 
   /// Compute entity permutations and reflections
   void create_entity_permutations();
@@ -157,10 +202,34 @@ private:
   // Parallel layout of entities for each dimension
   std::array<std::shared_ptr<const common::IndexMap>, 4> _index_map;
 
-  // AdjacencyList for pairs [d0][d1] == d0 -> d1 connectivity
-  std::vector<std::vector<std::shared_ptr<graph::AdjacencyList<std::int32_t>>>>
+  // True if the connectivity (d0, d1) defines the entities of a
+  // dimension and can only be recomputed collectively
+  bool is_entity_connectivity(int d0, int d1) const;
+
+  // Release least recently used derived connectivities, except (d0,
+  // d1), until the memory budget is met
+  void enforce_memory_budget(int d0, int d1) const;
+
+  // AdjacencyList for pairs [d0][d1] == d0 -> d1 connectivity. Mutable
+  // because released connectivities are recomputed on access.
+  mutable std::vector<
+      std::vector<std::shared_ptr<graph::AdjacencyList<std::int32_t>>>>
       _connectivity;
 
+  // Derived connectivities that have been released and are recomputed
+  // on access
+  mutable std::array<std::array<bool, 4>, 4> _released = {};
+
+  // Memory budget (bytes) for derived connectivities, zero for no
+  // limit
+  std::size_t _memory_budget = 0;
+
+  // Access counter and the count at the most recent access of each
+  // connectivity, used for least recently used release. Updated by
+  // connectivity() when a memory budget is set.
+  mutable std::uint64_t _access_count = 0;
+  mutable std::array<std::array<std::uint64_t, 4>, 4> _last_access = {};
+
   // The facet permutations (local facet, cell))
   // [cell0_0, cell0_1, ,cell0_2, cell1_0, cell1_1, ,cell1_2, ...,
   // celln_0, celln_1, ,celln_2,]
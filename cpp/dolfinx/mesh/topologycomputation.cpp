@@ -8,6 +8,7 @@
 #include "Topology.h"
 #include "cell_types.h"
 #include <algorithm>
+#include <atomic>
 #include <boost/unordered_map.hpp>
 #include <cstdint>
 #include <dolfinx/common/IndexMap.h>
@@ -17,10 +18,12 @@
 #include <dolfinx/common/sort.h>
 #include <dolfinx/common/utils.h>
 #include <dolfinx/graph/AdjacencyList.h>
+#include <limits>
 #include <memory>
 #include <numeric>
 #include <random>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <unordered_map>
 #include <utility>
@@ -33,6 +36,177 @@ using namespace dolfinx;
 namespace
 {
 //-----------------------------------------------------------------------------
+
+/// Split the range [0, n) into @p num_blocks contiguous blocks and call
+/// `fn(b, i0, i1)` for each block b = [i0, i1) concurrently. The first
+/// block is processed on the calling thread.
+template <typename Fn>
+void for_each_block(std::size_t n, int num_blocks, const Fn& fn)
+{
+  if (num_blocks < 1)
+    throw std::runtime_error("Number of threads must be positive.");
+  std::vector<std::thread> threads;
+  for (int b = 1; b < num_blocks; ++b)
+  {
+    threads.emplace_back(std::cref(fn), b, b * n / num_blocks,
+                         (b + 1) * n / num_blocks);
+  }
+  fn(0, 0, n / num_blocks);
+  for (std::thread& t : threads)
+    t.join();
+}
+//-----------------------------------------------------------------------------
+
+/// Sort (lexicographically, with column 0 the most significant) the
+/// rows of an array that are listed in @p rows, using a radix sort on
+/// each column
+/// @param[in] keys The array
+/// @param[in,out] rows Indices of the rows to sort. On exit the row
+/// indices are in sorted order.
+void sort_rows(const xt::xtensor<std::int32_t, 2>& keys,
+               xtl::span<std::int32_t> rows)
+{
+  std::vector<std::int32_t> perm(rows.size());
+  std::iota(perm.begin(), perm.end(), 0);
+  std::vector<std::int32_t> column(rows.size());
+  for (int j = keys.shape(1) - 1; j >= 0; --j)
+  {
+    for (std::size_t i = 0; i < rows.size(); ++i)
+      column[i] = keys(rows[i], j);
+    dolfinx::argsort_radix<std::int32_t, 16>(column, perm);
+  }
+
+  std::vector<std::int32_t> sorted(rows.size());
+  for (std::size_t i = 0; i < rows.size(); ++i)
+    sorted[i] = rows[perm[i]];
+  std::copy(sorted.begin(), sorted.end(), rows.begin());
+}
+//-----------------------------------------------------------------------------
+
+/// Number the rows of an array such that identical rows have the same
+/// number and the numbers follow the lexicographic order of the rows.
+///
+/// The rows are distributed over threads by ranges of the value in
+/// column 0, which is the most significant key, with the ranges chosen
+/// to balance the number of rows per thread. Each thread then sorts and
+/// numbers its rows independently, and the numbers are offset by the
+/// number of unique rows on the preceding threads. The result does not
+/// depend on the number of threads.
+/// @param[in] keys The array. The values in column 0 must be in the
+/// range [0, num_values0).
+/// @param[in] num_values0 Upper bound on the values in column 0
+/// @param[in] num_threads Number of threads
+/// @return The number of each row and a representative row for each
+/// number
+std::pair<std::vector<std::int32_t>, std::vector<std::int32_t>>
+number_rows(const xt::xtensor<std::int32_t, 2>& keys,
+            std::int32_t num_values0, int num_threads)
+{
+  const std::size_t num_rows = keys.shape(0);
+  const std::size_t num_cols = keys.shape(1);
+  auto row = [&keys, num_cols](std::size_t i)
+  { return keys.data() + i * num_cols; };
+
+  // Assign the values in column 0 to buckets (one per thread) such
+  // that the buckets hold similar numbers of rows
+  std::vector<std::int32_t> bucket(num_values0, 0);
+  if (num_threads > 1)
+  {
+    std::vector<std::int64_t> count(num_values0, 0);
+    for (std::size_t i = 0; i < num_rows; ++i)
+      ++count[keys(i, 0)];
+    std::int64_t cumulative = 0;
+    for (std::int32_t v = 0, b = 0; v < num_values0; ++v)
+    {
+      bucket[v] = b;
+      cumulative += count[v];
+      if (b < num_threads - 1
+          and cumulative * num_threads >= (b + 1) * (std::int64_t)num_rows)
+      {
+        ++b;
+      }
+    }
+  }
+
+  // Count the rows in each (block, bucket) pair, where block b is the
+  // range of rows handled by thread b
+  std::vector<std::int32_t> pos(num_threads * num_threads, 0);
+  for_each_block(num_rows, num_threads,
+                 [&](int b, std::size_t i0, std::size_t i1)
+                 {
+                   std::int32_t* p = pos.data() + b * num_threads;
+                   for (std::size_t i = i0; i < i1; ++i)
+                     ++p[bucket[keys(i, 0)]];
+                 });
+
+  // Convert the counts to insert positions, ordered by bucket and then
+  // by block so that rows keep their relative order within a bucket
+  std::vector<std::int32_t> bucket_offsets(num_threads + 1, 0);
+  for (int k = 0; k < num_threads; ++k)
+  {
+    bucket_offsets[k + 1] = bucket_offsets[k];
+    for (int b = 0; b < num_threads; ++b)
+    {
+      const std::int32_t n = pos[b * num_threads + k];
+      pos[b * num_threads + k] = bucket_offsets[k + 1];
+      bucket_offsets[k + 1] += n;
+    }
+  }
+
+  // Place the row indices in their buckets
+  std::vector<std::int32_t> rows(num_rows);
+  for_each_block(num_rows, num_threads,
+                 [&](int b, std::size_t i0, std::size_t i1)
+                 {
+                   std::int32_t* p = pos.data() + b * num_threads;
+                   for (std::size_t i = i0; i < i1; ++i)
+                     rows[p[bucket[keys(i, 0)]]++] = i;
+                 });
+
+  // Sort the rows in each bucket and count the unique rows
+  std::vector<std::int32_t> num_unique(num_threads + 1, 0);
+  for_each_block(
+      num_threads, num_threads,
+      [&](int k, std::size_t, std::size_t)
+      {
+        xtl::span<std::int32_t> r(rows.data() + bucket_offsets[k],
+                                  bucket_offsets[k + 1] - bucket_offsets[k]);
+        sort_rows(keys, r);
+        for (std::size_t i = 0; i < r.size(); ++i)
+        {
+          if (i == 0
+              or !std::equal(row(r[i]), row(r[i]) + num_cols, row(r[i - 1])))
+          {
+            ++num_unique[k + 1];
+          }
+        }
+      });
+  std::partial_sum(num_unique.begin(), num_unique.end(), num_unique.begin());
+
+  // Number the rows
+  std::vector<std::int32_t> index(num_rows);
+  std::vector<std::int32_t> representative(num_unique.back());
+  for_each_block(
+      num_threads, num_threads,
+      [&](int k, std::size_t, std::size_t)
+      {
+        std::int32_t count = num_unique[k] - 1;
+        for (std::int32_t i = bucket_offsets[k]; i < bucket_offsets[k + 1];
+             ++i)
+        {
+          if (i == bucket_offsets[k]
+              or !std::equal(row(rows[i]), row(rows[i]) + num_cols,
+                             row(rows[i - 1])))
+          {
+            representative[++count] = rows[i];
+          }
+          index[rows[i]] = count;
+        }
+      });
+
+  return {std::move(index), std::move(representative)};
+}
+//-----------------------------------------------------------------------------
 /// Get the ownership of an entity shared over several processes
 /// @param processes Set of sharing processes
 /// @param vertices Global vertex indices of entity
@@ -379,6 +553,7 @@ get_local_indexing(MPI_Comm comm, const common::IndexMap& cell_indexmap,
 /// @param[in] shared_vertices TODO
 /// @param[in] cell_type Cell type
 /// @param[in] dim Topological dimension of the entities to be computed
+/// @param[in] num_threads Number of threads
 /// @return Returns the (cell-entity connectivity, entity-cell
 ///   connectivity, index map for the entity distribution across
 ///   processes, shared entities)
@@ -387,7 +562,8 @@ std::tuple<graph::AdjacencyList<std::int32_t>,
 compute_entities_by_key_matching(
     MPI_Comm comm, const graph::AdjacencyList<std::int32_t>& cells,
     const common::IndexMap& vertex_index_map,
-    const common::IndexMap& cell_index_map, mesh::CellType cell_type, int dim)
+    const common::IndexMap& cell_index_map, mesh::CellType cell_type, int dim,
+    int num_threads)
 {
   if (dim == 0)
   {
@@ -404,11 +580,13 @@ compute_entities_by_key_matching(
 
   // For some cells, the num_vertices varies per facet (3 or 4)
   int max_vertices_per_entity = 0;
+  int min_vertices_per_entity = std::numeric_limits<int>::max();
   for (int i = 0; i < num_entities_per_cell; ++i)
   {
-    max_vertices_per_entity = std::max(
-        max_vertices_per_entity,
-        mesh::num_cell_vertices(mesh::cell_entity_type(cell_type, dim, i)));
+    const int num_vertices
+        = mesh::num_cell_vertices(mesh::cell_entity_type(cell_type, dim, i));
+    max_vertices_per_entity = std::max(max_vertices_per_entity, num_vertices);
+    min_vertices_per_entity = std::min(min_vertices_per_entity, num_vertices);
   }
 
   // Create map from cell vertices to entity vertices
@@ -419,85 +597,104 @@ compute_entities_by_key_matching(
   xt::xtensor<std::int32_t, 2> entity_list(
       {num_cells * num_entities_per_cell,
        (std::size_t)max_vertices_per_entity});
-  for (std::size_t c = 0; c < num_cells; ++c)
-  {
-    // Get vertices from cell
-    auto vertices = cells.links(c);
-
-    for (int i = 0; i < num_entities_per_cell; ++i)
-    {
-      const std::int32_t idx = c * num_entities_per_cell + i;
-      auto ev = e_vertices.links(i);
-
-      // Get entity vertices padding with -1 if fewer than
-      // max_vertices_per_entity
-      entity_list(idx, max_vertices_per_entity - 1) = -1;
-      for (std::size_t j = 0; j < ev.size(); ++j)
-        entity_list(idx, j) = vertices[ev[j]];
-    }
-  }
+  for_each_block(
+      num_cells, num_threads,
+      [&](int, std::size_t c0, std::size_t c1)
+      {
+        for (std::size_t c = c0; c < c1; ++c)
+        {
+          // Get vertices from cell
+          auto vertices = cells.links(c);
+
+          for (int i = 0; i < num_entities_per_cell; ++i)
+          {
+            const std::int32_t idx = c * num_entities_per_cell + i;
+            auto ev = e_vertices.links(i);
+
+            // Get entity vertices padding with -1 if fewer than
+            // max_vertices_per_entity
+            entity_list(idx, max_vertices_per_entity - 1) = -1;
+            for (std::size_t j = 0; j < ev.size(); ++j)
+              entity_list(idx, j) = vertices[ev[j]];
+          }
+        }
+      });
 
   // Copy list and sort vertices of each entity into (reverse) order
   xt::xtensor<std::int32_t, 2> entity_list_sorted = entity_list;
-  for (std::size_t i = 0; i < entity_list_sorted.shape(0); ++i)
-  {
-    std::sort(xt::row(entity_list_sorted, i).begin(),
-              xt::row(entity_list_sorted, i).end(), std::greater<>());
-  }
-
-  // Sort the list and label uniquely
-  const std::vector<std::int32_t> sort_order
-      = dolfinx::sort_by_perm(entity_list_sorted);
-
-  std::vector<std::int32_t> entity_index(entity_list.shape(0), 0);
-  std::int32_t entity_count = 0;
-  std::int32_t last = sort_order[0];
-  for (std::size_t i = 1; i < sort_order.size(); ++i)
-  {
-    std::int32_t j = sort_order[i];
-    if (xt::row(entity_list_sorted, j) != xt::row(entity_list_sorted, last))
-      ++entity_count;
-    entity_index[j] = entity_count;
-    last = j;
-  }
-  ++entity_count;
+  for_each_block(entity_list_sorted.shape(0), num_threads,
+                 [&](int, std::size_t i0, std::size_t i1)
+                 {
+                   for (std::size_t i = i0; i < i1; ++i)
+                   {
+                     std::int32_t* v = entity_list_sorted.data()
+                                       + i * max_vertices_per_entity;
+                     std::sort(v, v + max_vertices_per_entity,
+                               std::greater<>());
+                   }
+                 });
+
+  // Sort the list and label uniquely. Column 0 holds the largest
+  // vertex index of each entity.
+  std::vector<std::int32_t> entity_index, representative;
+  std::tie(entity_index, representative) = number_rows(
+      entity_list_sorted,
+      vertex_index_map.size_local() + vertex_index_map.num_ghosts(),
+      num_threads);
+  const std::int32_t entity_count = representative.size();
 
   // Communicate with other processes to find out which entities are
   // ghosted and shared. Remap the numbering so that ghosts are at the
   // end.
-  auto [local_index, index_map] = get_local_indexing(
+  auto local_indexing = get_local_indexing(
       comm, cell_index_map, vertex_index_map, entity_list, entity_index);
+  auto& local_index = std::get<0>(local_indexing);
+  common::IndexMap& index_map = std::get<1>(local_indexing);
 
-  // Entity-vertex connectivity
-  std::vector<std::int32_t> offsets_ev(entity_count + 1, 0);
-  std::vector<int> size_ev(entity_count);
-  for (std::size_t i = 0; i < entity_list.shape(0); ++i)
+  // Entity-vertex connectivity. Offsets are only required if the
+  // entities do not all have the same number of vertices.
+  auto create_ev = [&]()
   {
-    size_ev[local_index[i]]
-        = (entity_list(i, max_vertices_per_entity - 1) == -1)
-              ? (max_vertices_per_entity - 1)
-              : max_vertices_per_entity;
-  }
-  for (int i = 0; i < entity_count; ++i)
-    offsets_ev[i + 1] = offsets_ev[i] + size_ev[i];
+    if (min_vertices_per_entity == max_vertices_per_entity)
+    {
+      return graph::AdjacencyList<std::int32_t>(
+          std::vector<std::int32_t>(entity_count * max_vertices_per_entity),
+          max_vertices_per_entity);
+    }
 
-  graph::AdjacencyList<std::int32_t> ev(
-      std::vector<std::int32_t>(offsets_ev.back()), std::move(offsets_ev));
-  for (std::size_t i = 0; i < entity_list.shape(0); ++i)
-  {
-    std::copy_n(xt::row(entity_list, i).begin(), ev.num_links(local_index[i]),
-                ev.links(local_index[i]).begin());
-  }
+    std::vector<std::int32_t> offsets_ev(entity_count + 1, 0);
+    for (std::int32_t e = 0; e < entity_count; ++e)
+    {
+      const std::int32_t i = representative[e];
+      offsets_ev[local_index[i] + 1]
+          = (entity_list(i, max_vertices_per_entity - 1) == -1)
+                ? (max_vertices_per_entity - 1)
+                : max_vertices_per_entity;
+    }
+    std::partial_sum(offsets_ev.begin(), offsets_ev.end(), offsets_ev.begin());
+    return graph::AdjacencyList<std::int32_t>(
+        std::vector<std::int32_t>(offsets_ev.back()), std::move(offsets_ev));
+  };
+  graph::AdjacencyList<std::int32_t> ev = create_ev();
+  for_each_block(entity_count, num_threads,
+                 [&](int, std::size_t e0, std::size_t e1)
+                 {
+                   for (std::size_t e = e0; e < e1; ++e)
+                   {
+                     const std::int32_t i = representative[e];
+                     auto links = ev.links(local_index[i]);
+                     std::copy_n(xt::row(entity_list, i).begin(),
+                                 links.size(), links.begin());
+                   }
+                 });
 
   // NOTE: Cell-entity connectivity comes after ev creation because
   // below we use std::move(local_index)
 
-  // Cell-entity connectivity
-  std::vector<std::int32_t> offsets_ce(num_cells + 1, 0);
-  for (std::size_t i = 0; i < offsets_ce.size() - 1; ++i)
-    offsets_ce[i + 1] = offsets_ce[i] + num_entities_per_cell;
-  graph::AdjacencyList<std::int32_t> ce(std::move(local_index),
-                                        std::move(offsets_ce));
+  // Cell-entity connectivity (constant degree)
+  graph::AdjacencyList<std::int32_t> ce
+      = graph::build_adjacency_list<std::int32_t>(std::move(local_index),
+                                                  num_entities_per_cell);
 
   return {std::move(ce), std::move(ev), std::move(index_map)};
 }
@@ -508,33 +705,88 @@ compute_entities_by_key_matching(
 /// @param[in] c_d1_d0 The connectivity from entities of dimension d1 to
 ///   entities of dimension d0
 /// @param[in] num_entities_d0 The number of entities of dimension d0
+/// @param[in] num_threads Number of threads
 /// @return The connectivity from entities of dimension d0 to entities
 ///   of dimension d1
 graph::AdjacencyList<std::int32_t>
 compute_from_transpose(const graph::AdjacencyList<std::int32_t>& c_d1_d0,
-                       const int num_entities_d0, int d0, int d1)
+                       const int num_entities_d0, int d0, int d1,
+                       int num_threads)
 {
   LOG(INFO) << "Computing mesh connectivity " << d0 << " - " << d1
             << " from transpose.";
 
-  // Compute number of connections for each e0
-  std::vector<std::int32_t> num_connections(num_entities_d0, 0);
-  for (int e1 = 0; e1 < c_d1_d0.num_nodes(); ++e1)
+  if (num_threads == 1)
   {
-    for (std::int32_t e0 : c_d1_d0.links(e1))
-      num_connections[e0]++;
+    // Compute number of connections for each e0
+    std::vector<std::int32_t> num_connections(num_entities_d0, 0);
+    for (int e1 = 0; e1 < c_d1_d0.num_nodes(); ++e1)
+    {
+      for (std::int32_t e0 : c_d1_d0.links(e1))
+        num_connections[e0]++;
+    }
+
+    // Compute offsets
+    std::vector<std::int32_t> offsets(num_connections.size() + 1, 0);
+    std::partial_sum(num_connections.begin(), num_connections.end(),
+                     std::next(offsets.begin()));
+
+    std::vector<std::int32_t> counter(num_connections.size(), 0);
+    std::vector<std::int32_t> connections(offsets[offsets.size() - 1]);
+    for (int e1 = 0; e1 < c_d1_d0.num_nodes(); ++e1)
+      for (std::int32_t e0 : c_d1_d0.links(e1))
+        connections[offsets[e0] + counter[e0]++] = e1;
+
+    return graph::AdjacencyList<std::int32_t>(std::move(connections),
+                                              std::move(offsets));
   }
 
+  // Compute number of connections for each e0, with the d1 entities
+  // split across threads
+  std::vector<std::atomic<std::int32_t>> num_connections(num_entities_d0);
+  for_each_block(c_d1_d0.num_nodes(), num_threads,
+                 [&](int, std::size_t e1_0, std::size_t e1_1)
+                 {
+                   for (std::size_t e1 = e1_0; e1 < e1_1; ++e1)
+                     for (std::int32_t e0 : c_d1_d0.links(e1))
+                       num_connections[e0].fetch_add(
+                           1, std::memory_order_relaxed);
+                 });
+
   // Compute offsets
   std::vector<std::int32_t> offsets(num_connections.size() + 1, 0);
-  std::partial_sum(num_connections.begin(), num_connections.end(),
-                   std::next(offsets.begin()));
-
-  std::vector<std::int32_t> counter(num_connections.size(), 0);
-  std::vector<std::int32_t> connections(offsets[offsets.size() - 1]);
-  for (int e1 = 0; e1 < c_d1_d0.num_nodes(); ++e1)
-    for (std::int32_t e0 : c_d1_d0.links(e1))
-      connections[offsets[e0] + counter[e0]++] = e1;
+  for (std::size_t e0 = 0; e0 < num_connections.size(); ++e0)
+    offsets[e0 + 1] = offsets[e0] + num_connections[e0].load();
+
+  // Insert connections, reusing the counts as insert positions
+  for (std::size_t e0 = 0; e0 < num_connections.size(); ++e0)
+    num_connections[e0].store(offsets[e0], std::memory_order_relaxed);
+  std::vector<std::int32_t> connections(offsets.back());
+  for_each_block(c_d1_d0.num_nodes(), num_threads,
+                 [&](int, std::size_t e1_0, std::size_t e1_1)
+                 {
+                   for (std::size_t e1 = e1_0; e1 < e1_1; ++e1)
+                   {
+                     for (std::int32_t e0 : c_d1_d0.links(e1))
+                     {
+                       connections[num_connections[e0].fetch_add(
+                           1, std::memory_order_relaxed)]
+                           = e1;
+                     }
+                   }
+                 });
+
+  // Sort the connections of each e0 so that the result is the same as
+  // the serial computation and does not depend on thread scheduling
+  for_each_block(num_entities_d0, num_threads,
+                 [&](int, std::size_t e0_0, std::size_t e0_1)
+                 {
+                   for (std::size_t e0 = e0_0; e0 < e0_1; ++e0)
+                   {
+                     std::sort(std::next(connections.begin(), offsets[e0]),
+                               std::next(connections.begin(), offsets[e0 + 1]));
+                   }
+                 });
 
   return graph::AdjacencyList<std::int32_t>(std::move(connections),
                                             std::move(offsets));
@@ -547,11 +799,12 @@ compute_from_transpose(const graph::AdjacencyList<std::int32_t>& c_d1_d0,
 /// @param[in] cell_type_d0 The cell type for entities of dimension d0
 /// @param[in] d0 Topological dimension
 /// @param[in] d1 Topological dimension
+/// @param[in] num_threads Number of threads
 /// @return The d0 -> d1 connectivity
 graph::AdjacencyList<std::int32_t>
 compute_from_map(const graph::AdjacencyList<std::int32_t>& c_d0_0,
                  const graph::AdjacencyList<std::int32_t>& c_d1_0, int d0,
-                 int d1)
+                 int d1, int num_threads)
 {
   // Only possible case is facet->edge
   assert(d0 == 2 and d1 == 1);
@@ -570,36 +823,51 @@ compute_from_map(const graph::AdjacencyList<std::int32_t>& c_d0_0,
   }
 
   // Number of edges for a tri/quad is the same as number of vertices
-  // so AdjacencyList will have same offset pattern
-  std::vector<std::int32_t> connections;
-  connections.reserve(c_d0_0.array().size());
-  std::vector<std::int32_t> offsets(c_d0_0.offsets());
-
-  // Search for edges of facet in map, and recover index
+  // so AdjacencyList will have same offset pattern. Offsets are only
+  // needed if the facets are not all of the same type.
+  std::vector<std::int32_t> connections(c_d0_0.array().size());
+  const int degree = c_d0_0.degree();
+  std::vector<std::int32_t> offsets;
+  if (degree < 0)
+    offsets = c_d0_0.offsets();
+
+  // Search for edges of facet in map, and recover index. The map is
+  // only read, so facets can be processed concurrently.
   const auto tri_vertices_ref
       = mesh::get_entity_vertices(mesh::CellType::triangle, 1);
   const auto quad_vertices_ref
       = mesh::get_entity_vertices(mesh::CellType::quadrilateral, 1);
 
-  for (int e = 0; e < c_d0_0.num_nodes(); ++e)
+  for_each_block(
+      c_d0_0.num_nodes(), num_threads,
+      [&](int, std::size_t e_0, std::size_t e_1)
+      {
+        std::array<std::int32_t, 2> edge;
+        for (std::size_t e = e_0; e < e_1; ++e)
+        {
+          auto e0 = c_d0_0.links(e);
+          const std::size_t pos = degree > 0 ? e * degree : offsets[e];
+          auto vref = (e0.size() == 3) ? &tri_vertices_ref : &quad_vertices_ref;
+          for (std::size_t i = 0; i < e0.size(); ++i)
+          {
+            const auto& v = vref->links(i);
+            for (int j = 0; j < 2; ++j)
+              edge[j] = e0[v[j]];
+            std::sort(edge.begin(), edge.end());
+            const auto it = edge_to_index.find(edge);
+            assert(it != edge_to_index.end());
+            connections[pos + i] = it->second;
+          }
+        }
+      });
+
+  if (degree > 0)
+    return graph::AdjacencyList<std::int32_t>(std::move(connections), degree);
+  else
   {
-    auto e0 = c_d0_0.links(e);
-    auto vref = (e0.size() == 3) ? &tri_vertices_ref : &quad_vertices_ref;
-    for (std::size_t i = 0; i < e0.size(); ++i)
-    {
-      const auto& v = vref->links(i);
-      for (int j = 0; j < 2; ++j)
-        key[j] = e0[v[j]];
-      std::sort(key.begin(), key.end());
-      const auto it = edge_to_index.find(key);
-      assert(it != edge_to_index.end());
-      connections.push_back(it->second);
-    }
+    return graph::AdjacencyList<std::int32_t>(std::move(connections),
+                                              std::move(offsets));
   }
-
-  connections.shrink_to_fit();
-  return graph::AdjacencyList<std::int32_t>(std::move(connections),
-                                            std::move(offsets));
 }
 //-----------------------------------------------------------------------------
 } // namespace
@@ -608,9 +876,12 @@ compute_from_map(const graph::AdjacencyList<std::int32_t>& c_d0_0,
 std::tuple<std::shared_ptr<graph::AdjacencyList<std::int32_t>>,
            std::shared_ptr<graph::AdjacencyList<std::int32_t>>,
            std::shared_ptr<common::IndexMap>>
-mesh::compute_entities(MPI_Comm comm, const Topology& topology, int dim)
+mesh::compute_entities(MPI_Comm comm, const Topology& topology, int dim,
+                       int num_threads)
 {
   LOG(INFO) << "Computing mesh entities of dimension " << dim;
+  if (num_threads < 1)
+    throw std::runtime_error("Number of threads must be positive.");
   const int tdim = topology.dim();
 
   // Vertices must always exist
@@ -640,7 +911,8 @@ mesh::compute_entities(MPI_Comm comm, const Topology& topology, int dim)
   auto cell_map = topology.index_map(tdim);
   assert(cell_map);
   auto [d0, d1, d2] = compute_entities_by_key_matching(
-      comm, *cells, *vertex_map, *cell_map, topology.cell_type(), dim);
+      comm, *cells, *vertex_map, *cell_map, topology.cell_type(), dim,
+      num_threads);
 
   return {std::make_shared<graph::AdjacencyList<std::int32_t>>(std::move(d0)),
           std::make_shared<graph::AdjacencyList<std::int32_t>>(std::move(d1)),
@@ -648,9 +920,12 @@ mesh::compute_entities(MPI_Comm comm, const Topology& topology, int dim)
 }
 //-----------------------------------------------------------------------------
 std::array<std::shared_ptr<graph::AdjacencyList<std::int32_t>>, 2>
-mesh::compute_connectivity(const Topology& topology, int d0, int d1)
+mesh::compute_connectivity(const Topology& topology, int d0, int d1,
+                           int num_threads)
 {
   LOG(INFO) << "Requesting connectivity " << d0 << " - " << d1;
+  if (num_threads < 1)
+    throw std::runtime_error("Number of threads must be positive.");
 
   // Return if connectivity has already been computed
   if (topology.connectivity(d0, d1))
@@ -690,9 +965,10 @@ mesh::compute_connectivity(const Topology& topology, int d0, int d1)
     if (!topology.connectivity(d1, d0))
     {
       auto c_d1_d0 = std::make_shared<graph::AdjacencyList<std::int32_t>>(
-          compute_from_map(*c_d1_0, *c_d0_0, d1, d0));
+          compute_from_map(*c_d1_0, *c_d0_0, d1, d0, num_threads));
       auto c_d0_d1 = std::make_shared<graph::AdjacencyList<std::int32_t>>(
-          compute_from_transpose(*c_d1_d0, c_d0_0->num_nodes(), d0, d1));
+          compute_from_transpose(*c_d1_d0, c_d0_0->num_nodes(), d0, d1,
+                                 num_threads));
       return {c_d0_d1, c_d1_d0};
     }
     else
@@ -701,7 +977,7 @@ mesh::compute_connectivity(const Topology& topology, int d0, int d1)
       assert(topology.connectivity(d1, d0));
       auto c_d0_d1 = std::make_shared<graph::AdjacencyList<std::int32_t>>(
           compute_from_transpose(*topology.connectivity(d1, d0),
-                                 c_d0_0->num_nodes(), d0, d1));
+                                 c_d0_0->num_nodes(), d0, d1, num_threads));
       return {c_d0_d1, nullptr};
     }
   }
@@ -710,7 +986,7 @@ mesh::compute_connectivity(const Topology& topology, int d0, int d1)
     // Compute by mapping vertices from a lower dimension entity to
     // those of a higher dimension entity
     auto c_d0_d1 = std::make_shared<graph::AdjacencyList<std::int32_t>>(
-        compute_from_map(*c_d0_0, *c_d1_0, d0, d1));
+        compute_from_map(*c_d0_0, *c_d1_0, d0, d1, num_threads));
     return {c_d0_d1, nullptr};
   }
   else
@@ -34,25 +34,32 @@ class Topology;
 /// @param[in] comm MPI Communicator
 /// @param[in] topology Mesh topology
 /// @param[in] dim The dimension of the entities to create
+/// @param[in] num_threads The number of threads to use for building,
+/// sorting and numbering the entities. Must be positive. The result
+/// does not depend on the number of threads.
 /// @return Tuple of (cell-entity connectivity, entity-vertex
 /// connectivity, index map). If the entities already exist, then
 /// {nullptr, nullptr, nullptr} is returned.
 std::tuple<std::shared_ptr<graph::AdjacencyList<std::int32_t>>,
            std::shared_ptr<graph::AdjacencyList<std::int32_t>>,
            std::shared_ptr<common::IndexMap>>
-compute_entities(MPI_Comm comm, const Topology& topology, int dim);
+compute_entities(MPI_Comm comm, const Topology& topology, int dim,
+                 int num_threads = 1);
 
 /// Compute connectivity (d0 -> d1) for given pair of topological
 /// dimensions
 /// @param[in] topology The topology
 /// @param[in] d0 The dimension of the nodes in the adjacency list
 /// @param[in] d1 The dimension of the edges in the adjacency list
+/// @param[in] num_threads The number of threads. Must be positive. The
+/// result does not depend on the number of threads.
 /// @returns The connectivities [(d0, d1), (d1, d0)] if they are
 /// computed. If (d0, d1) already exists then a nullptr is returned. If
 /// (d0, d1) is computed and the computation of (d1, d0) was required as
 /// part of computing (d0, d1), the (d1, d0) is returned as the second
 /// entry. The second entry is otherwise nullptr.
 std::array<std::shared_ptr<graph::AdjacencyList<std::int32_t>>, 2>
-compute_connectivity(const Topology& topology, int d0, int d1);
+compute_connectivity(const Topology& topology, int d0, int d1,
+                     int num_threads = 1);
 
 } // namespace dolfinx::mesh
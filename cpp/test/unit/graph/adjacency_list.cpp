@@ -0,0 +1,79 @@
+// Copyright (C) 2021 Garth N. Wells
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#include <catch.hpp>
+#include <dolfinx/graph/AdjacencyList.h>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+using namespace dolfinx;
+
+TEST_CASE("Test constant degree adjacency list", "[graph][adjacency_list]")
+{
+  auto num_nodes = GENERATE(0, 1, 10);
+  constexpr int degree = 3;
+
+  std::vector<std::int32_t> data(num_nodes * degree);
+  std::iota(data.begin(), data.end(), 0);
+  std::vector<std::int32_t> offsets(num_nodes + 1);
+  for (std::size_t i = 0; i < offsets.size(); ++i)
+    offsets[i] = i * degree;
+
+  const graph::AdjacencyList<std::int32_t> list0
+      = graph::build_adjacency_list<std::int32_t>(data, degree);
+  const graph::AdjacencyList<std::int32_t> list1(data, offsets);
+
+  CHECK(list0.degree() == degree);
+  CHECK(list1.degree() == -1);
+  REQUIRE(list0.num_nodes() == num_nodes);
+  for (int n = 0; n < num_nodes; ++n)
+  {
+    REQUIRE(list0.num_links(n) == degree);
+    auto links0 = list0.links(n);
+    auto links1 = list1.links(n);
+    CHECK(std::equal(links0.begin(), links0.end(), links1.begin(),
+                     links1.end()));
+  }
+
+  // Offsets of the constant degree list are created on request
+  CHECK(list0.offsets_capacity() == 0);
+  CHECK(list1.offsets_capacity() >= offsets.size());
+  CHECK(list0 == list1);
+  CHECK(list0.offsets() == offsets);
+  CHECK(list0.offsets_capacity() == offsets.size());
+
+  // A copy shares the created offsets
+  const graph::AdjacencyList<std::int32_t> list2(list0);
+  CHECK(list2.offsets_capacity() == offsets.size());
+  CHECK(&list2.offsets() == &list0.offsets());
+}
+
+TEST_CASE("Test concurrent creation of adjacency list offsets",
+          "[graph][adjacency_list]")
+{
+  constexpr int num_nodes = 1000;
+  constexpr int degree = 4;
+  std::vector<std::int32_t> data(num_nodes * degree, 0);
+  const graph::AdjacencyList<std::int32_t> list
+      = graph::build_adjacency_list<std::int32_t>(data, degree);
+
+  // All threads must see the same offsets
+  std::vector<const std::vector<std::int32_t>*> offsets(4, nullptr);
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < offsets.size(); ++i)
+  {
+    threads.emplace_back([&list, &offsets, i]()
+                         { offsets[i] = &list.offsets(); });
+  }
+  for (std::thread& t : threads)
+    t.join();
+
+  for (const std::vector<std::int32_t>* o : offsets)
+    CHECK(o == offsets.front());
+  REQUIRE(offsets.front()->size() == num_nodes + 1);
+  CHECK(offsets.front()->back() == num_nodes * degree);
+}
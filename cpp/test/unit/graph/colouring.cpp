@@ -0,0 +1,106 @@
+// Copyright (C) 2021 Garth N. Wells
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#include <algorithm>
+#include <atomic>
+#include <catch.hpp>
+#include <dolfinx/fem/utils.h>
+#include <dolfinx/graph/AdjacencyList.h>
+#include <dolfinx/graph/colouring.h>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace dolfinx;
+
+TEST_CASE("Test graph colouring", "[graph][colouring]")
+{
+  auto num_nodes = GENERATE(1, 10, 1000);
+  constexpr int num_resources = 200;
+  constexpr int degree = 4;
+
+  // Create a random list of resources for each node
+  std::uniform_int_distribution<std::int32_t> distribution(0,
+                                                           num_resources - 1);
+  std::mt19937 engine;
+  std::vector<std::int32_t> data(num_nodes * degree);
+  std::generate(data.begin(), data.end(),
+                [&]() { return distribution(engine); });
+  std::vector<std::int32_t> offsets(num_nodes + 1);
+  for (std::size_t i = 0; i < offsets.size(); ++i)
+    offsets[i] = i * degree;
+  const graph::AdjacencyList<std::int32_t> resources(data, offsets);
+
+  const graph::AdjacencyList<std::int32_t> colouring
+      = graph::compute_colouring(resources);
+
+  // Check that each node is coloured exactly once
+  std::vector<int> count(num_nodes, 0);
+  for (std::int32_t node : colouring.array())
+    ++count[node];
+  CHECK(std::all_of(count.begin(), count.end(),
+                    [](int c) { return c == 1; }));
+
+  // Check that nodes of the same colour do not share a resource
+  for (int c = 0; c < colouring.num_nodes(); ++c)
+  {
+    std::vector<bool> used(num_resources, false);
+    for (std::int32_t node : colouring.links(c))
+    {
+      std::vector<std::int32_t> r(resources.links(node).begin(),
+                                  resources.links(node).end());
+      std::sort(r.begin(), r.end());
+      r.erase(std::unique(r.begin(), r.end()), r.end());
+      for (std::int32_t j : r)
+      {
+        CHECK(!used[j]);
+        used[j] = true;
+      }
+    }
+  }
+}
+
+TEST_CASE("Test execution over colours", "[graph][colouring]")
+{
+  auto num_threads = GENERATE(1, 2, 5);
+  constexpr int num_entities = 1000;
+  std::vector<std::int32_t> entities(num_entities);
+  std::iota(entities.begin(), entities.end(), 0);
+
+  // Colours of different sizes, including an empty colour
+  std::vector<std::int32_t> positions(entities);
+  std::vector<std::int32_t> offsets = {0, 300, 301, 700, 700, num_entities};
+  const graph::AdjacencyList<std::int32_t> colouring(positions, offsets);
+  const xtl::span<const std::int32_t> e(entities);
+
+  // Each entity is visited once
+  std::vector<std::atomic<int>> count(num_entities);
+  fem::impl::for_each_colour<std::int32_t>(
+      e, colouring, num_threads,
+      [&count](const xtl::span<const std::int32_t>& block)
+      {
+        for (std::int32_t i : block)
+          ++count[i];
+      });
+  CHECK(std::all_of(count.begin(), count.end(),
+                    [](const std::atomic<int>& c) { return c == 1; }));
+
+  // An exception on any thread is rethrown on the calling thread, and
+  // later colours are not executed
+  std::atomic<bool> later(false);
+  CHECK_THROWS_AS(fem::impl::for_each_colour<std::int32_t>(
+                      e, colouring, num_threads,
+                      [&later](const xtl::span<const std::int32_t>& block)
+                      {
+                        if (!block.empty() and block.back() == 699)
+                          throw std::runtime_error("Kernel failed");
+                        if (!block.empty() and block.front() >= 700)
+                          later = true;
+                      }),
+                  std::runtime_error);
+  CHECK(!later);
+}
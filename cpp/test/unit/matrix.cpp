@@ -0,0 +1,88 @@
+// Copyright (C) 2021 Garth N. Wells
+//
+// This file is part of DOLFINx (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+//
+// Unit tests for distributed la::MatrixCSR
+
+#include <catch.hpp>
+#include <dolfinx.h>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/la/MatrixCSR.h>
+#include <dolfinx/la/SparsityPattern.h>
+#include <dolfinx/la/Vector.h>
+
+using namespace dolfinx;
+
+namespace
+{
+
+void test_matrix()
+{
+  const int mpi_size = dolfinx::MPI::size(MPI_COMM_WORLD);
+  const int mpi_rank = dolfinx::MPI::rank(MPI_COMM_WORLD);
+  constexpr int size_local = 100;
+  const std::int64_t size_global = mpi_size * size_local;
+
+  // Create an IndexMap with the first index of the next process as a
+  // ghost
+  std::vector<std::int64_t> ghosts;
+  std::vector<int> ghost_owner;
+  if (mpi_rank < mpi_size - 1)
+  {
+    ghosts.push_back((mpi_rank + 1) * size_local);
+    ghost_owner.push_back(mpi_rank + 1);
+  }
+  const auto index_map = std::make_shared<common::IndexMap>(
+      MPI_COMM_WORLD, size_local,
+      dolfinx::MPI::compute_graph_edges(
+          MPI_COMM_WORLD, std::set<int>(ghost_owner.begin(), ghost_owner.end())),
+      ghosts, ghost_owner);
+
+  // Assemble 1D Laplacian-type operator on a chain of intervals
+  const std::int32_t num_cells
+      = mpi_rank < mpi_size - 1 ? size_local : size_local - 1;
+  la::SparsityPattern pattern(MPI_COMM_WORLD, {index_map, index_map}, {1, 1});
+  for (std::int32_t c = 0; c < num_cells; ++c)
+  {
+    const std::array<std::int32_t, 2> dofs = {c, c + 1};
+    pattern.insert(dofs, dofs);
+  }
+  pattern.assemble();
+
+  la::MatrixCSR<double> A(pattern);
+  const auto mat_add = la::MatrixCSR<double>::mat_add_values(A);
+  const std::array<double, 4> Ae = {1.0, -1.0, -1.0, 1.0};
+  for (std::int32_t c = 0; c < num_cells; ++c)
+  {
+    const std::array<std::int32_t, 2> dofs = {c, c + 1};
+    mat_add(2, dofs.data(), 2, dofs.data(), Ae.data());
+  }
+  A.finalize();
+
+  const double norm2 = 2.0 + 4.0 * (size_global - 2) + 2.0 * (size_global - 1);
+  CHECK(A.squared_norm() == Approx(norm2));
+
+  // Product with a constant vector is zero
+  la::Vector<double> x(A.index_maps()[1], 1), y(A.index_maps()[0], 1);
+  std::fill(x.mutable_array().begin(), x.mutable_array().end(), 1.0);
+  A.mult(x, y);
+  CHECK(y.norm(la::Norm::linf) == Approx(0.0).margin(1e-12));
+
+  // Product with a linear function is zero on interior rows, and -1
+  // and 1 on the first and last rows
+  std::fill(y.mutable_array().begin(), y.mutable_array().end(), 0.0);
+  const std::int64_t offset = index_map->local_range()[0];
+  for (std::int32_t i = 0; i < size_local; ++i)
+    x.mutable_array()[i] = offset + i;
+  A.mult(x, y);
+  CHECK(y.squared_norm() == Approx(2.0));
+}
+
+} // namespace
+
+TEST_CASE("Linear Algebra MatrixCSR", "[la_matrix]")
+{
+  CHECK_NOTHROW(test_matrix());
+}
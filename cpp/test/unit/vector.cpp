@@ -10,12 +10,14 @@
 #include <dolfinx.h>
 #include <dolfinx/common/IndexMap.h>
 #include <dolfinx/la/Vector.h>
+#include <limits>
 
 using namespace dolfinx;
 
 namespace
 {
 
+template <typename T>
 void test_vector()
 {
   const int mpi_size = dolfinx::MPI::size(MPI_COMM_WORLD);
@@ -39,7 +41,7 @@ void test_vector()
           std::set<int>(global_ghost_owner.begin(), global_ghost_owner.end())),
       ghosts, global_ghost_owner);
 
-  la::Vector<PetscScalar> v(index_map, 1);
+  la::Vector<T> v(index_map, 1);
   std::fill(v.mutable_array().begin(), v.mutable_array().end(), 1.0);
 
   const double norm2 = v.squared_norm();
@@ -49,15 +51,22 @@ void test_vector()
 
   const double sumn2
       = size_local * (mpi_size - 1) * mpi_size * (2 * mpi_size - 1) / 6;
-  CHECK(v.squared_norm() == sumn2);
-  CHECK(v.norm(la::Norm::l2) == std::sqrt(sumn2));
-  CHECK(la::inner_product(v, v) == sumn2);
-  CHECK(v.norm(la::Norm::linf) == static_cast<PetscScalar>(mpi_size - 1));
+
+  // Reductions accumulate round-off in the precision of T
+  using U = decltype(std::real(T()));
+  const double eps
+      = std::numeric_limits<U>::epsilon() * size_local * mpi_size;
+  CHECK(v.squared_norm() == Approx(sumn2).epsilon(eps));
+  CHECK(std::real(v.norm(la::Norm::l2))
+        == Approx(std::sqrt(sumn2)).epsilon(eps));
+  CHECK(std::real(la::inner_product(v, v)) == Approx(sumn2).epsilon(eps));
+  CHECK(v.norm(la::Norm::linf) == static_cast<T>(mpi_size - 1));
 }
 
 } // namespace
 
 TEST_CASE("Linear Algebra Vector", "[la_vector]")
 {
-  CHECK_NOTHROW(test_vector());
+  CHECK_NOTHROW(test_vector<PetscScalar>());
+  CHECK_NOTHROW(test_vector<float>());
 }
@@ -10,11 +10,13 @@ from dolfinx.cpp.fem import IntegralType
 from dolfinx.fem.assemble import (apply_lifting, apply_lifting_nest,
                                   assemble_matrix, assemble_matrix_block,
                                   assemble_matrix_nest, assemble_scalar,
+                                  assemble_scalar_reproducible,
                                   assemble_vector, assemble_vector_block,
                                   assemble_vector_nest, create_matrix,
                                   create_matrix_block, create_matrix_nest,
-                                  create_vector, create_vector_block,
-                                  create_vector_nest, set_bc, set_bc_nest)
+                                  create_matrix_shell, create_vector,
+                                  create_vector_block, create_vector_nest,
+                                  set_bc, set_bc_nest)
 from dolfinx.fem.dirichletbc import (DirichletBC, bcs_by_block, locate_dofs_geometrical,
                                      locate_dofs_topological)
 from dolfinx.fem.dofmap import DofMap
@@ -45,7 +47,9 @@ __all__ = [
     "VectorFunctionSpace",
     "create_vector", "create_vector_block", "create_vector_nest",
     "create_matrix", "create_matrix_block", "create_matrix_nest",
-    "apply_lifting", "apply_lifting_nest", "assemble_scalar", "assemble_vector",
+    "create_matrix_shell",
+    "apply_lifting", "apply_lifting_nest", "assemble_scalar",
+    "assemble_scalar_reproducible", "assemble_vector",
     "assemble_vector_block", "assemble_vector_nest",
     "assemble_matrix_block", "assemble_matrix_nest",
     "assemble_matrix", "set_bc", "set_bc_nest",
@@ -77,6 +77,33 @@ def pack_coefficients(form: form_type):
     return _pack(_create_cpp_form(form))
 
 
+def pack_coefficients_cached(form: form_type):
+    """Compute form coefficients, re-packing only the coefficients that
+    have changed since the last call for the same form. If form is an
+    array of forms, this function returns an array of form coefficients
+    with the same shape as form. The result can be passed to the
+    assembly functions through ``coeffs``.
+
+    Note
+    ----
+    Changes are detected through the version of the coefficient
+    vectors. Values modified through an array that was obtained before
+    the previous call are not detected unless
+    ``dolfinx.cpp.la.Vector.increment_version`` is called. The packed
+    data is retained by the form, so concurrent calls for the same form
+    are not safe.
+
+    """
+    def _pack(form):
+        if form is None:
+            return None
+        elif isinstance(form, (tuple, list)):
+            return list(map(lambda sub_form: _pack(sub_form), form))
+        else:
+            return cpp.fem.pack_coefficients_cached(form)
+    return _pack(_create_cpp_form(form))
+
+
 # -- Vector instantiation ----------------------------------------------------
 
 def create_vector(L: Form) -> PETSc.Vec:
@@ -105,6 +132,17 @@ def create_matrix(a: Form, mat_type=None) -> PETSc.Mat:
         return cpp.fem.create_matrix(_create_cpp_form(a))
 
 
+def create_matrix_shell(a: Form, bcs: typing.List[DirichletBC] = [],
+                        diagonal: float = 1.0) -> PETSc.Mat:
+    """Create a PETSc shell matrix that computes the action of a
+    bilinear form without assembling the matrix. The action is the same
+    as the product with the matrix returned by assemble_matrix(a, bcs,
+    diagonal).
+
+    """
+    return cpp.fem.create_matrix_shell(_create_cpp_form(a), _cpp_dirichletbc(bcs), diagonal)
+
+
 def create_matrix_block(a: typing.List[typing.List[Form]]) -> PETSc.Mat:
     return cpp.fem.create_matrix_block(_create_cpp_form(a))
 
@@ -129,13 +167,28 @@ def assemble_scalar(M: Form, coeffs=Coefficients(None, None)) -> PETSc.ScalarTyp
     return cpp.fem.assemble_scalar(_M, c[0], c[1])
 
 
+def assemble_scalar_reproducible(M: Form, coeffs=Coefficients(None, None)) -> PETSc.ScalarType:
+    """Assemble functional. The returned value is accumulated across
+    processes and is bitwise independent of the number of processes
+    and the mesh partitioning. For interior facet integrals, the '+'
+    restriction is the cell with the smallest (sorted) input indices of
+    its geometry nodes.
+
+    """
+    _M = _create_cpp_form(M)
+    c = (coeffs[0] if coeffs[0] is not None else pack_constants(_M),
+         coeffs[1] if coeffs[1] is not None else pack_coefficients(_M))
+    return cpp.fem.assemble_scalar_reproducible(_M, c[0], c[1])
+
+
 # -- Vector assembly ---------------------------------------------------------
 
 @ functools.singledispatch
-def assemble_vector(L: Form, coeffs=Coefficients(None, None)) -> PETSc.Vec:
+def assemble_vector(L: Form, coeffs=Coefficients(None, None), num_threads: int = 1) -> PETSc.Vec:
     """Assemble linear form into a new PETSc vector. The returned vector
     is not finalised, i.e. ghost values are not accumulated on the
-    owning processes.
+    owning processes. If num_threads is greater than one, cells of the
+    same colour are assembled concurrently.
 
     """
     _L = _create_cpp_form(L)
@@ -145,12 +198,12 @@ def assemble_vector(L: Form, coeffs=Coefficients(None, None)) -> PETSc.Vec:
          coeffs[1] if coeffs[1] is not None else pack_coefficients(_L))
     with b.localForm() as b_local:
         b_local.set(0.0)
-        cpp.fem.assemble_vector(b_local.array_w, _L, c[0], c[1])
+        cpp.fem.assemble_vector(b_local.array_w, _L, c[0], c[1], num_threads)
     return b
 
 
 @ assemble_vector.register(PETSc.Vec)
-def _(b: PETSc.Vec, L: Form, coeffs=Coefficients(None, None)) -> PETSc.Vec:
+def _(b: PETSc.Vec, L: Form, coeffs=Coefficients(None, None), num_threads: int = 1) -> PETSc.Vec:
     """Assemble linear form into an existing PETSc vector. The vector is
     not zeroed before assembly and it is not finalised, i.e. ghost
     values are not accumulated on the owning processes.
@@ -160,7 +213,7 @@ def _(b: PETSc.Vec, L: Form, coeffs=Coefficients(None, None)) -> PETSc.Vec:
     c = (coeffs[0] if coeffs[0] is not None else pack_constants(_L),
          coeffs[1] if coeffs[1] is not None else pack_coefficients(_L))
     with b.localForm() as b_local:
-        cpp.fem.assemble_vector(b_local.array_w, _L, c[0], c[1])
+        cpp.fem.assemble_vector(b_local.array_w, _L, c[0], c[1], num_threads)
     return b
 
 
@@ -275,13 +328,16 @@ def _(b: PETSc.Vec,
 def assemble_matrix(a: Form,
                     bcs: typing.List[DirichletBC] = [],
                     diagonal: float = 1.0,
-                    coeffs=Coefficients(None, None)) -> PETSc.Mat:
+                    coeffs=Coefficients(None, None),
+                    num_threads: int = 1) -> PETSc.Mat:
     """Assemble bilinear form into a matrix. The returned matrix is not
-    finalised, i.e. ghost values are not accumulated.
+    finalised, i.e. ghost values are not accumulated. If num_threads is
+    greater than one, cells of the same colour are assembled
+    concurrently.
 
     """
     A = cpp.fem.create_matrix(_create_cpp_form(a))
-    return assemble_matrix(A, a, bcs, diagonal, coeffs)
+    return assemble_matrix(A, a, bcs, diagonal, coeffs, num_threads)
 
 
 @ assemble_matrix.register(PETSc.Mat)
@@ -289,7 +345,8 @@ def _(A: PETSc.Mat,
       a: Form,
       bcs: typing.List[DirichletBC] = [],
       diagonal: float = 1.0,
-      coeffs=Coefficients(None, None)) -> PETSc.Mat:
+      coeffs=Coefficients(None, None),
+      num_threads: int = 1) -> PETSc.Mat:
     """Assemble bilinear form into a matrix. The returned matrix is not
     finalised, i.e. ghost values are not accumulated.
 
@@ -297,7 +354,8 @@ def _(A: PETSc.Mat,
     _a = _create_cpp_form(a)
     c = (coeffs[0] if coeffs[0] is not None else pack_constants(_a),
          coeffs[1] if coeffs[1] is not None else pack_coefficients(_a))
-    cpp.fem.assemble_matrix_petsc(A, _a, c[0], c[1], _cpp_dirichletbc(bcs))
+    cpp.fem.assemble_matrix_petsc(A, _a, c[0], c[1], _cpp_dirichletbc(bcs),
+                                  num_threads=num_threads)
     if _a.function_spaces[0].id == _a.function_spaces[1].id:
         A.assemblyBegin(PETSc.Mat.AssemblyType.FLUSH)
         A.assemblyEnd(PETSc.Mat.AssemblyType.FLUSH)
@@ -21,7 +21,10 @@ from petsc4py import PETSc
 
 
 def locate_dofs_geometrical(V: typing.Iterable[typing.Union[cpp.fem.FunctionSpace, FunctionSpace]],
-                            marker: types.FunctionType):
+                            marker: types.FunctionType,
+                            entity_dim: typing.Optional[int] = None,
+                            entities: typing.Optional[typing.List[int]] = None,
+                            remote: bool = True):
     """Locate degrees-of-freedom geometrically using a marker function.
 
     Parameters
@@ -35,6 +38,19 @@ def locate_dofs_geometrical(V: typing.Iterable[typing.Union[cpp.fem.FunctionSpac
         ``num_points``, evaluating to ``True`` for entities whose
         degree-of-freedom should be returned.
 
+    entity_dim : optional
+        Topological dimension of ``entities``.
+
+    entities : optional
+        Indices of mesh entities of dimension ``entity_dim``. If given,
+        only the degrees-of-freedom in the closure of these entities are
+        tested with ``marker``, e.g. the exterior facets. Only a single
+        function space is supported.
+
+    remote : True
+        True to return also "remotely located" degree-of-freedom
+        indices. Only used with ``entities``.
+
     Returns
     -------
     numpy.ndarray
@@ -51,6 +67,8 @@ def locate_dofs_geometrical(V: typing.Iterable[typing.Union[cpp.fem.FunctionSpac
     """
 
     if isinstance(V, collections.abc.Sequence):
+        if entities is not None:
+            raise NotImplementedError("Entities are only supported for a single function space.")
         _V = []
         for space in V:
             try:
@@ -63,6 +81,9 @@ def locate_dofs_geometrical(V: typing.Iterable[typing.Union[cpp.fem.FunctionSpac
             _V = V._cpp_object
         except AttributeError:
             _V = V
+        if entities is not None:
+            _entities = np.asarray(entities, dtype=np.int32)
+            return cpp.fem.locate_dofs_geometrical(_V, entity_dim, _entities, marker, remote)
         return cpp.fem.locate_dofs_geometrical(_V, marker)
 
 
@@ -161,7 +182,9 @@ class DirichletBC:
             raise NotImplementedError
 
         def dirichletbc_obj(dtype):
-            if dtype is np.float64:
+            if dtype is np.float32:
+                return cpp.fem.DirichletBC_float32
+            elif dtype is np.float64:
                 return cpp.fem.DirichletBC_float64
             elif dtype is np.complex128:
                 return cpp.fem.DirichletBC_complex128
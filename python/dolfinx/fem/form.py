@@ -47,7 +47,9 @@ class Form:
             raise RuntimeError("Expecting to find a Mesh in the form.")
 
         # Compile UFL form with JIT
-        if dtype == np.float64:
+        if dtype == np.float32:
+            form_compiler_parameters["scalar_type"] = "float"
+        elif dtype == np.float64:
             form_compiler_parameters["scalar_type"] = "double"
         elif dtype == np.complex128:
             form_compiler_parameters["scalar_type"] = "double _Complex"
@@ -77,7 +79,9 @@ class Form:
 
         # Prepare dolfinx.cpp.fem.Form and hold it as a member
         def create_form(dtype):
-            if dtype is np.float64:
+            if dtype is np.float32:
+                return cpp.fem.create_form_float32
+            elif dtype is np.float64:
                 return cpp.fem.create_form_float64
             elif dtype is np.complex128:
                 return cpp.fem.create_form_complex128
@@ -32,6 +32,8 @@ class Constant(ufl.Constant):
         super().__init__(domain, c_np.shape)
         if np.iscomplexobj(c) is True:
             self._cpp_object = cpp.fem.Constant_complex128(c_np)
+        elif c_np.dtype == np.float32:
+            self._cpp_object = cpp.fem.Constant_float32(c_np)
         else:
             self._cpp_object = cpp.fem.Constant_float64(c_np)
 
@@ -88,7 +90,9 @@ class Expression:
         mesh = ufl_expression.ufl_domain().ufl_cargo()
 
         # Compile UFL expression with JIT
-        if dtype == np.float64:
+        if dtype == np.float32:
+            form_compiler_parameters["scalar_type"] = "float"
+        elif dtype == np.float64:
             form_compiler_parameters["scalar_type"] = "double"
         elif dtype == np.complex128:
             form_compiler_parameters["scalar_type"] = "double _Complex"
@@ -114,7 +118,9 @@ class Expression:
 
         # Getcpp Expression type
         def expressiontype(dtype):
-            if dtype is np.float64:
+            if dtype is np.float32:
+                return cpp.fem.Expression_float32
+            elif dtype is np.float64:
                 return cpp.fem.Expression_float64
             elif dtype is np.complex128:
                 return cpp.fem.Expression_complex128
@@ -123,7 +129,8 @@ class Expression:
 
         self._cpp_object = expressiontype(dtype)(coefficients, constants, mesh, x, fn, value_size)
 
-    def eval(self, cells: np.ndarray, u: typing.Optional[np.ndarray] = None) -> np.ndarray:
+    def eval(self, cells: np.ndarray, u: typing.Optional[np.ndarray] = None,
+             num_threads: int = 1) -> np.ndarray:
         """Evaluate Expression in cells.
 
         Parameters
@@ -132,7 +139,12 @@ class Expression:
             local indices of cells to evaluate expression.
         u: optional
             array of shape (num_cells, num_points*value_size) to
-            store result of expression evaluation.
+            store result of expression evaluation. If the rows of u
+            are not contiguous or u has a different scalar type, the
+            result is computed in a contiguous copy and then copied
+            into u.
+        num_threads: optional
+            number of threads used to evaluate the expression.
 
         Returns
         -------
@@ -154,13 +166,18 @@ class Expression:
                 u = np.empty((num_cells, self.num_points * self.value_size), dtype=np.complex128)
             else:
                 u = np.empty((num_cells, self.num_points * self.value_size), dtype=np.float64)
-            self._cpp_object.eval(cells, u)
+            self._cpp_object.eval(cells, u, num_threads)
         else:
             assert u.ndim < 3
             assert u.size == num_cells * self.num_points * self.value_size
             assert u.shape[0] == num_cells
             assert u.shape[1] == self.num_points * self.value_size
-            self._cpp_object.eval(cells, u)
+            if u.dtype != PETSc.ScalarType or u.strides[0] < 0 or (u.shape[1] > 1 and u.strides[1] != u.itemsize):
+                _u = np.ascontiguousarray(u, dtype=PETSc.ScalarType)
+                self._cpp_object.eval(cells, _u, num_threads)
+                u[:] = _u
+            else:
+                self._cpp_object.eval(cells, u, num_threads)
 
         return u
 
@@ -211,7 +228,9 @@ class Function(ufl.Coefficient):
 
         # Create cpp Function
         def functiontype(dtype):
-            if dtype is np.float64:
+            if dtype is np.float32:
+                return cpp.fem.Function_float32
+            elif dtype is np.float64:
                 return cpp.fem.Function_float64
             elif dtype is np.complex128:
                 return cpp.fem.Function_complex128
@@ -260,11 +279,12 @@ class Function(ufl.Coefficient):
             # Scalar evaluation
             return self(*x)
 
-    def eval(self, x: np.ndarray, cells: np.ndarray, u=None) -> np.ndarray:
+    def eval(self, x: np.ndarray, cells: np.ndarray, u=None, num_threads: int = 1) -> np.ndarray:
         """Evaluate Function at points x, where x has shape (num_points, 3),
         and cells has shape (num_points,) and cell[i] is the index of the
         cell containing point x[i]. If the cell index is negative the
-        point is ignored."""
+        point is ignored. If num_threads is greater than one, blocks of
+        cells are evaluated concurrently."""
 
         # Make sure input coordinates are a NumPy array
         x = np.asarray(x, dtype=np.float64)
@@ -288,17 +308,32 @@ class Function(ufl.Coefficient):
             else:
                 u = np.empty((num_points, value_size))
 
-        self._cpp_object.eval(x, cells, u)
+        self._cpp_object.eval(x, cells, u, num_threads)
         if num_points == 1:
             u = np.reshape(u, (-1, ))
         return u
 
-    def interpolate(self, u) -> None:
-        """Interpolate an expression"""
+    def interpolate(self, u, data=None) -> None:
+        """Interpolate an expression
+
+        Parameters
+        ----------
+        u
+            The expression or Function to interpolate
+        data: optional
+            ``cpp.fem.NonmatchingInterpolationData`` for the space of
+            this Function and the mesh of ``u``, when ``u`` is a
+            Function on a different mesh. Re-use it for repeated
+            interpolation between the same meshes.
+
+        """
         @singledispatch
         def _interpolate(u):
             try:
-                self._cpp_object.interpolate(u._cpp_object)
+                if data is None:
+                    self._cpp_object.interpolate(u._cpp_object)
+                else:
+                    self._cpp_object.interpolate(u._cpp_object, data)
             except AttributeError:
                 self._cpp_object.interpolate(u)
 
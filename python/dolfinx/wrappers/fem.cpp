@@ -20,6 +20,8 @@
 #include <dolfinx/fem/Form.h>
 #include <dolfinx/fem/Function.h>
 #include <dolfinx/fem/FunctionSpace.h>
+#include <dolfinx/fem/QuadratureData.h>
+#include <dolfinx/fem/SparsityPatternCache.h>
 #include <dolfinx/fem/assembler.h>
 #include <dolfinx/fem/discreteoperators.h>
 #include <dolfinx/fem/dofmapbuilder.h>
@@ -73,6 +75,23 @@ void declare_functions(py::module& m)
         return as_pyarray(std::move(coeffs), std::array{num_cells, cstride});
       },
       "Pack coefficients for a Form.");
+  m.def(
+      "pack_coefficients_cached",
+      [](dolfinx::fem::Form<T>& form)
+      {
+        auto [coeffs, cstride] = dolfinx::fem::pack_coefficients_cached(form);
+        std::shared_ptr<const mesh::Mesh> mesh = form.mesh();
+        assert(mesh);
+        const int tdim = mesh->topology().dim();
+        const std::int32_t num_cells
+            = mesh->topology().index_map(tdim)->size_local()
+              + mesh->topology().index_map(tdim)->num_ghosts();
+        return as_pyarray(std::vector<T>(coeffs.begin(), coeffs.end()),
+                          std::array{num_cells, cstride});
+      },
+      "Pack coefficients for a Form, re-packing only the coefficients "
+      "that have been modified since the last call. A copy of the packed "
+      "data retained by the Form is returned.");
   m.def(
       "pack_coefficients",
       [](dolfinx::fem::Expression<T>& e)
@@ -112,22 +131,51 @@ void declare_functions(py::module& m)
       },
       "Assemble functional over mesh with provided constants and "
       "coefficients");
+  m.def(
+      "assemble_scalar_reproducible",
+      [](const dolfinx::fem::Form<T>& M,
+         const py::array_t<T, py::array::c_style>& constants,
+         const py::array_t<T, py::array::c_style>& coeffs)
+      {
+        return dolfinx::fem::assemble_scalar_reproducible<T>(
+            M, constants,
+            {xtl::span<const T>(coeffs.data(), coeffs.size()),
+             coeffs.shape(1)});
+      },
+      "Assemble functional over mesh with provided constants and "
+      "coefficients, accumulated across processes with a result that is "
+      "independent of the parallel partitioning");
   // Vector
   m.def(
       "assemble_vector",
       [](py::array_t<T, py::array::c_style> b, const dolfinx::fem::Form<T>& L,
          const py::array_t<T, py::array::c_style>& constants,
-         const py::array_t<T, py::array::c_style>& coeffs)
+         const py::array_t<T, py::array::c_style>& coeffs, int num_threads)
       {
         dolfinx::fem::assemble_vector<T>(
             xtl::span(b.mutable_data(), b.size()), L, constants,
             {xtl::span<const T>(coeffs.data(), coeffs.size()),
-             coeffs.shape(1)});
+             coeffs.shape(1)},
+            num_threads);
       },
       py::arg("b"), py::arg("L"), py::arg("constants"), py::arg("coeffs"),
+      py::arg("num_threads") = 1,
       "Assemble linear form into an existing vector with pre-packed "
       "constants "
       "and coefficients");
+  m.def(
+      "assemble_vector_begin",
+      [](dolfinx::la::Vector<T>& b, const dolfinx::fem::Form<T>& L,
+         const std::vector<std::shared_ptr<dolfinx::la::Vector<T>>>&
+             coefficients)
+      { dolfinx::fem::assemble_vector_begin<T>(b, L, coefficients); },
+      py::arg("b"), py::arg("L"), py::arg("coefficients"),
+      "Start the assembly of a linear form into a distributed vector, "
+      "overlapping the ghost updates of the coefficients with computation");
+  m.def("assemble_vector_end", &dolfinx::fem::assemble_vector_end<T>,
+        py::arg("b"),
+        "Complete the assembly of a linear form into a distributed vector "
+        "started by assemble_vector_begin");
   m.def(
       "assemble_matrix",
       [](const std::function<int(const py::array_t<std::int32_t>&,
@@ -293,6 +341,14 @@ void declare_objects(py::module& m, const std::string& type)
            py::overload_cast<const dolfinx::fem::Function<T>&>(
                &dolfinx::fem::Function<T>::interpolate),
            py::arg("u"), "Interpolate a finite element function")
+      .def(
+          "interpolate",
+          [](dolfinx::fem::Function<T>& self,
+             const dolfinx::fem::Function<T>& u,
+             const dolfinx::fem::NonmatchingInterpolationData& data)
+          { dolfinx::fem::interpolate(self, u, data); },
+          py::arg("u"), py::arg("data"),
+          "Interpolate a finite element function on a non-matching mesh")
       .def(
           "interpolate_ptr",
           [](dolfinx::fem::Function<T>& self, std::uintptr_t addr)
@@ -331,12 +387,14 @@ void declare_objects(py::module& m, const std::string& type)
       .def_property_readonly(
           "x", py::overload_cast<>(&dolfinx::fem::Function<T>::x),
           "Return the vector associated with the finite element Function")
+      .def_property_readonly("version", &dolfinx::fem::Function<T>::version,
+                             "Modification counter of the Function values")
       .def(
           "eval",
           [](const dolfinx::fem::Function<T>& self,
              const py::array_t<double, py::array::c_style>& x,
              const py::array_t<std::int32_t, py::array::c_style>& cells,
-             py::array_t<T, py::array::c_style>& u)
+             py::array_t<T, py::array::c_style>& u, int num_threads)
           {
             // TODO: handle 1d case
 
@@ -355,11 +413,12 @@ void declare_objects(py::module& m, const std::string& type)
             xt::xtensor<T, 2> _u(shape_u);
             std::copy_n(u.data(), u.size(), _u.data());
 
-            self.eval(_x, xtl::span(cells.data(), cells.size()), _u);
+            self.eval(_x, xtl::span(cells.data(), cells.size()), _u,
+                      num_threads);
             std::copy_n(_u.data(), _u.size(), u.mutable_data());
           },
           py::arg("x"), py::arg("cells"), py::arg("values"),
-          "Evaluate Function")
+          py::arg("num_threads") = 1, "Evaluate Function")
       .def(
           "compute_point_values",
           [](const dolfinx::fem::Function<T>& self)
@@ -368,6 +427,25 @@ void declare_objects(py::module& m, const std::string& type)
       .def_property_readonly("function_space",
                              &dolfinx::fem::Function<T>::function_space);
 
+  // dolfinx::fem::QuadratureData
+  std::string pyclass_name_qdata = std::string("QuadratureData_") + type;
+  py::class_<dolfinx::fem::QuadratureData<T>,
+             std::shared_ptr<dolfinx::fem::QuadratureData<T>>>(
+      m, pyclass_name_qdata.c_str(), "Values at quadrature points of cells")
+      .def(py::init<std::shared_ptr<const dolfinx::mesh::Mesh>, int, int>(),
+           py::arg("mesh"), py::arg("num_points"), py::arg("value_size"))
+      .def_property_readonly("mesh", &dolfinx::fem::QuadratureData<T>::mesh)
+      .def_property_readonly("num_points",
+                             &dolfinx::fem::QuadratureData<T>::num_points)
+      .def_property_readonly("value_size",
+                             &dolfinx::fem::QuadratureData<T>::value_size)
+      .def_property_readonly(
+          "x", py::overload_cast<>(&dolfinx::fem::QuadratureData<T>::x),
+          "Return the vector holding the values")
+      .def_property_readonly("version",
+                             &dolfinx::fem::QuadratureData<T>::version)
+      .def("scatter_forward", &dolfinx::fem::QuadratureData<T>::scatter_fwd);
+
   // dolfinx::fem::Constant
   std::string pyclass_name_constant = std::string("Constant_") + type;
   py::class_<dolfinx::fem::Constant<T>,
@@ -415,24 +493,55 @@ void declare_objects(py::module& m, const std::string& type)
                }),
            py::arg("coefficients"), py::arg("constants"), py::arg("mesh"),
            py::arg("x"), py::arg("fn"), py::arg("value_size"))
-      .def("eval",
-           [](const dolfinx::fem::Expression<T>& self,
-              const py::array_t<std::int32_t, py::array::c_style>& active_cells,
-              py::array_t<T> values)
-           {
-             xt::xtensor<T, 2> _values(
-                 {std::size_t(active_cells.shape(0)),
-                  std::size_t(self.num_points() * self.value_size())});
-             self.eval(xtl::span(active_cells.data(), active_cells.size()),
-                       _values);
-             assert(values.ndim() == 2);
-             assert(values.shape(0) == (py::ssize_t)_values.shape(0));
-             assert(values.shape(1) == (py::ssize_t)_values.shape(1));
-             auto v = values.mutable_unchecked();
-             for (py::ssize_t i = 0; i < v.shape(0); i++)
-               for (py::ssize_t j = 0; j < v.shape(1); j++)
-                 v(i, j) = _values(i, j);
-           })
+      .def(
+          "eval",
+          [](const dolfinx::fem::Expression<T>& self,
+             const py::array_t<std::int32_t, py::array::c_style>& active_cells,
+             py::array_t<T> values, int num_threads)
+          {
+            // Rows may be strided, but the entries of a row must be
+            // contiguous
+            if (values.ndim() != 2
+                or values.shape(0) != active_cells.shape(0)
+                or values.shape(1)
+                       != (py::ssize_t)(self.num_points() * self.value_size())
+                or (values.shape(1) > 1 and values.strides(1) != sizeof(T))
+                or values.strides(0) % sizeof(T) != 0)
+            {
+              throw std::runtime_error("Array for Expression values has the "
+                                       "wrong shape or layout.");
+            }
+            const std::size_t stride = values.strides(0) / sizeof(T);
+            const std::size_t size
+                = values.shape(0) > 0
+                      ? (values.shape(0) - 1) * stride + values.shape(1)
+                      : 0;
+            self.eval(xtl::span(active_cells.data(), active_cells.size()),
+                      xtl::span<T>(values.mutable_data(), size), stride,
+                      num_threads);
+          },
+          py::arg("active_cells"), py::arg("values"),
+          py::arg("num_threads") = 1)
+      .def(
+          "eval",
+          [](const dolfinx::fem::Expression<T>& self,
+             const py::array_t<std::int32_t, py::array::c_style>& active_cells,
+             dolfinx::fem::Function<T>& u, int num_threads)
+          {
+            self.eval(xtl::span(active_cells.data(), active_cells.size()), u,
+                      num_threads);
+          },
+          py::arg("active_cells"), py::arg("u"), py::arg("num_threads") = 1)
+      .def(
+          "eval",
+          [](const dolfinx::fem::Expression<T>& self,
+             const py::array_t<std::int32_t, py::array::c_style>& active_cells,
+             dolfinx::fem::QuadratureData<T>& data, int num_threads)
+          {
+            self.eval(xtl::span(active_cells.data(), active_cells.size()),
+                      data, num_threads);
+          },
+          py::arg("active_cells"), py::arg("data"), py::arg("num_threads") = 1)
       .def_property_readonly("mesh", &dolfinx::fem::Expression<T>::mesh,
                              py::return_value_policy::reference_internal)
       .def_property_readonly("num_points",
@@ -502,6 +611,22 @@ void declare_form(py::module& m, const std::string& type)
           py::arg("mesh") = py::none())
       .def_property_readonly("coefficients",
                              &dolfinx::fem::Form<T>::coefficients)
+      .def("set_quadrature_data", &dolfinx::fem::Form<T>::set_quadrature_data,
+           py::arg("i"), py::arg("data"))
+      .def(
+          "set_batch_kernel",
+          [](dolfinx::fem::Form<T>& self, dolfinx::fem::IntegralType type,
+             int i, int batch_size, std::uintptr_t kernel)
+          {
+            auto tabulate_tensor_ptr
+                = (void (*)(T*, const T*, const T*, const double*, const int*,
+                            const std::uint8_t*))kernel;
+            self.set_batch_kernel(type, i, batch_size, tabulate_tensor_ptr);
+          },
+          py::arg("type"), py::arg("i"), py::arg("batch_size"),
+          py::arg("kernel"))
+      .def("batch_size", &dolfinx::fem::Form<T>::batch_size, py::arg("type"),
+           py::arg("i"))
       .def_property_readonly("rank", &dolfinx::fem::Form<T>::rank)
       .def_property_readonly("mesh", &dolfinx::fem::Form<T>::mesh)
       .def_property_readonly("function_spaces",
@@ -612,6 +737,36 @@ void fem(py::module& m)
         py::return_value_policy::take_ownership, py::arg("a"),
         py::arg("type") = std::string(),
         "Create a PETSc Mat for bilinear form.");
+  m.def("create_matrix_shell", &dolfinx::fem::create_matrix_shell,
+        py::return_value_policy::take_ownership, py::arg("a"),
+        py::arg("bcs") = std::vector<
+            std::shared_ptr<const dolfinx::fem::DirichletBC<PetscScalar>>>(),
+        py::arg("diagonal") = 1.0,
+        "Create a PETSc shell Mat that computes the action of a bilinear "
+        "form without assembling it.");
+
+  // dolfinx::fem::SparsityPatternCache
+  py::class_<dolfinx::fem::SparsityPatternCache,
+             std::shared_ptr<dolfinx::fem::SparsityPatternCache>>(
+      m, "SparsityPatternCache", "Cache of sparsity patterns")
+      .def(py::init<>())
+      .def("create_matrix", &dolfinx::fem::SparsityPatternCache::create_matrix,
+           py::return_value_policy::take_ownership, py::arg("a"),
+           py::arg("type") = std::string(),
+           "Create a PETSc Mat for a bilinear form using a cached sparsity "
+           "pattern.")
+      .def("clear", &dolfinx::fem::SparsityPatternCache::clear)
+      .def("__len__", &dolfinx::fem::SparsityPatternCache::size);
+
+  // dolfinx::fem::ElementTensorCache
+  py::class_<dolfinx::fem::ElementTensorCache<PetscScalar>,
+             std::shared_ptr<dolfinx::fem::ElementTensorCache<PetscScalar>>>(
+      m, "ElementTensorCache",
+      "Element tensors stored for incremental re-assembly")
+      .def(py::init<>())
+      .def("clear", &dolfinx::fem::ElementTensorCache<PetscScalar>::clear)
+      .def("__len__", &dolfinx::fem::ElementTensorCache<PetscScalar>::size);
+
   m.def("create_matrix_block", &dolfinx::fem::create_matrix_block,
         py::return_value_policy::take_ownership, py::arg("a"),
         py::arg("type") = std::string(),
@@ -812,10 +967,13 @@ void fem(py::module& m)
   // dolfinx::fem::assemble
   declare_functions<double>(m);
   declare_functions<std::complex<double>>(m);
+  declare_functions<float>(m);
   declare_objects<double>(m, "float64");
   declare_objects<std::complex<double>>(m, "complex128");
+  declare_objects<float>(m, "float32");
   declare_form<double>(m, "float64");
   declare_form<std::complex<double>>(m, "complex128");
+  declare_form<float>(m, "float32");
 
   // PETSc Matrices
   m.def(
@@ -825,7 +983,7 @@ void fem(py::module& m)
          const py::array_t<PetscScalar, py::array::c_style>& coeffs,
          const std::vector<std::shared_ptr<
              const dolfinx::fem::DirichletBC<PetscScalar>>>& bcs,
-         bool unrolled)
+         bool unrolled, int num_threads)
       {
         std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
                           const std::int32_t*, const PetscScalar*)>
@@ -843,10 +1001,10 @@ void fem(py::module& m)
             set_fn, a, xtl::span(constants),
             {xtl::span<const PetscScalar>(coeffs.data(), coeffs.size()),
              coeffs.shape(1)},
-            bcs);
+            bcs, num_threads);
       },
       py::arg("A"), py::arg("a"), py::arg("constants"), py::arg("coeffs"),
-      py::arg("bcs"), py::arg("unrolled") = false,
+      py::arg("bcs"), py::arg("unrolled") = false, py::arg("num_threads") = 1,
       "Assemble bilinear form into an existing PETSc matrix");
   m.def(
       "assemble_matrix_petsc",
@@ -854,7 +1012,7 @@ void fem(py::module& m)
          const py::array_t<PetscScalar, py::array::c_style>& constants,
          const py::array_t<PetscScalar, py::array::c_style>& coeffs,
          const std::vector<bool>& rows0, const std::vector<bool>& rows1,
-         bool unrolled)
+         bool unrolled, int num_threads)
       {
         std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
                           const std::int32_t*, const PetscScalar*)>
@@ -872,10 +1030,57 @@ void fem(py::module& m)
             set_fn, a, xtl::span(constants),
             {xtl::span<const PetscScalar>(coeffs.data(), coeffs.size()),
              coeffs.shape(1)},
-            rows0, rows1);
+            rows0, rows1, num_threads);
       },
       py::arg("A"), py::arg("a"), py::arg("constants"), py::arg("coeffs"),
-      py::arg("rows0"), py::arg("rows1"), py::arg("unrolled") = false);
+      py::arg("rows0"), py::arg("rows1"), py::arg("unrolled") = false,
+      py::arg("num_threads") = 1);
+  m.def(
+      "assemble_system_petsc",
+      [](Mat A, py::array_t<PetscScalar, py::array::c_style> b,
+         const dolfinx::fem::Form<PetscScalar>& a,
+         const dolfinx::fem::Form<PetscScalar>& L,
+         const std::vector<std::shared_ptr<
+             const dolfinx::fem::DirichletBC<PetscScalar>>>& bcs)
+      {
+        dolfinx::fem::assemble_system(
+            dolfinx::la::PETScMatrix::set_block_fn(A, ADD_VALUES),
+            xtl::span(b.mutable_data(), b.size()), a, L, bcs);
+      },
+      py::arg("A"), py::arg("b"), py::arg("a"), py::arg("L"), py::arg("bcs"),
+      "Assemble a bilinear form into an existing PETSc matrix and a "
+      "linear form into an existing vector in a single pass over the "
+      "cells");
+  m.def(
+      "reassemble_matrix_petsc",
+      [](Mat A, const dolfinx::fem::Form<PetscScalar>& a,
+         const py::array_t<std::int32_t, py::array::c_style>& cells,
+         dolfinx::fem::ElementTensorCache<PetscScalar>& cache,
+         const std::vector<std::shared_ptr<
+             const dolfinx::fem::DirichletBC<PetscScalar>>>& bcs)
+      {
+        dolfinx::fem::reassemble_matrix(
+            dolfinx::la::PETScMatrix::set_block_fn(A, ADD_VALUES), a,
+            xtl::span(cells.data(), cells.size()), cache, bcs);
+      },
+      py::arg("A"), py::arg("a"), py::arg("cells"), py::arg("cache"),
+      py::arg("bcs"),
+      "Incrementally re-assemble a bilinear form into an existing PETSc "
+      "matrix on a subset of cells");
+  m.def(
+      "reassemble_vector",
+      [](py::array_t<PetscScalar, py::array::c_style> b,
+         const dolfinx::fem::Form<PetscScalar>& L,
+         const py::array_t<std::int32_t, py::array::c_style>& cells,
+         dolfinx::fem::ElementTensorCache<PetscScalar>& cache)
+      {
+        dolfinx::fem::reassemble_vector(
+            xtl::span(b.mutable_data(), b.size()), L,
+            xtl::span(cells.data(), cells.size()), cache);
+      },
+      py::arg("b"), py::arg("L"), py::arg("cells"), py::arg("cache"),
+      "Incrementally re-assemble a linear form into an existing vector "
+      "on a subset of cells");
   m.def("insert_diagonal",
         [](Mat A, const dolfinx::fem::FunctionSpace& V,
            const std::vector<std::shared_ptr<
@@ -985,6 +1190,31 @@ void fem(py::module& m)
         return as_pyarray(dolfinx::fem::locate_dofs_geometrical(V, _marker));
       },
       py::arg("V"), py::arg("marker"));
+  m.def(
+      "locate_dofs_geometrical",
+      [](const dolfinx::fem::FunctionSpace& V, int dim,
+         const py::array_t<std::int32_t, py::array::c_style>& entities,
+         const std::function<py::array_t<bool>(const py::array_t<double>&)>&
+             marker,
+         bool remote)
+      {
+        auto _marker
+            = [&marker](const xt::xtensor<double, 2>& x) -> xt::xtensor<bool, 1>
+        {
+          auto strides = x.strides();
+          std::transform(strides.begin(), strides.end(), strides.begin(),
+                         [](auto s) { return s * sizeof(double); });
+          py::array_t _x(x.shape(), strides, x.data(), py::none());
+          py::array_t m = marker(_x);
+          std::vector<std::size_t> s(m.shape(), m.shape() + m.ndim());
+          return xt::adapt(m.data(), m.size(), xt::no_ownership(), s);
+        };
+        return as_pyarray(dolfinx::fem::locate_dofs_geometrical(
+            V, dim, xtl::span(entities.data(), entities.size()), _marker,
+            remote));
+      },
+      py::arg("V"), py::arg("dim"), py::arg("entities"), py::arg("marker"),
+      py::arg("remote") = true);
 
   // dolfinx::fem::FunctionSpace
   py::class_<dolfinx::fem::FunctionSpace,
@@ -1005,5 +1235,14 @@ void fem(py::module& m)
       .def("tabulate_dof_coordinates",
            [](const dolfinx::fem::FunctionSpace& self)
            { return xt_as_pyarray(self.tabulate_dof_coordinates(false)); });
+
+  // dolfinx::fem::NonmatchingInterpolationData
+  py::class_<dolfinx::fem::NonmatchingInterpolationData,
+             std::shared_ptr<dolfinx::fem::NonmatchingInterpolationData>>(
+      m, "NonmatchingInterpolationData",
+      "Data for interpolation between non-matching meshes")
+      .def(py::init<const dolfinx::fem::FunctionSpace&,
+                    const dolfinx::mesh::Mesh&, double>(),
+           py::arg("V"), py::arg("mesh"), py::arg("padding") = 1.0e-8);
 }
 } // namespace dolfinx_wrappers
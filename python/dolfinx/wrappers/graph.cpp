@@ -54,14 +54,29 @@ void declare_adjacency_list(py::module& m, std::string type)
                                                      self.array().data(),
                                                      py::cast(self));
                              })
-      .def_property_readonly("offsets",
-                             [](const dolfinx::graph::AdjacencyList<T>& self) {
-                               return py::array_t<std::int32_t>(
-                                   self.offsets().size(), self.offsets().data(),
-                                   py::cast(self));
-                             })
+      .def_property_readonly(
+          "offsets",
+          [](const dolfinx::graph::AdjacencyList<T>& self) {
+            // The offsets of a constant degree list are returned in a
+            // new array, so they are not created and kept in the list
+            if (const int degree = self.degree(); degree > 0)
+            {
+              py::array_t<std::int32_t> offsets(self.num_nodes() + 1);
+              auto o = offsets.mutable_unchecked<1>();
+              for (py::ssize_t i = 0; i < o.shape(0); ++i)
+                o(i) = i * degree;
+              return offsets;
+            }
+            return py::array_t<std::int32_t>(self.offsets().size(),
+                                             self.offsets().data(),
+                                             py::cast(self));
+          },
+          "Offsets of the links of each node in array. For a constant "
+          "degree list this is a new array, otherwise a view.")
       .def_property_readonly("num_nodes",
                              &dolfinx::graph::AdjacencyList<T>::num_nodes)
+      .def_property_readonly("degree",
+                             &dolfinx::graph::AdjacencyList<T>::degree)
       .def("__eq__", &dolfinx::graph::AdjacencyList<T>::operator==,
            py::is_operator())
       .def("__repr__", &dolfinx::graph::AdjacencyList<T>::str)
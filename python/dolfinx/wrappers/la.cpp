@@ -35,13 +35,22 @@ void declare_objects(py::module& m, const std::string& type)
   std::string pyclass_vector_name = std::string("Vector_") + type;
   py::class_<dolfinx::la::Vector<T>, std::shared_ptr<dolfinx::la::Vector<T>>>(
       m, pyclass_vector_name.c_str())
-      .def_property_readonly("array",
-                             [](dolfinx::la::Vector<T>& self)
-                             {
-                               xtl::span<T> array = self.mutable_array();
-                               return py::array_t<T>(array.size(), array.data(),
-                                                py::cast(self));
-                             })
+      .def_property_readonly(
+          "array",
+          [](dolfinx::la::Vector<T>& self)
+          {
+            xtl::span<T> array = self.mutable_array();
+            return py::array_t<T>(array.size(), array.data(), py::cast(self));
+          },
+          "Return the local part of the vector. This increments the "
+          "version. If the returned array is modified after it has been "
+          "used in assembly, call increment_version() after the "
+          "modification.")
+      .def_property_readonly("version", &dolfinx::la::Vector<T>::version,
+                             "Modification counter of the vector")
+      .def("increment_version", &dolfinx::la::Vector<T>::increment_version,
+           "Increment the modification counter after modifying a "
+           "previously obtained array")
       .def("scatter_forward", &dolfinx::la::Vector<T>::scatter_fwd)
       .def("scatter_reverse", &dolfinx::la::Vector<T>::scatter_rev);
 }
@@ -127,6 +136,7 @@ void la(py::module& m)
   // Declare objects that are templated over type
   declare_objects<double>(m, "float64");
   declare_objects<std::complex<double>>(m, "complex128");
+  declare_objects<float>(m, "float32");
 
   m.def("create_vector",
         py::overload_cast<const dolfinx::common::IndexMap&, int>(
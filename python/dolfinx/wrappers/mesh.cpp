@@ -216,23 +216,45 @@ void mesh(py::module& m)
       .def("index_map", &dolfinx::mesh::Geometry::index_map)
       .def_property_readonly(
           "x",
-          [](const dolfinx::mesh::Geometry& self)
+          [](dolfinx::mesh::Geometry& self)
           {
-            const xt::xtensor<double, 2>& x = self.x();
+            // Returned array is writable, so use the non-const accessor,
+            // which invalidates the cell geometry cache
+            xt::xtensor<double, 2>& x = self.x();
             return py::array_t<double>(x.shape(), x.data(), py::cast(self));
           },
           "Return coordinates of all geometry points. Each row is the "
-          "coordinate of a point.")
+          "coordinate of a point. If the cell geometry cache is enabled "
+          "and a returned array is modified after the cache has been "
+          "used, call invalidate_cell_cache() after the modification.")
       .def_property_readonly("cmap", &dolfinx::mesh::Geometry::cmap,
                              "The coordinate map")
       .def_property_readonly("input_global_indices",
-                             &dolfinx::mesh::Geometry::input_global_indices);
+                             &dolfinx::mesh::Geometry::input_global_indices)
+      .def("cache_cell_geometry",
+           &dolfinx::mesh::Geometry::cache_cell_geometry, py::arg("enable"),
+           "Enable or disable the contiguous per-cell geometry cache")
+      .def_property_readonly("cell_geometry_cached",
+                             &dolfinx::mesh::Geometry::cell_geometry_cached)
+      .def("invalidate_cell_cache",
+           &dolfinx::mesh::Geometry::invalidate_cell_cache,
+           "Mark the cell geometry cache as out-of-date. Must be called "
+           "after modifying a previously obtained view of x.");
 
   // dolfinx::mesh::TopologyComputation
-  m.def("compute_entities", [](const MPICommWrapper comm,
-                               const dolfinx::mesh::Topology& topology, int dim)
-        { return dolfinx::mesh::compute_entities(comm.get(), topology, dim); });
-  m.def("compute_connectivity", &dolfinx::mesh::compute_connectivity);
+  m.def(
+      "compute_entities",
+      [](const MPICommWrapper comm, const dolfinx::mesh::Topology& topology,
+         int dim, int num_threads)
+      {
+        return dolfinx::mesh::compute_entities(comm.get(), topology, dim,
+                                               num_threads);
+      },
+      py::arg("comm"), py::arg("topology"), py::arg("dim"),
+      py::arg("num_threads") = 1);
+  m.def("compute_connectivity", &dolfinx::mesh::compute_connectivity,
+        py::arg("topology"), py::arg("d0"), py::arg("d1"),
+        py::arg("num_threads") = 1);
 
   // dolfinx::mesh::Topology class
   py::class_<dolfinx::mesh::Topology, std::shared_ptr<dolfinx::mesh::Topology>>(
@@ -242,10 +264,13 @@ void mesh(py::module& m)
           { return dolfinx::mesh::Topology(comm.get(), cell_type); }))
       .def("set_connectivity", &dolfinx::mesh::Topology::set_connectivity)
       .def("set_index_map", &dolfinx::mesh::Topology::set_index_map)
-      .def("create_entities", &dolfinx::mesh::Topology::create_entities)
+      .def("create_entities", &dolfinx::mesh::Topology::create_entities,
+           py::arg("dim"), py::arg("num_threads") = 1)
       .def("create_entity_permutations",
            &dolfinx::mesh::Topology::create_entity_permutations)
-      .def("create_connectivity", &dolfinx::mesh::Topology::create_connectivity)
+      .def("create_connectivity",
+           &dolfinx::mesh::Topology::create_connectivity, py::arg("d0"),
+           py::arg("d1"), py::arg("num_threads") = 1)
       .def("get_facet_permutations",
            [](const dolfinx::mesh::Topology& self)
            {
@@ -266,6 +291,15 @@ void mesh(py::module& m)
       .def("connectivity",
            py::overload_cast<int, int>(&dolfinx::mesh::Topology::connectivity,
                                        py::const_))
+      .def("release_connectivity",
+           &dolfinx::mesh::Topology::release_connectivity, py::arg("d0"),
+           py::arg("d1"))
+      .def("connectivity_memory",
+           &dolfinx::mesh::Topology::connectivity_memory, py::arg("d0"),
+           py::arg("d1"))
+      .def_property("connectivity_memory_budget",
+                    &dolfinx::mesh::Topology::connectivity_memory_budget,
+                    &dolfinx::mesh::Topology::set_connectivity_memory_budget)
       .def("index_map", &dolfinx::mesh::Topology::index_map)
       .def_property_readonly("cell_type", &dolfinx::mesh::Topology::cell_type)
       .def("cell_name", [](const dolfinx::mesh::Topology& self)
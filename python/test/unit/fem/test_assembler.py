@@ -793,3 +793,528 @@ def test_pack_coefficients():
         A = fem.assemble_matrix(J, coeffs=c)
         A.assemble()
         assert (A - A0).norm() > 1.0e-5
+
+
+@pytest.mark.parametrize("num_threads", [2, 3])
+def test_threaded_assembly(num_threads):
+    """Check that threaded assembly over cells and facets gives the same
+    matrix and vector as serial assembly"""
+    mesh = UnitSquareMesh(MPI.COMM_WORLD, 12, 9, ghost_mode=dolfinx.cpp.mesh.GhostMode.shared_facet)
+    V = fem.FunctionSpace(mesh, ("Lagrange", 2))
+    u, v = ufl.TrialFunction(V), ufl.TestFunction(V)
+    f = fem.Function(V)
+    f.interpolate(lambda x: 1.0 + x[0] * x[1])
+    a = inner(f * ufl.grad(u), ufl.grad(v)) * dx + inner(u, v) * ds + inner(ufl.avg(u), ufl.avg(v)) * ufl.dS
+    L = inner(f, v) * dx + inner(f, v) * ds + inner(ufl.avg(f), ufl.avg(v)) * ufl.dS
+
+    bdofs = fem.locate_dofs_geometrical(V, lambda x: numpy.isclose(x[0], 0.0))
+    u_bc = fem.Function(V)
+    bc = fem.DirichletBC(u_bc, bdofs)
+
+    A0 = fem.assemble_matrix(a, [bc])
+    A0.assemble()
+    A1 = fem.assemble_matrix(a, [bc], num_threads=num_threads)
+    A1.assemble()
+    assert (A1 - A0).norm() == pytest.approx(0.0, abs=1.0e-12 * A0.norm())
+
+    b0 = fem.assemble_vector(L)
+    b0.ghostUpdate(addv=PETSc.InsertMode.ADD, mode=PETSc.ScatterMode.REVERSE)
+    b1 = fem.assemble_vector(L, num_threads=num_threads)
+    b1.ghostUpdate(addv=PETSc.InsertMode.ADD, mode=PETSc.ScatterMode.REVERSE)
+    assert (b1 - b0).norm() == pytest.approx(0.0, abs=1.0e-12 * b0.norm())
+
+
+@pytest.mark.parametrize("mode", [dolfinx.cpp.mesh.GhostMode.none, dolfinx.cpp.mesh.GhostMode.shared_facet])
+def test_matrix_shell(mode):
+    """Check that the action computed by a shell matrix is the same as
+    the product with the assembled matrix"""
+    mesh = UnitSquareMesh(MPI.COMM_WORLD, 9, 7, ghost_mode=mode)
+    V = fem.FunctionSpace(mesh, ("Lagrange", 2))
+    u, v = ufl.TrialFunction(V), ufl.TestFunction(V)
+    f = fem.Function(V)
+    f.interpolate(lambda x: 2.0 + x[0])
+    a = inner(f * ufl.grad(u), ufl.grad(v)) * dx + inner(u, v) * ds
+
+    bdofs = fem.locate_dofs_geometrical(V, lambda x: numpy.isclose(x[1], 0.0))
+    u_bc = fem.Function(V)
+    bc = fem.DirichletBC(u_bc, bdofs)
+
+    for bcs in ([], [bc]):
+        A = fem.assemble_matrix(a, bcs, diagonal=2.0)
+        A.assemble()
+        S = fem.create_matrix_shell(a, bcs, diagonal=2.0)
+
+        x = A.createVecRight()
+        x.array[:] = numpy.arange(x.local_size) % 7 + 0.5
+        y0, y1 = A.createVecLeft(), A.createVecLeft()
+        A.mult(x, y0)
+        S.mult(x, y1)
+        assert (y1 - y0).norm() == pytest.approx(0.0, abs=1.0e-12 * y0.norm())
+        S.destroy()
+
+
+def test_sparsity_pattern_cache():
+    """Check that matrices created by the sparsity pattern cache can be
+    assembled into and are independent of each other"""
+    mesh = UnitSquareMesh(MPI.COMM_WORLD, 8, 11)
+    V = fem.VectorFunctionSpace(mesh, ("Lagrange", 2))
+    u, v = ufl.TrialFunction(V), ufl.TestFunction(V)
+    a0 = fem.Form(inner(ufl.grad(u), ufl.grad(v)) * dx)
+    a1 = fem.Form(inner(u, v) * dx)
+
+    A_ref = [fem.assemble_matrix(a) for a in (a0, a1)]
+    for A in A_ref:
+        A.assemble()
+
+    cache = dolfinx.cpp.fem.SparsityPatternCache()
+    A = [cache.create_matrix(a._cpp_object) for a in (a0, a1)]
+    assert len(cache) == 1
+    for A_i, a in zip(A, (a0, a1)):
+        fem.assemble_matrix(A_i, a)
+        A_i.assemble()
+    for A_i, A_ref_i in zip(A, A_ref):
+        assert (A_i - A_ref_i).norm() == pytest.approx(0.0, abs=1.0e-12 * A_ref_i.norm())
+        A_i.destroy()
+
+
+def test_cell_geometry_cache():
+    """Check that assembly with the cell geometry cache matches assembly
+    without it, including after the coordinates have been modified
+    through a previously obtained view"""
+    mesh = UnitSquareMesh(MPI.COMM_WORLD, 8, 6, ghost_mode=dolfinx.cpp.mesh.GhostMode.shared_facet)
+    V = fem.FunctionSpace(mesh, ("Lagrange", 1))
+    u, v = ufl.TrialFunction(V), ufl.TestFunction(V)
+    x = ufl.SpatialCoordinate(mesh)
+    a = fem.Form(inner(x[0] * u, v) * dx + inner(x[1] * u, v) * ds + inner(ufl.avg(u), ufl.avg(v)) * ufl.dS)
+    L = fem.Form(inner(x[0], v) * dx + inner(x[1], v) * ds + inner(ufl.avg(x[0]), ufl.avg(v)) * ufl.dS)
+    M = fem.Form(x[0] * x[1] * dx + x[0] * ds + ufl.avg(x[1]) * ufl.dS)
+
+    def assemble():
+        A = fem.assemble_matrix(a)
+        A.assemble()
+        b = fem.assemble_vector(L)
+        b.ghostUpdate(addv=PETSc.InsertMode.ADD, mode=PETSc.ScatterMode.REVERSE)
+        m = mesh.mpi_comm().allreduce(fem.assemble_scalar(M), op=MPI.SUM)
+        return A, b, m
+
+    def check(A0, b0, m0, A1, b1, m1):
+        assert (A1 - A0).norm() == pytest.approx(0.0, abs=1.0e-12 * A0.norm())
+        assert (b1 - b0).norm() == pytest.approx(0.0, abs=1.0e-12 * b0.norm())
+        assert m1 == pytest.approx(m0, rel=1.0e-12)
+
+    x_g = mesh.geometry.x
+    A0, b0, m0 = assemble()
+    mesh.geometry.cache_cell_geometry(True)
+    assert mesh.geometry.cell_geometry_cached
+    A1, b1, m1 = assemble()
+    check(A0, b0, m0, A1, b1, m1)
+    m_ref = m1
+
+    # Modify the coordinates through the view obtained before the cache
+    # was built
+    x_g[:, 0] += 0.25 * x_g[:, 1]**2
+    mesh.geometry.invalidate_cell_cache()
+    A1, b1, m1 = assemble()
+    mesh.geometry.cache_cell_geometry(False)
+    A0, b0, m0 = assemble()
+    check(A0, b0, m0, A1, b1, m1)
+    assert m1 != pytest.approx(m_ref, rel=1.0e-6)
+
+
+@pytest.mark.parametrize("mesh", [UnitSquareMesh(MPI.COMM_WORLD, 5, 7),
+                                  UnitCubeMesh(MPI.COMM_WORLD, 3, 2, 4)])
+def test_assemble_blocked_vector_p1(mesh):
+    """Check that assembly on a blocked vector P1 space, which uses the
+    compile-time block size (bs=2 and bs=3) kernels, matches assembly
+    on the equivalent mixed space (bs=1), which uses the generic path"""
+    gdim = mesh.geometry.dim
+    P1 = ufl.FiniteElement("Lagrange", mesh.ufl_cell(), 1)
+    V = fem.FunctionSpace(mesh, ufl.VectorElement(P1, dim=gdim))
+    W = fem.FunctionSpace(mesh, ufl.MixedElement([P1] * gdim))
+    assert V.dofmap.index_map_bs == gdim
+    assert W.dofmap.index_map_bs == 1
+
+    # Map from (unrolled) local dofs of V to local dofs of W
+    size_local = gdim * V.dofmap.index_map.size_local
+    size = gdim * (V.dofmap.index_map.size_local + V.dofmap.index_map.num_ghosts)
+    V_to_W = numpy.full(size, -1, dtype=numpy.int32)
+    for i in range(gdim):
+        V_to_W[V.sub(i).dofmap.list.array] = W.sub(i).dofmap.list.array
+    assert (V_to_W >= 0).all()
+    assert (V_to_W[:size_local] < size_local).all()
+
+    def forms(U):
+        u, v = ufl.TrialFunction(U), ufl.TestFunction(U)
+        x = ufl.SpatialCoordinate(mesh)
+        f = ufl.as_vector([1.0 + x[i] * x[(i + 1) % gdim] for i in range(gdim)])
+        a = inner(ufl.grad(u), ufl.grad(v)) * dx + inner(u, v) * dx
+        L = inner(f, v) * dx
+        return fem.Form(a), fem.Form(L)
+
+    # Dirichlet conditions on the same boundary dofs with the same values
+    bndry_facets = dolfinx.mesh.locate_entities_boundary(mesh, mesh.topology.dim - 1,
+                                                         lambda x: numpy.isclose(x[0], 0.0))
+    g_V = fem.Function(V)
+    g_V.interpolate(lambda x: numpy.stack([1.0 + x[i] for i in range(gdim)]))
+    g_W = fem.Function(W)
+    with g_V.vector.localForm() as _g_V, g_W.vector.localForm() as _g_W:
+        _g_W.array[V_to_W] = _g_V.array
+    bc_V = fem.DirichletBC(g_V, fem.locate_dofs_topological(V, mesh.topology.dim - 1, bndry_facets))
+    bc_W = fem.DirichletBC(g_W, fem.locate_dofs_topological(W, mesh.topology.dim - 1, bndry_facets))
+
+    def assemble(U, bc):
+        a, L = forms(U)
+        A = fem.assemble_matrix(a, [bc])
+        A.assemble()
+        b = fem.assemble_vector(L)
+        fem.apply_lifting(b, [a], [[bc]])
+        b.ghostUpdate(addv=PETSc.InsertMode.ADD, mode=PETSc.ScatterMode.REVERSE)
+        fem.set_bc(b, [bc])
+        return A, b
+
+    A_V, b_V = assemble(V, bc_V)
+    A_W, b_W = assemble(W, bc_W)
+    assert A_V.norm() == pytest.approx(A_W.norm(), rel=1.0e-12)
+    assert b_V.norm() == pytest.approx(b_W.norm(), rel=1.0e-12)
+    assert numpy.allclose(b_V.array, b_W.array[V_to_W[:size_local]], rtol=1.0e-12, atol=1.0e-14)
+
+    # Compare matrices through their action on a (permuted) vector
+    x_W = A_W.createVecRight()
+    x_W.array[:] = numpy.random.default_rng(seed=3).random(size_local)
+    x_V = A_V.createVecRight()
+    x_V.array[:] = x_W.array[V_to_W[:size_local]]
+    y_V, y_W = A_V.createVecLeft(), A_W.createVecLeft()
+    A_V.mult(x_V, y_V)
+    A_W.mult(x_W, y_W)
+    assert numpy.allclose(y_V.array, y_W.array[V_to_W[:size_local]], rtol=1.0e-12, atol=1.0e-14)
+
+
+def test_reassemble_matrix():
+    """Check that incremental re-assembly on a subset of cells gives the
+    same matrix as full assembly"""
+    mesh = UnitSquareMesh(MPI.COMM_WORLD, 10, 7)
+    V = fem.FunctionSpace(mesh, ("Lagrange", 1))
+    Q = fem.FunctionSpace(mesh, ("DG", 0))
+    u, v = ufl.TrialFunction(V), ufl.TestFunction(V)
+    k = fem.Function(Q)
+    k.vector.set(1.0)
+    a = fem.Form(k * inner(ufl.grad(u), ufl.grad(v)) * dx)
+
+    bdofs = fem.locate_dofs_geometrical(V, lambda x: numpy.isclose(x[0], 0.0))
+    bc = fem.DirichletBC(fem.Function(V), bdofs)
+
+    num_cells = mesh.topology.index_map(mesh.topology.dim).size_local
+    for bcs in ([], [bc]):
+        # Full assembly through an empty cache populates the cache
+        _bcs = [bc._cpp_object for bc in bcs]
+        cache = dolfinx.cpp.fem.ElementTensorCache()
+        A = fem.create_matrix(a)
+        cells = numpy.arange(num_cells, dtype=numpy.int32)
+        dolfinx.cpp.fem.reassemble_matrix_petsc(A, a._cpp_object, cells, cache, _bcs)
+        A.assemble()
+        assert len(cache) == num_cells
+        A_ref = fem.assemble_matrix(a, bcs, diagonal=0.0)
+        A_ref.assemble()
+        assert (A - A_ref).norm() == pytest.approx(0.0, abs=1.0e-12 * A_ref.norm())
+
+        # Modify the coefficient on some cells and re-assemble on these
+        # cells only. Pass the cells unsorted and with duplicates.
+        cells = numpy.arange(0, num_cells, 3, dtype=numpy.int32)
+        for c in cells:
+            k.vector.array[Q.dofmap.cell_dofs(c)] += 1.0 + c
+        cells = numpy.concatenate((cells[::-1], cells[:2]))
+        dolfinx.cpp.fem.reassemble_matrix_petsc(A, a._cpp_object, cells, cache, _bcs)
+        A.assemble()
+        A_ref = fem.assemble_matrix(a, bcs, diagonal=0.0)
+        A_ref.assemble()
+        assert (A - A_ref).norm() == pytest.approx(0.0, abs=1.0e-12 * A_ref.norm())
+        k.vector.set(1.0)
+
+
+def test_reassemble_vector():
+    """Check that incremental re-assembly on a subset of cells gives the
+    same vector as full assembly after a coefficient is changed"""
+    mesh = UnitSquareMesh(MPI.COMM_WORLD, 10, 7)
+    V = fem.FunctionSpace(mesh, ("Lagrange", 2))
+    Q = fem.FunctionSpace(mesh, ("DG", 0))
+    v = ufl.TestFunction(V)
+    k = fem.Function(Q)
+    k.vector.set(1.0)
+    x = ufl.SpatialCoordinate(mesh)
+    L = fem.Form(k * (1.0 + x[0]) * v * dx)
+
+    def to_petsc(b_local):
+        """Copy local (owned and ghost) values into a PETSc vector and
+        accumulate the ghost contributions"""
+        b = fem.create_vector(L)
+        with b.localForm() as _b:
+            _b.array[:] = b_local
+        b.ghostUpdate(addv=PETSc.InsertMode.ADD, mode=PETSc.ScatterMode.REVERSE)
+        return b
+
+    # Full assembly through an empty cache populates the cache
+    num_cells = mesh.topology.index_map(mesh.topology.dim).size_local
+    size = V.dofmap.index_map_bs * (V.dofmap.index_map.size_local + V.dofmap.index_map.num_ghosts)
+    b_local = numpy.zeros(size, dtype=PETSc.ScalarType)
+    cache = dolfinx.cpp.fem.ElementTensorCache()
+    cells = numpy.arange(num_cells, dtype=numpy.int32)
+    dolfinx.cpp.fem.reassemble_vector(b_local, L._cpp_object, cells, cache)
+    assert len(cache) == num_cells
+    b = to_petsc(b_local)
+    b_ref = fem.assemble_vector(L)
+    b_ref.ghostUpdate(addv=PETSc.InsertMode.ADD, mode=PETSc.ScatterMode.REVERSE)
+    assert (b - b_ref).norm() == pytest.approx(0.0, abs=1.0e-12 * b_ref.norm())
+
+    # Modify the coefficient on some cells and re-assemble on these
+    # cells only
+    cells = numpy.arange(1, num_cells, 4, dtype=numpy.int32)
+    for c in cells:
+        k.vector.array[Q.dofmap.cell_dofs(c)] += 2.0 + c
+    dolfinx.cpp.fem.reassemble_vector(b_local, L._cpp_object, cells, cache)
+    assert len(cache) == num_cells
+    b = to_petsc(b_local)
+    b_ref = fem.assemble_vector(L)
+    b_ref.ghostUpdate(addv=PETSc.InsertMode.ADD, mode=PETSc.ScatterMode.REVERSE)
+    assert (b - b_ref).norm() == pytest.approx(0.0, abs=1.0e-12 * b_ref.norm())
+
+
+@pytest.mark.parametrize("mode", [dolfinx.cpp.mesh.GhostMode.none, dolfinx.cpp.mesh.GhostMode.shared_facet])
+def test_assemble_vector_begin_end(mode):
+    """Check that split-phase assembly, which overlaps the ghost update
+    of a coefficient with assembly, matches assemble_vector"""
+    mesh = UnitSquareMesh(MPI.COMM_WORLD, 12, 9, ghost_mode=mode)
+    V = fem.FunctionSpace(mesh, ("Lagrange", 2))
+    v = ufl.TestFunction(V)
+    u = fem.Function(V)
+    u.interpolate(lambda x: 1.0 + x[0] * x[1] + x[0]**2)
+    L = u * v * dx + u * v * ds
+    if mode == dolfinx.cpp.mesh.GhostMode.shared_facet:
+        L += inner(ufl.avg(u), ufl.avg(v)) * ufl.dS
+    L = fem.Form(L)
+
+    # Reference with up-to-date ghosts
+    b0 = fem.assemble_vector(L)
+    b0.ghostUpdate(addv=PETSc.InsertMode.ADD, mode=PETSc.ScatterMode.REVERSE)
+
+    # Invalidate the ghost values of the coefficient, which are updated
+    # during assembly
+    size_local = V.dofmap.index_map_bs * V.dofmap.index_map.size_local
+    u.x.array[size_local:] = -1.0
+    u.x.increment_version()
+
+    b = fem.Function(V)
+    dolfinx.cpp.fem.assemble_vector_begin(b.x, L._cpp_object, [u.x])
+    dolfinx.cpp.fem.assemble_vector_end(b.x)
+    assert numpy.allclose(b.x.array[:size_local], b0.array, rtol=1.0e-12, atol=1.0e-14)
+
+
+@pytest.mark.parametrize("fused", [True, False])
+def test_assemble_system(fused):
+    """Check that single-pass system assembly gives the same matrix and
+    vector as assemble_matrix, assemble_vector and apply_lifting"""
+    mesh = UnitSquareMesh(MPI.COMM_WORLD, 9, 12, ghost_mode=dolfinx.cpp.mesh.GhostMode.shared_facet)
+    V = fem.FunctionSpace(mesh, ("Lagrange", 2))
+    u, v = ufl.TrialFunction(V), ufl.TestFunction(V)
+    f = fem.Function(V)
+    f.interpolate(lambda x: 1.0 + x[0] * x[1])
+
+    # Mark cells for the integration domains. The cell integrals of a
+    # and L have the same id, over the same cells if fused is True and
+    # over different cells otherwise.
+    tdim = mesh.topology.dim
+    cell_map = mesh.topology.index_map(tdim)
+    indices = numpy.arange(cell_map.size_local + cell_map.num_ghosts, dtype=numpy.int32)
+    values_a = numpy.ones(indices.shape, dtype=numpy.intc)
+    values_L = values_a.copy()
+    if not fused:
+        values_L[dolfinx.mesh.locate_entities(mesh, tdim, lambda x: x[0] <= 0.5 + 1.0e-10)] = 2
+    dx_a = ufl.Measure("dx", subdomain_data=dolfinx.mesh.MeshTags(mesh, tdim, indices, values_a), domain=mesh)
+    dx_L = ufl.Measure("dx", subdomain_data=dolfinx.mesh.MeshTags(mesh, tdim, indices, values_L), domain=mesh)
+    a = fem.Form(inner(f * ufl.grad(u), ufl.grad(v)) * dx_a(1) + inner(u, v) * ds)
+    L = fem.Form(inner(f, v) * dx_L(1) + inner(f, v) * ds)
+
+    u_bc = fem.Function(V)
+    u_bc.interpolate(lambda x: x[0] + 2.0 * x[1])
+    bdofs = fem.locate_dofs_geometrical(V, lambda x: numpy.isclose(x[1], 0.0))
+    bcs = [fem.DirichletBC(u_bc, bdofs)]
+
+    A_ref = fem.assemble_matrix(a, bcs, diagonal=0.0)
+    A_ref.assemble()
+    b_ref = fem.assemble_vector(L)
+    fem.apply_lifting(b_ref, [a], [bcs])
+    b_ref.ghostUpdate(addv=PETSc.InsertMode.ADD, mode=PETSc.ScatterMode.REVERSE)
+
+    A = fem.create_matrix(a)
+    b = fem.create_vector(L)
+    with b.localForm() as b_local:
+        b_local.set(0.0)
+        dolfinx.cpp.fem.assemble_system_petsc(A, b_local.array_w, a._cpp_object, L._cpp_object,
+                                              [bc._cpp_object for bc in bcs])
+    A.assemble()
+    b.ghostUpdate(addv=PETSc.InsertMode.ADD, mode=PETSc.ScatterMode.REVERSE)
+
+    assert (A - A_ref).norm() == pytest.approx(0.0, abs=1.0e-12 * A_ref.norm())
+    assert (b - b_ref).norm() == pytest.approx(0.0, abs=1.0e-12 * b_ref.norm())
+
+    fem.set_bc(b, bcs)
+    fem.set_bc(b_ref, bcs)
+    assert (b - b_ref).norm() == pytest.approx(0.0, abs=1.0e-12 * b_ref.norm())
+
+
+def test_cached_coefficient_packing():
+    """Check that re-assembling a form with coefficients packed by
+    pack_coefficients_cached after modifying a coefficient uses the new
+    coefficient values"""
+    mesh = UnitSquareMesh(MPI.COMM_WORLD, 7, 5)
+    V = fem.FunctionSpace(mesh, ("Lagrange", 1))
+    u, v = ufl.TrialFunction(V), ufl.TestFunction(V)
+    f = fem.Function(V)
+    f.interpolate(lambda x: 1.0 + x[0])
+    a = fem.Form(inner(f * u, v) * dx)
+    L = fem.Form(inner(f, v) * dx)
+
+    def assemble():
+        A = fem.assemble_matrix(a, coeffs=(None, fem.assemble.pack_coefficients_cached(a)))
+        A.assemble()
+        b = fem.assemble_vector(L, coeffs=(None, fem.assemble.pack_coefficients_cached(L)))
+        b.ghostUpdate(addv=PETSc.InsertMode.ADD, mode=PETSc.ScatterMode.REVERSE)
+        return A, b
+
+    A0, b0 = assemble()
+
+    # Packing again without changes gives the same values as a full pack
+    c0 = fem.assemble.pack_coefficients_cached(L)
+    c1 = fem.assemble.pack_coefficients_cached(L)
+    assert numpy.array_equal(c0, c1)
+    assert numpy.array_equal(c0, fem.assemble.pack_coefficients(L))
+
+    def check(scale):
+        A, b = assemble()
+        assert (A - scale * A0).norm() == pytest.approx(0.0, abs=1.0e-12 * A0.norm())
+        assert (b - scale * b0).norm() == pytest.approx(0.0, abs=1.0e-12 * b0.norm())
+
+    # Modify through a new view of the values
+    f.x.array[:] *= 2.0
+    check(2.0)
+
+    # Modify through the PETSc vector
+    f.vector.scale(1.5)
+    f.vector.ghostUpdate(addv=PETSc.InsertMode.INSERT, mode=PETSc.ScatterMode.FORWARD)
+    check(3.0)
+
+    # Modify through a view obtained before the last assembly
+    x = f.x.array
+    check(3.0)
+    version = f.version
+    x[:] *= 2.0
+    f.x.increment_version()
+    assert f.version != version
+    check(6.0)
+
+
+def test_interior_facet_table_assembly():
+    """Check interior facet matrix and vector assembly, which run over
+    the precomputed interior facet tables, against the lifting of
+    boundary conditions, which runs over the interior facet domains"""
+    mesh = UnitSquareMesh(MPI.COMM_WORLD, 6, 5, ghost_mode=dolfinx.cpp.mesh.GhostMode.shared_facet)
+    V = fem.FunctionSpace(mesh, ("DG", 1))
+    u, v = ufl.TrialFunction(V), ufl.TestFunction(V)
+    f = fem.Function(V)
+    f.interpolate(lambda x: 1.0 + x[0] * x[1])
+    a = inner(ufl.avg(f) * ufl.jump(u), ufl.jump(v)) * ufl.dS + inner(ufl.avg(u), ufl.avg(v)) * ufl.dS
+
+    g = fem.Function(V)
+    g.interpolate(lambda x: numpy.sin(x[0]) + x[1])
+
+    # A g, from the matrix
+    A = fem.assemble_matrix(a)
+    A.assemble()
+    y0 = A.createVecLeft()
+    A.mult(g.vector, y0)
+
+    # A g, from the action of a
+    y1 = fem.assemble_vector(ufl.action(a, g))
+    y1.ghostUpdate(addv=PETSc.InsertMode.ADD, mode=PETSc.ScatterMode.REVERSE)
+
+    # -A g, from lifting a boundary condition that is applied to all
+    # dofs
+    num_dofs = V.dofmap.index_map.size_local + V.dofmap.index_map.num_ghosts
+    bc = fem.DirichletBC(g, numpy.arange(num_dofs, dtype=numpy.int32))
+    y2 = fem.create_vector(ufl.action(a, g))
+    with y2.localForm() as y2_local:
+        y2_local.set(0.0)
+    fem.apply_lifting(y2, [a], [[bc]])
+    y2.ghostUpdate(addv=PETSc.InsertMode.ADD, mode=PETSc.ScatterMode.REVERSE)
+
+    assert y0.norm() > 0.0
+    assert (y1 - y0).norm() == pytest.approx(0.0, abs=1.0e-12 * y0.norm())
+    assert (y2 + y0).norm() == pytest.approx(0.0, abs=1.0e-12 * y0.norm())
+
+
+def test_assemble_scalar_reproducible():
+    """Check that reproducible functional assembly is bitwise identical
+    on one process and on all processes, and for meshes whose cells are
+    given in different orders"""
+    def functionals(mesh):
+        V = fem.FunctionSpace(mesh, ("DG", 1))
+        f = fem.Function(V)
+        f.interpolate(lambda x: numpy.sin(3.0 * x[0]) + x[0] * x[1] ** 2)
+        # The interior facet term is not symmetric in the restrictions
+        M0 = f * dx + f**2 * ds + (f("+") - 2.0 * f("-"))**2 * ufl.dS
+        M1 = f * dx + f**2 * ds + ufl.avg(f)**2 * ufl.dS
+        return fem.assemble_scalar_reproducible(M0), fem.assemble_scalar_reproducible(M1), M1
+
+    # Same mesh distributed over all processes and on each process
+    m0, m1, M1 = functionals(UnitSquareMesh(MPI.COMM_WORLD, 9, 7))
+    m0_self, m1_self, _ = functionals(UnitSquareMesh(MPI.COMM_SELF, 9, 7))
+    assert m0 == m0_self
+    assert m1 == m1_self
+
+    # Agreement with the standard assembly
+    m1_ref = MPI.COMM_WORLD.allreduce(fem.assemble_scalar(M1), op=MPI.SUM)
+    assert m1 == pytest.approx(m1_ref, rel=1.0e-12)
+
+    # Same mesh created from cells given in different orders
+    n = 6
+    x = numpy.array([[i / n, j / n] for j in range(n + 1) for i in range(n + 1)], dtype=numpy.float64)
+    cells = []
+    for j in range(n):
+        for i in range(n):
+            v0 = j * (n + 1) + i
+            cells += [[v0, v0 + 1, v0 + n + 2], [v0, v0 + n + 1, v0 + n + 2]]
+    cells = numpy.array(cells, dtype=numpy.int64)
+    domain = ufl.Mesh(ufl.VectorElement("Lagrange", "triangle", 1))
+    rng = numpy.random.default_rng(7)
+    m0_ordered, _, _ = functionals(create_mesh(MPI.COMM_SELF, cells, x, domain))
+    m0_permuted, _, _ = functionals(create_mesh(MPI.COMM_SELF, cells[rng.permutation(len(cells))], x, domain))
+    assert m0_ordered == m0_permuted
+
+
+def test_assemble_float32():
+    """Check that functionals and vectors assembled in single precision
+    agree with double precision assembly to single precision accuracy"""
+    mesh = UnitSquareMesh(MPI.COMM_WORLD, 6, 5)
+    V = fem.FunctionSpace(mesh, ("Lagrange", 2))
+    v = ufl.TestFunction(V)
+    cpp_fem = dolfinx.cpp.fem
+
+    def assemble(dtype):
+        f = fem.Function(V, dtype=dtype)
+        f.interpolate(lambda x: 1.0 + x[0] * x[1] ** 2)
+        c = fem.Constant(mesh, dtype(2.5))
+        M = fem.Form(c * f**2 * dx + f * ds, dtype=dtype)._cpp_object
+        L = fem.Form(inner(c * f, v) * dx + inner(ufl.grad(f), ufl.grad(v)) * dx, dtype=dtype)._cpp_object
+
+        m = cpp_fem.assemble_scalar(M, cpp_fem.pack_constants(M), cpp_fem.pack_coefficients(M))
+        m = MPI.COMM_WORLD.allreduce(m, op=MPI.SUM)
+        index_map = V.dofmap.index_map
+        b = numpy.zeros(index_map.size_local + index_map.num_ghosts, dtype=dtype)
+        cpp_fem.assemble_vector(b, L, cpp_fem.pack_constants(L), cpp_fem.pack_coefficients(L))
+        return m, b
+
+    m32, b32 = assemble(numpy.float32)
+    m64, b64 = assemble(numpy.float64)
+    assert b32.dtype == numpy.float32
+    eps = numpy.finfo(numpy.float32).eps
+    assert m32 == pytest.approx(m64, rel=50 * eps)
+    assert numpy.allclose(b32, b64, rtol=0.0, atol=50 * eps * numpy.abs(b64).max())
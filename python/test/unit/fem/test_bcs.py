@@ -6,6 +6,7 @@
 
 import dolfinx
 import numpy as np
+import pytest
 import ufl
 from mpi4py import MPI
 from petsc4py import PETSc
@@ -93,3 +94,69 @@ def test_overlapping_bcs():
         with b.localForm() as b_loc:
             print(b_loc[dof_corner[0]])
             assert b_loc[dof_corner[0]] == 123.456
+
+
+@pytest.mark.parametrize("degree", [1, 2])
+def test_locate_dofs_geometrical_on_entities(degree):
+    """Test that locating dofs geometrically on the exterior facets
+    finds the same boundary dofs as searching all dofs"""
+    mesh = dolfinx.generation.UnitSquareMesh(MPI.COMM_WORLD, 5, 7)
+    V = dolfinx.fem.FunctionSpace(mesh, ("Lagrange", degree))
+    tdim = mesh.topology.dim
+    mesh.topology.create_connectivity(tdim - 1, tdim)
+    facets = dolfinx.mesh.locate_entities_boundary(mesh, tdim - 1, lambda x: np.full(x.shape[1], True))
+
+    def marker(x):
+        return np.logical_or(np.isclose(x[0], 0.0), np.isclose(x[1], 1.0))
+
+    dofs0 = dolfinx.fem.locate_dofs_geometrical(V, marker)
+    dofs1 = dolfinx.fem.locate_dofs_geometrical(V, marker, tdim - 1, facets)
+    assert np.array_equal(dofs0, dofs1)
+    assert MPI.COMM_WORLD.allreduce(len(dofs1), op=MPI.SUM) > 0
+
+
+def test_set_bc_values():
+    """Test that set_bc inserts the boundary values, with and without x0
+    and a scale, into exactly the constrained dofs when the dofs of the
+    constrained space and the space of the values differ"""
+    mesh = dolfinx.generation.UnitSquareMesh(MPI.COMM_WORLD, 6, 6)
+    P1 = ufl.FiniteElement("Lagrange", mesh.ufl_cell(), 1)
+    P2 = ufl.FiniteElement("Lagrange", mesh.ufl_cell(), 2)
+    W = dolfinx.fem.FunctionSpace(mesh, P1 * P2)
+    V = W.sub(1).collapse()
+    dofs = dolfinx.fem.locate_dofs_geometrical((W.sub(1), V), lambda x: x[0] < 0.5 + 1.0e-10)
+
+    rng = np.random.default_rng(4)
+    g = dolfinx.Function(V)
+    g.vector.array[:] = rng.random(g.vector.array.size)
+    g.vector.ghostUpdate(addv=PETSc.InsertMode.INSERT, mode=PETSc.ScatterMode.FORWARD)
+    g_values = g.x.array.copy()
+
+    def random_vector(space):
+        x = dolfinx.Function(space).vector.copy()
+        x.array[:] = rng.random(x.array.size)
+        return x
+
+    # Constrained space differs from the space of g
+    bc = dolfinx.DirichletBC(g, dofs, W.sub(1))
+    owned = dofs[0] < W.dofmap.index_map.size_local
+    dofs0, dofs1 = dofs[0][owned], dofs[1][owned]
+    b, x0 = random_vector(W), random_vector(W)
+    b_ref = b.array.copy()
+    b_ref[dofs0] = 2.5 * (g_values[dofs1] - x0.array[dofs0])
+    dolfinx.fem.set_bc(b, [bc], x0, 2.5)
+    assert np.allclose(b.array, b_ref)
+
+    b_ref[dofs0] = g_values[dofs1]
+    dolfinx.fem.set_bc(b, [bc])
+    assert np.allclose(b.array, b_ref)
+
+    # Constrained space is the space of g
+    dofs_V = dofs[1][np.argsort(dofs[1])]
+    bc = dolfinx.DirichletBC(g, dofs_V)
+    dofs_V = dofs_V[dofs_V < V.dofmap.index_map.size_local]
+    c = random_vector(V)
+    c_ref = c.array.copy()
+    c_ref[dofs_V] = -g_values[dofs_V]
+    dolfinx.fem.set_bc(c, [bc], scale=-1.0)
+    assert np.allclose(c.array, c_ref)
@@ -6,11 +6,14 @@
 #
 # SPDX-License-Identifier:    LGPL-3.0-or-later
 
+import cffi
 import dolfinx
 import numba
 import numpy as np
-from dolfinx import (Function, FunctionSpace, TimingType, UnitSquareMesh, cpp,
-                     list_timings)
+import pytest
+import ufl
+from dolfinx import (Function, FunctionSpace, TimingType, UnitCubeMesh,
+                     UnitSquareMesh, cpp, list_timings)
 from dolfinx.fem import IntegralType
 from dolfinx_utils.test.skips import skip_if_complex
 from mpi4py import MPI
@@ -24,6 +27,18 @@ c_signature = numba.types.void(
     numba.types.CPointer(numba.types.int32),
     numba.types.CPointer(numba.types.int32))
 
+# Signature of generated (FFCx) kernels, used for batched kernels that
+# call a generated kernel for each cell in the batch
+batch_signature = numba.types.void(
+    numba.types.CPointer(numba.typeof(PETSc.ScalarType())),
+    numba.types.CPointer(numba.typeof(PETSc.ScalarType())),
+    numba.types.CPointer(numba.typeof(PETSc.ScalarType())),
+    numba.types.CPointer(numba.types.double),
+    numba.types.CPointer(numba.types.int32),
+    numba.types.CPointer(numba.types.uint8))
+
+ffi = cffi.FFI()
+
 
 @numba.cfunc(c_signature, nopython=True)
 def tabulate_tensor_A(A_, w_, c_, coords_, entity_local_index, cell_orientation):
@@ -237,3 +252,90 @@ def test_cffi_assembly():
     assert (np.isclose(bnorm, 0.0739710713711999))
 
     list_timings(MPI.COMM_WORLD, [TimingType.wall])
+
+
+def create_batch_kernel(form, batch_size):
+    """Create a batched kernel for the default cell integral of form. The
+    batched kernel de-interleaves the data for each cell in the batch and
+    calls the generated cell kernel."""
+    kernel = getattr(form.ufc_form.integrals(0)[0], f"tabulate_tensor_{np.dtype(PETSc.ScalarType).name}")
+    mesh = form._cpp_object.mesh
+    ndim = int(np.prod([V.dofmap.bs * V.dofmap.cell_dofs(0).size for V in form.function_spaces]))
+    nw = dolfinx.cpp.fem.pack_coefficients(form._cpp_object).shape[1]
+    ncoords = 3 * mesh.geometry.dofmap.links(0).size
+
+    @numba.cfunc(batch_signature, nopython=True)
+    def tabulate_batch(A_, w_, c_, coords_, entity_local_index, quadrature_perm):
+        A = numba.carray(A_, ndim * batch_size, dtype=PETSc.ScalarType)
+        w = numba.carray(w_, nw * batch_size, dtype=PETSc.ScalarType)
+        coords = numba.carray(coords_, ncoords * batch_size, dtype=np.float64)
+
+        A_k = np.zeros(ndim, dtype=PETSc.ScalarType)
+        w_k = np.zeros(max(nw, 1), dtype=PETSc.ScalarType)
+        c_k = np.zeros(1, dtype=PETSc.ScalarType)
+        coords_k = np.zeros(ncoords, dtype=np.float64)
+        index = np.zeros(1, dtype=np.intc)
+        perm = np.zeros(1, dtype=np.uint8)
+        for k in range(batch_size):
+            for j in range(nw):
+                w_k[j] = w[j * batch_size + k]
+            for j in range(ncoords):
+                coords_k[j] = coords[j * batch_size + k]
+            A_k[:] = 0.0
+            kernel(ffi.from_buffer(A_k), ffi.from_buffer(w_k), ffi.from_buffer(c_k),
+                   ffi.from_buffer(coords_k), ffi.from_buffer(index), ffi.from_buffer(perm))
+            for j in range(ndim):
+                A[j * batch_size + k] = A_k[j]
+
+    return tabulate_batch
+
+
+@skip_if_complex
+@pytest.mark.parametrize("batch_size", [5, 7])
+@pytest.mark.parametrize("cache_geometry", [False, True])
+def test_batch_kernel(batch_size, cache_geometry):
+    """Test assembly with a batched kernel against assembly with the
+    per-cell kernel. The element requires DOF transformations and the
+    forms have coefficients, and the number of cells is not a multiple
+    of the batch size."""
+    mesh = UnitCubeMesh(MPI.COMM_WORLD, 2, 2, 3)
+    mesh.geometry.cache_cell_geometry(cache_geometry)
+    V = FunctionSpace(mesh, ("N1curl", 1))
+    Q = FunctionSpace(mesh, ("Lagrange", 1))
+
+    f = Function(Q)
+    f.interpolate(lambda x: 1.0 + x[0] + 2.0 * x[1] * x[2])
+    g = Function(V)
+    g.interpolate(lambda x: np.stack((x[1], x[2] * x[0], 1.0 + x[0])))
+
+    u, v = ufl.TrialFunction(V), ufl.TestFunction(V)
+    a = f * ufl.inner(u, v) * ufl.dx
+    L = f * ufl.inner(g, v) * ufl.dx
+
+    num_cells = mesh.topology.index_map(mesh.topology.dim).size_local
+    if mesh.mpi_comm().size == 1:
+        assert num_cells % batch_size != 0
+
+    a0, a1 = dolfinx.fem.Form(a), dolfinx.fem.Form(a)
+    kernel_a = create_batch_kernel(a1, batch_size)
+    a1._cpp_object.set_batch_kernel(IntegralType.cell, -1, batch_size, kernel_a.address)
+    assert a1._cpp_object.batch_size(IntegralType.cell, -1) == batch_size
+    assert a0._cpp_object.batch_size(IntegralType.cell, -1) == 0
+
+    A0 = dolfinx.fem.assemble_matrix(a0)
+    A0.assemble()
+    A1 = dolfinx.fem.assemble_matrix(a1)
+    A1.assemble()
+    assert A0.norm() > 0.0
+    assert (A1 - A0).norm() == pytest.approx(0.0, abs=1.0e-12)
+
+    L0, L1 = dolfinx.fem.Form(L), dolfinx.fem.Form(L)
+    kernel_L = create_batch_kernel(L1, batch_size)
+    L1._cpp_object.set_batch_kernel(IntegralType.cell, -1, batch_size, kernel_L.address)
+
+    b0 = dolfinx.fem.assemble_vector(L0)
+    b0.ghostUpdate(addv=PETSc.InsertMode.ADD, mode=PETSc.ScatterMode.REVERSE)
+    b1 = dolfinx.fem.assemble_vector(L1)
+    b1.ghostUpdate(addv=PETSc.InsertMode.ADD, mode=PETSc.ScatterMode.REVERSE)
+    assert b0.norm() > 0.0
+    assert (b1 - b0).norm() == pytest.approx(0.0, abs=1.0e-12)
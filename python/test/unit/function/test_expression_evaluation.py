@@ -172,6 +172,46 @@ def test_simple_evaluation():
     assert np.allclose(grad_f_evaluated, grad_f_exact)
 
 
+@pytest.mark.parametrize("num_threads", [1, 3])
+def test_evaluation_into_buffers(num_threads):
+    """Test evaluation of an Expression into a strided array and into
+    the degree-of-freedom array of a Function, against the default
+    evaluation into a new array and against interpolation of the exact
+    gradient."""
+    mesh = dolfinx.generation.UnitSquareMesh(MPI.COMM_WORLD, 4, 5)
+    P2 = dolfinx.FunctionSpace(mesh, ("P", 2))
+    f = dolfinx.Function(P2)
+    f.interpolate(lambda x: x[0] ** 2 + 2.0 * x[1] ** 2)
+
+    # The Expression points are the interpolation points of vector DG1
+    points = np.array([[0.0, 0.0], [1.0, 0.0], [0.0, 1.0]])
+    grad_f_expr = dolfinx.Expression(ufl.grad(f), points)
+    map_c = mesh.topology.index_map(mesh.topology.dim)
+    num_cells = map_c.size_local + map_c.num_ghosts
+    cells = np.arange(0, num_cells, dtype=np.int32)
+    values = grad_f_expr.eval(cells)
+
+    # Evaluate on the cells in reverse order into the leading columns of
+    # a wider array, leaving the remaining columns untouched
+    ncols = grad_f_expr.num_points * grad_f_expr.value_size
+    buffer = np.full((num_cells, ncols + 3), -1.0, dtype=PETSc.ScalarType)
+    grad_f_expr.eval(cells[::-1].copy(), buffer[:, :ncols], num_threads=num_threads)
+    assert np.allclose(buffer[:, :ncols], values[::-1])
+    assert np.all(buffer[:, ncols:] == -1.0)
+
+    # Evaluate into an array with non-contiguous rows
+    buffer = np.zeros((ncols, num_cells), dtype=PETSc.ScalarType).T
+    grad_f_expr.eval(cells, buffer, num_threads=num_threads)
+    assert np.allclose(buffer, values)
+
+    # Insert the values into a vector DG1 Function
+    DG1 = dolfinx.VectorFunctionSpace(mesh, ("DG", 1))
+    u, u_exact = dolfinx.Function(DG1), dolfinx.Function(DG1)
+    grad_f_expr._cpp_object.eval(cells, u._cpp_object, num_threads)
+    u_exact.interpolate(lambda x: np.vstack((2.0 * x[0], 4.0 * x[1])))
+    assert np.allclose(u.vector.array, u_exact.vector.array)
+
+
 def test_assembly_into_quadrature_function():
     """Test assembly into a Quadrature function.
 
@@ -264,3 +304,62 @@ def test_assembly_into_quadrature_function():
             e_exact_eval[Q_dofs_unrolled[cell]] = e_exact(x.T).T.flatten()
 
         assert np.allclose(local.array, e_exact_eval)
+
+
+def test_assembly_with_quadrature_data():
+    """Test assembly with QuadratureData attached to a form coefficient.
+
+    An Expression is evaluated into the quadrature data on the owned
+    cells only, and the ghost values are updated with a forward
+    scatter. The assembled vector is compared with assembly of the same
+    form with the values inserted into a Quadrature Function instead.
+    """
+    mesh = dolfinx.UnitSquareMesh(MPI.COMM_WORLD, 4, 5)
+
+    quadrature_degree = 2
+    quadrature_points, wts = basix.make_quadrature("default", basix.CellType.triangle, quadrature_degree)
+    Q_element = ufl.FiniteElement("Quadrature", ufl.triangle, quadrature_degree, quad_scheme="default")
+    Q = dolfinx.FunctionSpace(mesh, Q_element)
+    V = dolfinx.FunctionSpace(mesh, ("P", 1))
+    v = ufl.TestFunction(V)
+
+    T = dolfinx.Function(V)
+    T.interpolate(lambda x: x[0] + 2.0 * x[1])
+    e_expr = dolfinx.Expression(T**2, quadrature_points)
+
+    map_c = mesh.topology.index_map(mesh.topology.dim)
+    num_cells = map_c.size_local + map_c.num_ghosts
+    cells = np.arange(0, num_cells, dtype=np.int32)
+
+    def assemble(L):
+        b = dolfinx.fem.assemble_vector(L)
+        b.ghostUpdate(addv=PETSc.InsertMode.ADD, mode=PETSc.ScatterMode.REVERSE)
+        return b
+
+    # Existing path: values inserted into a Quadrature Function
+    q = dolfinx.Function(Q)
+    with q.vector.localForm() as q_local:
+        q_local.setValues(Q.dofmap.list.array, e_expr.eval(cells), addv=PETSc.InsertMode.INSERT)
+    dx = ufl.dx(metadata={"quadrature_degree": quadrature_degree})
+    b0 = assemble(q * v * dx)
+
+    # Quadrature data, which replaces a zero Quadrature Function
+    data_type = getattr(dolfinx.cpp.fem, "QuadratureData_" + np.dtype(PETSc.ScalarType).name)
+    data = data_type(mesh, quadrature_points.shape[0], 1)
+    e_expr._cpp_object.eval(cells[:map_c.size_local], data)
+    data.scatter_forward()
+    L = dolfinx.fem.Form(dolfinx.Function(Q) * v * dx)
+    L._cpp_object.set_quadrature_data(0, data)
+    b1 = assemble(L)
+
+    # Data with a size that does not match the coefficient element
+    with pytest.raises(RuntimeError):
+        L._cpp_object.set_quadrature_data(0, data_type(mesh, quadrature_points.shape[0], 2))
+    assert np.isclose((b1 - b0).norm(), 0.0)
+
+    # Modified quadrature data is re-packed
+    version = data.version
+    data.x.array[:] *= 2.0
+    assert data.version != version
+    b2 = assemble(L)
+    assert np.isclose((b2 - 2.0 * b0).norm(), 0.0)
@@ -166,6 +166,49 @@ def test_eval_multiple(W):
     u.eval(x[0], cell)
 
 
+@pytest.mark.parametrize("cell_type", [dolfinx.cpp.mesh.CellType.triangle,
+                                       dolfinx.cpp.mesh.CellType.quadrilateral])
+@pytest.mark.parametrize("num_threads", [1, 3])
+def test_eval_points_in_any_order(cell_type, num_threads):
+    """Evaluate a Function at several points per cell, passed in random
+    order, and compare with the exact values and with evaluation one
+    point at a time"""
+    mesh = dolfinx.UnitSquareMesh(MPI.COMM_WORLD, 5, 4, cell_type)
+    V = VectorFunctionSpace(mesh, ("Lagrange", 2))
+    u = Function(V)
+
+    def f(x):
+        return np.vstack((1.0 + x[0] + 2.0 * x[1] + x[0] * x[1], x[0] - x[1]))
+    u.interpolate(f)
+
+    # Three points inside each local cell, as random convex combinations
+    # of the cell nodes
+    rng = np.random.default_rng(11)
+    num_cells = mesh.topology.index_map(mesh.topology.dim).size_local
+    x_dofmap = mesh.geometry.dofmap
+    points, cells = [], []
+    for c in range(num_cells):
+        nodes = mesh.geometry.x[x_dofmap.links(c)]
+        for i in range(3):
+            w = rng.random(len(nodes))
+            points.append(w @ nodes / w.sum())
+            cells.append(c)
+    points.append(np.zeros(3))
+    cells.append(-1)
+    points, cells = np.array(points), np.array(cells, dtype=np.int32)
+    perm = rng.permutation(len(cells))
+    points, cells = points[perm], cells[perm]
+
+    values = np.full((len(cells), 2), -1.0, dtype=PETSc.ScalarType)
+    u.eval(points, cells, values, num_threads=num_threads)
+    for p, c, value in zip(points, cells, values):
+        if c < 0:
+            assert np.allclose(value, -1.0)
+        else:
+            assert np.allclose(value, f(p.reshape(3, 1)).flatten(), rtol=1.0e-12, atol=1.0e-12)
+            assert np.allclose(value, u.eval(p, c), rtol=1.0e-14, atol=1.0e-14)
+
+
 @skip_in_parallel
 def test_eval_manifold():
     # Simple two-triangle surface in 3d
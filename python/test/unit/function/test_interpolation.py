@@ -245,6 +245,40 @@ def test_interpolation_nedelec(order1, order2):
     assert np.isclose(dolfinx.fem.assemble_scalar(ufl.inner(u - w, u - w) * ufl.dx), 0)
 
 
+@skip_in_parallel
+def test_interpolation_batched_and_transformed_cells():
+    """Interpolation between different elements computes cells without
+    DOF transformations in batches and cells with non-zero permutation
+    info one at a time. Check that both give the exact result."""
+    # Reverse the local vertex order of every second cell so that some
+    # cells need DOF transformations
+    mesh0 = dolfinx.UnitCubeMesh(MPI.COMM_SELF, 3, 3, 4)
+    x = mesh0.geometry.x
+    cells = mesh0.geometry.dofmap.array.reshape(-1, 4).copy()
+    cells[::2] = cells[::2, ::-1]
+    domain = ufl.Mesh(ufl.VectorElement("Lagrange", "tetrahedron", 1))
+    mesh = create_mesh(MPI.COMM_WORLD, cells, x, domain)
+
+    V = dolfinx.FunctionSpace(mesh, ("N1curl", 1))
+    V1 = dolfinx.FunctionSpace(mesh, ("N1curl", 2))
+
+    # a + b x x is contained in the lowest order N1curl space
+    def f(x):
+        return np.stack((1.0 - x[1], 2.0 + x[0], 3.0 * np.ones(x.shape[1])))
+
+    u = dolfinx.Function(V)
+    u.interpolate(f)
+    v = dolfinx.Function(V1)
+    v.interpolate(u)
+
+    cell_info = mesh.topology.get_cell_permutation_info()
+    assert np.count_nonzero(cell_info) > 0
+
+    v_ref = dolfinx.Function(V1)
+    v_ref.interpolate(f)
+    assert np.allclose(v.x.array, v_ref.x.array, rtol=1.0e-12, atol=1.0e-12)
+
+
 @pytest.mark.xfail(strict=True)
 def test_interpolation_cross():
     mesh = dolfinx.UnitCubeMesh(MPI.COMM_WORLD, 2, 2, 2)
@@ -335,3 +369,33 @@ def test_interpolation_non_affine():
     v.interpolate(w)
     s = dolfinx.fem.assemble_scalar(ufl.inner(w - v, w - v) * ufl.dx)
     assert np.isclose(s, 0)
+
+
+@pytest.mark.parametrize("cell_type", [CellType.triangle, CellType.quadrilateral])
+def test_interpolation_nonmatching_meshes(cell_type):
+    """Interpolate quadratic polynomials from a triangle mesh onto a
+    different mesh of a subdomain, which reproduces them exactly"""
+    mesh0 = dolfinx.UnitSquareMesh(MPI.COMM_WORLD, 7, 5)
+    mesh1 = dolfinx.RectangleMesh(MPI.COMM_WORLD, [np.array([0.1, 0.2, 0.0]), np.array([0.9, 0.8, 0.0])],
+                                  [4, 6], cell_type)
+    V0 = FunctionSpace(mesh0, ("Lagrange", 2))
+    V1 = FunctionSpace(mesh1, ("Lagrange", 2))
+
+    def f(x):
+        return 1 + x[0]**2 + x[0] * x[1] - 2 * x[1]
+
+    def g(x):
+        return x[1]**2 - 3 * x[0]
+
+    v, u, u_exact = Function(V0), Function(V1), Function(V1)
+    v.interpolate(f)
+    u.interpolate(v)
+    u_exact.interpolate(f)
+    assert np.allclose(u.vector.array, u_exact.vector.array)
+
+    # Re-use the interpolation data for another source Function
+    data = cpp.fem.NonmatchingInterpolationData(V1._cpp_object, mesh0)
+    v.interpolate(g)
+    u.interpolate(v, data)
+    u_exact.interpolate(g)
+    assert np.allclose(u.vector.array, u_exact.vector.array)
@@ -401,3 +401,50 @@ def test_UnitHexMesh_assemble():
     vol = assemble_scalar(1 * dx(mesh))
     vol = mesh.mpi_comm().allreduce(vol, MPI.SUM)
     assert vol == pytest.approx(1, rel=1e-9)
+
+
+@pytest.mark.parametrize("cell_type", [CellType.tetrahedron, CellType.hexahedron])
+def test_threaded_topology_computation(cell_type):
+    """Check that entities and connectivities computed with several threads
+    are the same as when computed with one thread"""
+    meshes = [UnitCubeMesh(MPI.COMM_WORLD, 4, 3, 5, cell_type) for i in range(2)]
+    for mesh, num_threads in zip(meshes, [1, 4]):
+        for d0, d1 in [(1, 0), (2, 1), (0, 3), (1, 3), (2, 3)]:
+            mesh.topology.create_connectivity(d0, d1, num_threads)
+
+    t0, t1 = meshes[0].topology, meshes[1].topology
+    for d0, d1 in [(3, 1), (1, 0), (3, 2), (2, 0), (2, 1), (0, 3), (1, 3), (2, 3)]:
+        c0, c1 = t0.connectivity(d0, d1), t1.connectivity(d0, d1)
+        assert np.array_equal(c0.array, c1.array)
+        assert np.array_equal(c0.offsets, c1.offsets)
+
+
+def test_release_connectivity():
+    mesh = UnitCubeMesh(MPI.COMM_WORLD, 3, 3, 3)
+    topology = mesh.topology
+    topology.create_connectivity(2, 3)
+    topology.create_connectivity(0, 3)
+    c23 = topology.connectivity(2, 3).array.copy()
+    c03 = topology.connectivity(0, 3).array.copy()
+    assert topology.connectivity_memory(2, 3) > 0
+
+    # Released derived connectivity is recomputed on access
+    topology.release_connectivity(2, 3)
+    assert topology.connectivity_memory(2, 3) == 0
+    assert np.array_equal(topology.connectivity(2, 3).array, c23)
+
+    # Only one of the derived connectivities fits the budget
+    m23, m03 = topology.connectivity_memory(2, 3), topology.connectivity_memory(0, 3)
+    topology.connectivity_memory_budget = max(m23, m03)
+    assert topology.connectivity_memory(2, 3) == 0 or topology.connectivity_memory(0, 3) == 0
+    assert np.array_equal(topology.connectivity(0, 3).array, c03)
+    assert np.array_equal(topology.connectivity(2, 3).array, c23)
+    topology.connectivity_memory_budget = 0
+
+    # Releasing entity connectivity removes the entities
+    topology.release_connectivity(3, 2)
+    assert topology.connectivity(2, 0) is None
+    assert topology.index_map(2) is None
+    topology.create_entities(2)
+    topology.create_connectivity(2, 3)
+    assert np.array_equal(topology.connectivity(2, 3).array, c23)